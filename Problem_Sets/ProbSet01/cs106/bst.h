@@ -148,6 +148,119 @@ template <typename ElemType>
 			void mapAll(void (fn)(ElemType elem, ClientDataType &data),
 							ClientDataType &data);
 
+
+		/*
+		 * Member function: rangeMapAll
+		 * Usage: bst.rangeMapAll(lo, hi, Print);
+		 *        bst.rangeMapAll(lo, hi, PrintToFile, outputStream);
+		 * ----------------------------------------------------------
+		 * These member functions call fn once for each element that lies
+		 * between lo and hi, inclusive, in InOrder sequence. The optional
+		 * client data is passed along as it is for mapAll. Only the part of
+		 * the tree that holds the range is visited, so a call costs
+		 * O(log N + K), where K is the number of elements in the range.
+		 */
+		void rangeMapAll(ElemType lo, ElemType hi, void (fn)(ElemType elem));
+
+		template <typename ClientDataType>
+			void rangeMapAll(ElemType lo, ElemType hi,
+							void (fn)(ElemType elem, ClientDataType &data),
+							ClientDataType &data);
+
+
+		/*
+		 * Member function: kth
+		 * Usage: elem = bst.kth(i);
+		 * -------------------------
+		 * This member function returns the element that would be at index i
+		 * if the elements were listed in order, counting from 0. Each node
+		 * keeps the size of its subtree, so the element is located in O(log N)
+		 * time. Raises an error if i is not between 0 and size() - 1.
+		 */
+		ElemType kth(int i);
+
+
+		/*
+		 * Member function: rank
+		 * Usage: n = bst.rank(key);
+		 * -------------------------
+		 * This member function returns the number of elements in this tree
+		 * that are less than key. The key itself need not be in the tree.
+		 * If it is, its rank is the index at which kth would return it.
+		 */
+		int rank(ElemType key);
+
+
+		/*
+		 * Member functions: successor, predecessor
+		 * Usage: ElemType *next = bst.successor(key);
+		 *        ElemType *prev = bst.predecessor(key);
+		 * ---------------------------------------------
+		 * These member functions return a pointer to the data in the node
+		 * holding the smallest element greater than key, or the largest
+		 * element less than key, respectively. The key itself need not be in
+		 * the tree. If there is no such element, they return NULL.
+		 */
+		ElemType *successor(ElemType key);
+		ElemType *predecessor(ElemType key);
+
+
+		/*
+		 * Member function: buildFromSorted
+		 * Usage: bst.buildFromSorted(elems);
+		 * ----------------------------------
+		 * This member function replaces the contents of this tree with the
+		 * elements of the vector, which must already be in strictly increasing
+		 * order according to the comparison function. The tree is built
+		 * directly in perfectly balanced form, which takes O(N) time rather
+		 * than the O(N log N) needed to add the elements one at a time.
+		 */
+		void buildFromSorted(Vector<ElemType> &elems);
+
+
+		class Iterator;
+
+		/*
+		 * Member function: iterator
+		 * Usage: itr = bst.iterator();
+		 * ----------------------------
+		 * This member function creates an iterator that returns the elements
+		 * of this tree in the order determined by an InOrder walk.
+		 */
+		Iterator iterator();
+
+
+		/*
+		 * Class: BST<ElemType>::Iterator
+		 * ------------------------------
+		 * This interface defines a nested class within the BST template that
+		 * walks the tree in order, one element per call to next(), using the
+		 * same hasNext()/next() idiom as the other collection iterators. The
+		 * iterator reads the tree in place and keeps only the path from the
+		 * root to the next node, so creating one is cheap and stopping early
+		 * costs nothing. The tree must not be modified while an iterator is
+		 * in use.
+		 */
+	private:
+		struct nodeT;
+		static const int MaxDepth = 64;	// AVL height bound for any int count
+	public:
+		class Iterator {
+			public:
+				Iterator();
+				bool hasNext();
+				ElemType next();
+
+			private:
+				Iterator(BST *tp);
+				void pushLeftPath(nodeT *t);
+				BST *tp;
+				nodeT *stack[MaxDepth];
+				int depth;
+				friend class BST;
+		};
+		friend class Iterator;
+
 		/*
 		 * Deep copying support
 		 * --------------------
@@ -170,6 +283,7 @@ template <typename ElemType>
 		    ElemType data;
 		    nodeT *left, *right;
 		    int bf;	// AVL balance factor
+		    int size;	// number of nodes in the subtree rooted here
 		};
 
 		nodeT *root;
@@ -180,20 +294,18 @@ template <typename ElemType>
 		static const int Even = 0;
 		static const int LeftHeavy = -1;
 
-		nodeT *recFindNode(nodeT * t, ElemType & key);
-		bool recAddNode(nodeT * & t, ElemType & key, bool &createdNewNode);
-		bool recRemoveNode(nodeT * &, ElemType & key, bool & didRemove);
-		bool removeTargetNode(nodeT * & t);
+		nodeT *findNode(ElemType & key);
 		void updateBF(nodeT * &t, int bfDelta);
 		void recDeleteTree(nodeT * t);
-		void recMapAll(nodeT * t, void (fn)(ElemType));
-		template <typename ClientDataType>
-		void recMapAll(nodeT * t, void (fn)(ElemType, ClientDataType &), ClientDataType &);
+		static int subtreeSize(nodeT * t);
+		static void updateSize(nodeT * t);
+		int findRangeStart(ElemType & lo, nodeT *stack[]);
 		void fixRightImbalance(nodeT * &t);
 		void fixLeftImbalance(nodeT * &t);
 		void rotateRight(nodeT * &t);
 		void rotateLeft(nodeT * &t);
 		void copyOtherEntries(const BST &other);
+		nodeT *buildBalanced(Vector<ElemType> &elems, int start, int count, int &height);
 };
 
 
@@ -246,19 +358,19 @@ template <typename ElemType>
 
 
 /*
- * Implementation notes: find, recFindNode
- * ----------------------------------------------
- * The rind function simply calls recFindNode to do
- * the work.  The recursive function takes the current
- * node along with the original argument. If found, 
- * it overwrites the reference parameter with the copy
- * and returns a pointer to the data.
+ * Implementation notes: find, findNode
+ * ------------------------------------
+ * The find function simply calls findNode to do the work.  The
+ * search walks down from the root in a loop, following the left
+ * or right link according to the comparison, until it either finds
+ * the key or runs off the bottom of the tree. If found, it returns
+ * a pointer to the data.
  */
 
 template <typename ElemType>
   ElemType *BST<ElemType>::find(ElemType key)
 	{
-	    nodeT * found = recFindNode(root, key);
+	    nodeT * found = findNode(key);
 	    if (found != NULL) {
 	    	return (&found->data);
 	    }
@@ -266,75 +378,68 @@ template <typename ElemType>
 	}
 
 template <typename ElemType>
-  typename BST<ElemType>::nodeT * BST<ElemType>::recFindNode(nodeT * t, 
-                                                       ElemType & key)
+  typename BST<ElemType>::nodeT * BST<ElemType>::findNode(ElemType & key)
 	{
-	    if (t == NULL) return (NULL);
-	    int sign = cmpFn(key, t->data);
-	    if (sign == 0) return (t);
-	    if (sign < 0) {
-	        return (recFindNode(t->left, key));
-	    } else {
-	        return (recFindNode(t->right, key));
+	    nodeT * t = root;
+	    while (t != NULL) {
+	        int sign = cmpFn(key, t->data);
+	        if (sign == 0) return (t);
+	        t = (sign < 0) ? t->left : t->right;
 	    }
+	    return (NULL);
 	}
 
 /*
- * Implementation notes: add, recAddNode
- * -------------------------------------------
- * The add member function is implemented as a simple wrapper
- * to recAddNode, which does all the work.  The difference
- * between the prototypes is that recAddNode takes a reference
- * to the root of the current subtree as an extra argument.
- * For reasons of efficiency (we don't know how large ElemType
- * might be), we pass it by reference.
- * The return value from recAddNode is true or false, depending on
- * whether the height of the subtree was increased by one or not.
- * At base case, returns true for new node, false for overwite. As
- * it works its way upwards, if that additional height is added to
- * to existing balanace factor and results in factor that is
- * more than +- 1, then a rotation is done to fix the imbalance.
+ * Implementation notes: add
+ * -------------------------
+ * The add member function descends from the root in a loop, recording
+ * in path the address of each link it follows and in dirs the side on
+ * which it continued (-1 for left, +1 for right). Because the tree is
+ * kept balanced, MaxDepth entries are always enough. If the key is
+ * already present, the data is overwritten and the tree is unchanged.
+ * Otherwise the new node is attached at the bottom, and the path is
+ * retraced upwards. Each ancestor has its size recomputed, and as long
+ * as the subtree below has grown taller, that extra height is added to
+ * the ancestor's balance factor. If the result is a factor that is
+ * more than +- 1, then a rotation is done to fix the imbalance. The
+ * height of a subtree has increased only if its root ended up heavy
+ * on one side, so the balance factors stop changing after that point.
  */
  
 template <typename ElemType>
   bool BST<ElemType>::add(ElemType data)
 	{
-	    bool createdNewNode = false;
-	    recAddNode(root, data, createdNewNode);
-	    return (createdNewNode);
-	}
-
-
-// returns true if height at t has increased, false otherwise
-template <typename ElemType>
-  bool BST<ElemType>::recAddNode(nodeT * & t, ElemType & data, bool &createdNewNode)
-	{
-	    if (t == NULL) {
-	        t = new nodeT;
-	        t->data = data;
-	        t->bf = Even;
-	        t->left = t->right = NULL;
-	        createdNewNode = true;
-			numNodes++;
-	        return (true);
+	    nodeT **path[MaxDepth];
+	    int dirs[MaxDepth];
+	    int depth = 0;
+	    nodeT **link = &root;
+	    while (*link != NULL) {
+	        nodeT *t = *link;
+	        int sign = cmpFn(data, t->data);
+	        if (sign == 0) {
+	            t->data = data;
+	            return (false);
+	        }
+	        path[depth] = link;
+	        dirs[depth++] = (sign < 0) ? -1 : +1;
+	        link = (sign < 0) ? &t->left : &t->right;
 	    }
-	    int sign = cmpFn(data, t->data);
-	    if (sign == 0) {
-			t->data = data;
-	    	createdNewNode = false;
-	    	return (false);
-		}
-		int bfDelta = 0;
-	    if (sign < 0) {
-	        if (recAddNode(t->left, data, createdNewNode))
-	        	bfDelta = -1;	// inserted node has caused increase in left subtree height
-	    } else {
-	        if (recAddNode(t->right, data, createdNewNode))
-	        	bfDelta = +1;	// inserted node has caused increase in right subtree height
+	    nodeT *t = new nodeT;
+	    t->data = data;
+	    t->bf = Even;
+	    t->size = 1;
+	    t->left = t->right = NULL;
+	    *link = t;
+	    numNodes++;
+	    bool grew = true;	// height of the subtree below path[i] increased
+	    while (--depth >= 0) {
+	        updateSize(*path[depth]);
+	        if (grew) {
+	            updateBF(*path[depth], dirs[depth]);	// rebalances if necessary
+	            grew = ((*path[depth])->bf != Even);
+	        }
 	    }
-	    updateBF(t, bfDelta); // adds height change and rebalances if necessary
-	    // height of t increased iff subtree increased and this node ended heavy
-	    return (bfDelta != 0 && t->bf != Even);
+	    return (true);
 	}
 
 
@@ -393,9 +498,10 @@ template <typename ElemType>
  * Usage: rotateLeft(t);
  * ---------------------
  * This function performs a single left rotation of the tree
- * that is passed by reference.  The balance factors
- * are unchanged by this function and must be corrected at a
- * higher level of the algorithm.
+ * that is passed by reference.  The subtree sizes of the two
+ * nodes that move are recomputed from their new children, lower
+ * node first. The balance factors are unchanged by this function
+ * and must be corrected at a higher level of the algorithm.
  */
 template <typename ElemType>
   void BST<ElemType>::rotateLeft(nodeT * & t)
@@ -403,6 +509,8 @@ template <typename ElemType>
 	    nodeT * child = t->right;
 	    t->right = child->left;
 	    child->left = t;
+	    updateSize(t);
+	    updateSize(child);
 	    t = child;
 	}
 
@@ -446,9 +554,10 @@ template <typename ElemType>
  * Usage: rotateRight(t);
  * ----------------------
  * This function performs a single right rotation of the tree
- * that is passed by reference.  The balance factors
- * are unchanged by this function and must be corrected at a
- * higher level of the algorithm.
+ * that is passed by reference.  The subtree sizes of the two
+ * nodes that move are recomputed from their new children, lower
+ * node first. The balance factors are unchanged by this function
+ * and must be corrected at a higher level of the algorithm.
  */
 template <typename ElemType>
   void BST<ElemType>::rotateRight(nodeT * & t)
@@ -456,142 +565,369 @@ template <typename ElemType>
 	    nodeT * child = t->left;
 	    t->left = child->right;
 	    child->right = t;
+	    updateSize(t);
+	    updateSize(child);
 	    t = child;
 	}
 
 
 
- /*
- * Implementation notes: remove, recRemoveNode
- * -------------------------------------------
- * The first step in removing a node is to find it using binary
- * search, which is performed by these two functions.  If the
- * node is found, RemoveTargetNode does the actual deletion.
+/*
+ * Implementation notes: remove
+ * ----------------------------
+ * The first step in removing a node is to find it using binary search,
+ * recording the path as add does. The easy case occurs when either of
+ * the children is NULL; all you need to do is replace the node with
+ * its non-NULL child. If both children are non-NULL, the search
+ * continues to the rightmost descendent of the left child; this node
+ * may not be a leaf, but will have no right child. Its data is copied
+ * to the target node, and it is unlinked in its place. The path is
+ * then retraced upwards exactly as in add, except that a shorter
+ * subtree shifts the balance of its parent toward the other side, and
+ * the height of a subtree has decreased only if its root ended up
+ * Even.
  */
 template <typename ElemType>
   bool BST<ElemType>::remove(ElemType data)
 	{
-	    bool didRemove = false;
-	    recRemoveNode(root, data, didRemove);
-	    return (didRemove);
+	    nodeT **path[MaxDepth];
+	    int dirs[MaxDepth];
+	    int depth = 0;
+	    nodeT **link = &root;
+	    while (true) {
+	        if (*link == NULL) return (false);
+	        int sign = cmpFn(data, (*link)->data);
+	        if (sign == 0) break;
+	        path[depth] = link;
+	        dirs[depth++] = (sign < 0) ? -1 : +1;
+	        link = (sign < 0) ? &(*link)->left : &(*link)->right;
+	    }
+	    nodeT *target = *link;
+	    if (target->left != NULL && target->right != NULL) {
+	        path[depth] = link;
+	        dirs[depth++] = -1;
+	        link = &target->left;
+	        while ((*link)->right != NULL) {
+	            path[depth] = link;
+	            dirs[depth++] = +1;
+	            link = &(*link)->right;
+	        }
+	        target->data = (*link)->data;	// copy over the data from the node being removed
+	    }
+	    nodeT *toDelete = *link;
+	    *link = (toDelete->left != NULL) ? toDelete->left : toDelete->right;
+	    delete toDelete;
+	    numNodes--;
+	    bool shrank = true;	// height of the subtree below path[i] decreased
+	    while (--depth >= 0) {
+	        updateSize(*path[depth]);
+	        if (shrank) {
+	            updateBF(*path[depth], -dirs[depth]);
+	            shrank = ((*path[depth])->bf == Even);
+	        }
+	    }
+	    return (true);
 	}
 
 
+/*
+ * Implementation notes: mapAll
+ * ----------------------------
+ * The mapAll functions call fn on all values during an InOrder walk.
+ * Rather than recursing, they keep an explicit stack of the nodes whose
+ * values have yet to be visited, in the same way as the Iterator.
+ */
+template <typename ElemType>
+  void BST<ElemType>::mapAll(void (fn)(ElemType))
+	{
+	    nodeT *stack[MaxDepth];
+	    int depth = 0;
+	    for (nodeT *t = root; t != NULL; t = t->left)
+	        stack[depth++] = t;
+	    while (depth > 0) {
+	        nodeT *t = stack[--depth];
+	        fn(t->data);
+	        for (t = t->right; t != NULL; t = t->left)
+	            stack[depth++] = t;
+	    }
+	}
+	
+	
+template <typename ElemType>
+  template <typename ClientDataType>
+	void BST<ElemType>::mapAll(void (fn)(ElemType, ClientDataType &), ClientDataType &data)
+	{
+	    nodeT *stack[MaxDepth];
+	    int depth = 0;
+	    for (nodeT *t = root; t != NULL; t = t->left)
+	        stack[depth++] = t;
+	    while (depth > 0) {
+	        nodeT *t = stack[--depth];
+	        fn(t->data, data);
+	        for (t = t->right; t != NULL; t = t->left)
+	            stack[depth++] = t;
+	    }
+	}
 
 
-// returns change in size of tree rooted at t
-// 0, if same height as before, -1 if height decreases
+/*
+ * Implementation notes: rangeMapAll, findRangeStart
+ * -------------------------------------------------
+ * findRangeStart descends from the root toward lo and pushes each node
+ * that is not less than lo, leaving the smallest such node on top of the
+ * stack. From there the walk proceeds exactly as in mapAll and stops at
+ * the first value greater than hi. Nodes outside the range are only
+ * touched along the two search paths, so the walk costs O(log N + K).
+ */
 template <typename ElemType>
-  bool BST<ElemType>::recRemoveNode(nodeT * & t, ElemType & data, bool & didRemove)
+  void BST<ElemType>::rangeMapAll(ElemType lo, ElemType hi, void (fn)(ElemType))
 	{
-	    if (t == NULL) 
-	    	return (false);
-	    int sign = cmpFn(data, t->data);
-	    if (sign == 0) {
-	    	didRemove = true;
-	        return (removeTargetNode(t));
-	    } 
-	    int bfDelta = 0;
-	    if (sign < 0) {
-	    	if (recRemoveNode(t->left, data, didRemove))
-	    		bfDelta = +1;
-	    } else {
-	    	if (recRemoveNode(t->right, data, didRemove))
-	    		bfDelta = -1;
-		}
-	    updateBF(t, bfDelta);
-	    // height decreased iff subtree decreased and this node ended even
-	    return (bfDelta != 0 && t->bf == Even);
+	    nodeT *stack[MaxDepth];
+	    int depth = findRangeStart(lo, stack);
+	    while (depth > 0) {
+	        nodeT *t = stack[--depth];
+	        if (cmpFn(t->data, hi) > 0) break;
+	        fn(t->data);
+	        for (t = t->right; t != NULL; t = t->left)
+	            stack[depth++] = t;
+	    }
+	}
+
+template <typename ElemType>
+  template <typename ClientDataType>
+	void BST<ElemType>::rangeMapAll(ElemType lo, ElemType hi,
+							void (fn)(ElemType, ClientDataType &), ClientDataType &data)
+	{
+	    nodeT *stack[MaxDepth];
+	    int depth = findRangeStart(lo, stack);
+	    while (depth > 0) {
+	        nodeT *t = stack[--depth];
+	        if (cmpFn(t->data, hi) > 0) break;
+	        fn(t->data, data);
+	        for (t = t->right; t != NULL; t = t->left)
+	            stack[depth++] = t;
+	    }
+	}
+
+template <typename ElemType>
+  int BST<ElemType>::findRangeStart(ElemType & lo, nodeT *stack[])
+	{
+	    int depth = 0;
+	    nodeT *t = root;
+	    while (t != NULL) {
+	        if (cmpFn(lo, t->data) <= 0) {
+	            stack[depth++] = t;
+	            t = t->left;
+	        } else {
+	            t = t->right;
+	        }
+	    }
+	    return (depth);
 	}
 
 
-    
 /*
- * Implementation notes: removeTargetNode
- * --------------------------------------
- * This function removes the node which is passed by
- * reference as t.  The easy case occurs when either of the
- * children is NULL; all you need to do is replace the node with
- * its non-NULL child.  If both children are non-NULL, this code
- * finds the rightmost descendent of the left child; this node
- * may not be a leaf, but will have no right child.  Its left
- * child replaces it in the tree, after which the replacement
- * data is moved to the position occupied by the target node.
+ * Implementation notes: kth, rank
+ * -------------------------------
+ * Each node records the size of its subtree, so the number of elements
+ * less than a node within its subtree is the size of its left child.
+ * kth uses that count to decide which way to descend, subtracting the
+ * elements it skips when it goes right. rank follows the search path
+ * for key and adds up the elements to the left of each node it passes
+ * on the way right. Both take time proportional to the height of the
+ * tree.
  */
 template <typename ElemType>
-  bool BST<ElemType>::removeTargetNode(nodeT *  & t)
-	{
-	    nodeT * toDelete = t;
-
-	    if (t->left == NULL) {	// no left child, replace with right
-	        t = t->right;
-	        delete toDelete;
-			numNodes--;
-	        return (true);
-	    } else if (t->right == NULL) {	// no right child, replace with left
-	        t = t->left;
-	        delete toDelete;
-			numNodes--;
-	        return (true);
-	    } else {	// node has both children, replace with successor (max of left)
-	    	nodeT * successor = t->left;
-	    	while (successor->right != NULL)
-	    		successor = successor->right;
-	    	t->data = successor->data;	// copy over the data from succ node (it will be removed)
-	    	bool unused;
-	    	if (recRemoveNode(t->left, successor->data, unused)) {
-	    		updateBF(t, 1); // decreased one on left
-	    		return (t->bf == Even);
-			} else
-				return (false);
+  ElemType BST<ElemType>::kth(int i)
+	{
+	    if (i < 0 || i >= numNodes) Error("kth: index out of range");
+	    nodeT *t = root;
+	    while (true) {
+	        int leftSize = subtreeSize(t->left);
+	        if (i == leftSize) return (t->data);
+	        if (i < leftSize) {
+	            t = t->left;
+	        } else {
+	            i -= leftSize + 1;
+	            t = t->right;
+	        }
+	    }
+	}
+
+template <typename ElemType>
+  int BST<ElemType>::rank(ElemType key)
+	{
+	    int count = 0;
+	    nodeT *t = root;
+	    while (t != NULL) {
+	        int sign = cmpFn(key, t->data);
+	        if (sign == 0) return (count + subtreeSize(t->left));
+	        if (sign < 0) {
+	            t = t->left;
+	        } else {
+	            count += subtreeSize(t->left) + 1;
+	            t = t->right;
+	        }
 	    }
+	    return (count);
 	}
 
 
 /*
- * Implementation notes: mapAll, recMapAll
- * ----------------------------------------
- * The mapAll function is implemented as a wrapper to the
- * recursive function recMapAll, which does the actual work
- * of calling the function on all values during an InOrder walk.
+ * Implementation notes: successor, predecessor
+ * --------------------------------------------
+ * These functions follow the search path for key and remember the last
+ * node at which the path turned away from the answer's side: the last
+ * left turn for successor, the last right turn for predecessor. That
+ * node holds the nearest element on the requested side of key.
  */
 template <typename ElemType>
-  void BST<ElemType>::mapAll(void (fn)(ElemType))
+  ElemType *BST<ElemType>::successor(ElemType key)
 	{
-	    recMapAll(root, fn);
+	    nodeT *best = NULL;
+	    nodeT *t = root;
+	    while (t != NULL) {
+	        if (cmpFn(key, t->data) < 0) {
+	            best = t;
+	            t = t->left;
+	        } else {
+	            t = t->right;
+	        }
+	    }
+	    return (best == NULL ? NULL : &best->data);
 	}
 
 template <typename ElemType>
-  void BST<ElemType>::recMapAll(nodeT * t, void (fn)(ElemType))
+  ElemType *BST<ElemType>::predecessor(ElemType key)
 	{
-	    if (t != NULL) {
-	        recMapAll(t->left, fn);
-	        fn(t->data);
-	        recMapAll(t->right, fn);
+	    nodeT *best = NULL;
+	    nodeT *t = root;
+	    while (t != NULL) {
+	        if (cmpFn(key, t->data) > 0) {
+	            best = t;
+	            t = t->right;
+	        } else {
+	            t = t->left;
+	        }
 	    }
+	    return (best == NULL ? NULL : &best->data);
 	}
-	
-	
+
+
+/*
+ * Functions: subtreeSize, updateSize
+ * Usage: updateSize(t);
+ * ---------------------
+ * subtreeSize returns the number of nodes in the subtree rooted at t,
+ * which is 0 for an empty tree. updateSize recomputes the size stored
+ * in t from the sizes of its two children.
+ */
 template <typename ElemType>
-  template <typename ClientDataType>
-	void BST<ElemType>::mapAll(void (fn)(ElemType, ClientDataType &), ClientDataType &data)
+  int BST<ElemType>::subtreeSize(nodeT * t)
 	{
-	    recMapAll(root, fn, data);
+	    return (t == NULL ? 0 : t->size);
 	}
 
+template <typename ElemType>
+  void BST<ElemType>::updateSize(nodeT * t)
+	{
+	    t->size = subtreeSize(t->left) + subtreeSize(t->right) + 1;
+	}
 
+/*
+ * Implementation notes: buildFromSorted, buildBalanced
+ * ----------------------------------------------------
+ * The middle element of each range becomes the root of its subtree, and
+ * the elements on either side are built into the left and right subtrees.
+ * The two halves differ in size by at most one, so their heights differ
+ * by at most one as well, and each balance factor can be computed from the
+ * heights returned by the recursive calls. The recursion depth is only
+ * log N.
+ */
 template <typename ElemType>
-  template <typename ClientDataType>
+  void BST<ElemType>::buildFromSorted(Vector<ElemType> &elems)
+	{
+	    clear();
+	    int height;
+	    root = buildBalanced(elems, 0, elems.size(), height);
+	    numNodes = elems.size();
+	}
 
-	void BST<ElemType>::recMapAll(nodeT * t, void (fn)(ElemType, ClientDataType &), ClientDataType &data)
+template <typename ElemType>
+  typename BST<ElemType>::nodeT *BST<ElemType>::buildBalanced(Vector<ElemType> &elems,
+                                                    int start, int count, int &height)
 	{
-	    if (t != NULL) {
-	        recMapAll(t->left, fn ,data);
-	        fn(t->data, data);
-	        recMapAll(t->right, fn, data);
+	    if (count == 0) {
+	    	height = 0;
+	    	return (NULL);
 	    }
+	    int leftCount = count / 2, leftHeight, rightHeight;
+	    nodeT *t = new nodeT;
+	    t->left = buildBalanced(elems, start, leftCount, leftHeight);
+	    t->data = elems[start + leftCount];
+	    t->right = buildBalanced(elems, start + leftCount + 1, count - leftCount - 1, rightHeight);
+	    t->bf = rightHeight - leftHeight;
+	    t->size = count;
+	    height = 1 + (leftHeight > rightHeight ? leftHeight : rightHeight);
+	    return (t);
+	}
+
+
+/* 
+ * BST::Iterator class implementation
+ * ----------------------------------
+ * The Iterator keeps an explicit stack holding the path of nodes whose
+ * elements have yet to be returned, with the next node on top. Each call
+ * to next() pops that node and then pushes the leftmost path of its right
+ * subtree. Every node is pushed and popped once, so a full walk costs O(N)
+ * and a single call costs O(1) on average.
+ */
+template <typename ElemType>
+  BST<ElemType>::Iterator::Iterator()
+	{
+		tp = NULL;
+		depth = 0;
+	}
+
+template <typename ElemType>
+  typename BST<ElemType>::Iterator BST<ElemType>::iterator()
+	{
+		return Iterator(this);
+	}
+
+template <typename ElemType>
+  BST<ElemType>::Iterator::Iterator(BST *treeptr)
+	{
+		tp = treeptr;
+		depth = 0;
+		pushLeftPath(tp->root);
+	}
+
+template <typename ElemType>
+  void BST<ElemType>::Iterator::pushLeftPath(nodeT *t)
+	{
+		for (; t != NULL; t = t->left)
+			stack[depth++] = t;
 	}
 
+template <typename ElemType>
+  bool BST<ElemType>::Iterator::hasNext()
+	{
+		if (tp == NULL) Error("hasNext called on uninitialized iterator");
+		return depth > 0;
+	}
+
+template <typename ElemType>
+  ElemType BST<ElemType>::Iterator::next()
+	{
+		if (tp == NULL) Error("next called on uninitialized iterator");
+		if (!hasNext()) Error("Attempt to get next from iterator where hasNext() is false");
+		nodeT *t = stack[--depth];
+		pushLeftPath(t->right);
+		return t->data;
+	}
+
+
 template <typename ElemType> 
   const BST<ElemType> &BST<ElemType>::operator=(const BST &rhs) 
 	{
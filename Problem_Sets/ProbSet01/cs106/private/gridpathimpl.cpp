@@ -0,0 +1,605 @@
+/*
+ * File: gridpathimpl.cpp
+ * ----------------------
+ * This file contains the implementation of the gridpath.h interface.
+ * Because of the way C++ compiles templates, this code must be
+ * available to the compiler when it reads the header file.  The
+ * methods that are not templates are declared inline so that the
+ * file can be included by more than one source file.
+ */
+
+#ifdef _gridpath_h
+
+#include <cstdlib>
+#include <string>
+
+/* Constants */
+
+const double PATH_SQRT2 = 1.4142135623730951;
+
+/*
+ * The first four directions are the horizontal and vertical moves, and
+ * the last four are the diagonals.
+ */
+
+const int PATH_DROW[] = { -1, 0, 1, 0, -1, -1, 1, 1 };
+const int PATH_DCOL[] = { 0, 1, 0, -1, -1, 1, 1, -1 };
+
+inline GridPathfinder::GridPathfinder() {
+   costs = NULL;
+   nRows = 0;
+   nCols = 0;
+   moves = FOUR_CONNECTED;
+   minCost = 0;
+   uniform = true;
+   initWorkspace(workspace);
+}
+
+template <typename GridType>
+GridPathfinder::GridPathfinder(GridType & grid, PathMoves moves) {
+   costs = NULL;
+   this->moves = moves;
+   initWorkspace(workspace);
+   setCosts(grid);
+}
+
+inline GridPathfinder::~GridPathfinder() {
+   delete[] costs;
+   freeWorkspace(workspace);
+}
+
+template <typename GridType>
+void GridPathfinder::setCosts(GridType & grid) {
+   int nRows = grid.numRows();
+   int nCols = grid.numCols();
+   if (nCols > 0 && nRows > 0x7FFFFFFF / nCols) {
+      error("setCosts: Grid is too large");
+   }
+   delete[] costs;
+   costs = new double[nRows * nCols];
+   for (int row = 0; row < nRows; row++) {
+      copyRow(costs + row * nCols, grid.rowPtr(row), nCols);
+   }
+   this->nRows = nRows;
+   this->nCols = nCols;
+   computeCostStatistics();
+}
+
+inline void GridPathfinder::setMoves(PathMoves moves) {
+   this->moves = moves;
+}
+
+inline PathMoves GridPathfinder::getMoves() const {
+   return moves;
+}
+
+inline int GridPathfinder::numRows() const {
+   return nRows;
+}
+
+inline int GridPathfinder::numCols() const {
+   return nCols;
+}
+
+inline bool GridPathfinder::isOpen(int row, int col) const {
+   return isOpenCell(row, col);
+}
+
+inline double GridPathfinder::findPath(PathAlgorithm algorithm,
+                                       int startRow, int startCol,
+                                       int goalRow, int goalCol,
+                                       Vector<Point> & path) {
+   checkQuery(algorithm, startRow, startCol, goalRow, goalCol, "findPath");
+   return runSearch(workspace, algorithm, startRow * nCols + startCol,
+                    goalRow * nCols + goalCol, path);
+}
+
+inline void GridPathfinder::findPaths(PathAlgorithm algorithm,
+                                      const PathQuery *queries,
+                                      PathResult *results, int n) {
+   findPaths(algorithm, queries, results, n, getDefaultThreadPool());
+}
+
+/*
+ * Implementation notes: findPaths
+ * -------------------------------
+ * The queries are checked before any threads start, because an error
+ * signaled on a worker thread could not be caught by the client.
+ * Thread i handles queries i, i + n, i + 2n, and so on, which spreads
+ * long and short searches evenly when they are mixed in the batch.
+ */
+
+inline void GridPathfinder::findPaths(PathAlgorithm algorithm,
+                                      const PathQuery *queries,
+                                      PathResult *results, int n,
+                                      ThreadPool & pool) {
+   for (int i = 0; i < n; i++) {
+      checkQuery(algorithm, queries[i].startRow, queries[i].startCol,
+                 queries[i].goalRow, queries[i].goalCol, "findPaths");
+   }
+   BatchTask task;
+   task.finder = this;
+   task.algorithm = algorithm;
+   task.queries = queries;
+   task.results = results;
+   task.n = n;
+   task.nThreads = (n > 1) ? pool.getThreadCount() : 1;
+   if (task.nThreads == 1) {
+      runBatch(task, 0);
+   } else {
+      pool.runParallel(runBatch, task, task.nThreads);
+   }
+}
+
+inline void GridPathfinder::runBatch(BatchTask & task, int index) {
+   Workspace ws;
+   initWorkspace(ws);
+   int nCols = task.finder->nCols;
+   for (int i = index; i < task.n; i += task.nThreads) {
+      const PathQuery & query = task.queries[i];
+      PathResult & result = task.results[i];
+      result.cost = task.finder->runSearch(ws, task.algorithm,
+                                  query.startRow * nCols + query.startCol,
+                                  query.goalRow * nCols + query.goalCol,
+                                  result.path);
+   }
+   freeWorkspace(ws);
+}
+
+template <typename ValueType>
+void GridPathfinder::copyRow(double *dst, const ValueType *src, int n) {
+   for (int i = 0; i < n; i++) {
+      dst[i] = double(src[i]);
+   }
+}
+
+inline void GridPathfinder::computeCostStatistics() {
+   int n = nRows * nCols;
+   minCost = 0;
+   uniform = true;
+   bool found = false;
+   for (int i = 0; i < n; i++) {
+      double cost = costs[i];
+      if (cost >= 0) {
+         if (!found) {
+            minCost = cost;
+            found = true;
+         } else if (cost != minCost) {
+            uniform = false;
+            if (cost < minCost) minCost = cost;
+         }
+      }
+   }
+}
+
+inline void GridPathfinder::checkQuery(PathAlgorithm algorithm,
+                                       int startRow, int startCol,
+                                       int goalRow, int goalCol,
+                                       std::string caller) const {
+   if (startRow < 0 || startRow >= nRows || startCol < 0
+       || startCol >= nCols || goalRow < 0 || goalRow >= nRows
+       || goalCol < 0 || goalCol >= nCols) {
+      error(caller + ": Cell is outside the map");
+   }
+   if (algorithm == PATH_JPS && !uniform) {
+      error(caller + ": Jump point search requires uniform costs");
+   }
+}
+
+/*
+ * Implementation notes: runSearch
+ * -------------------------------
+ * Each search method returns the cost of the path and leaves the parent
+ * links in the workspace, from which tracePath builds the path.  A
+ * search that begins or ends in a wall fails immediately.
+ */
+
+inline double GridPathfinder::runSearch(Workspace & ws,
+                                        PathAlgorithm algorithm,
+                                        int start, int goal,
+                                        Vector<Point> & path) const {
+   path.clear();
+   if (costs[start] < 0 || costs[goal] < 0) return -1;
+   prepareWorkspace(ws, nRows * nCols);
+   double cost;
+   switch (algorithm) {
+    case PATH_BFS: cost = searchBFS(ws, start, goal); break;
+    case PATH_DIJKSTRA: cost = searchBestFirst(ws, start, goal, false); break;
+    case PATH_ASTAR: cost = searchBestFirst(ws, start, goal, true); break;
+    case PATH_JPS:
+      if (moves == EIGHT_CONNECTED) {
+         cost = searchJPS(ws, start, goal);
+      } else {
+         cost = searchBestFirst(ws, start, goal, true);
+      }
+      break;
+    default: cost = -1; break;
+   }
+   if (cost >= 0) tracePath(ws, goal, path);
+   return cost;
+}
+
+inline double GridPathfinder::searchBFS(Workspace & ws, int start,
+                                        int goal) const {
+   int nDirs = (moves == EIGHT_CONNECTED) ? 8 : 4;
+   int head = 0;
+   int tail = 0;
+   ws.dist[start] = 0;
+   ws.parent[start] = -1;
+   ws.seen[start >> 6] |= uint64_t(1) << (start & 63);
+   ws.queue[tail++] = start;
+   while (head < tail) {
+      int cell = ws.queue[head++];
+      if (cell == goal) return ws.dist[cell];
+      int row = cell / nCols;
+      int col = cell - row * nCols;
+      for (int d = 0; d < nDirs; d++) {
+         int nr = row + PATH_DROW[d];
+         int nc = col + PATH_DCOL[d];
+         if (!isOpenCell(nr, nc)) continue;
+         if (d >= 4 && !(isOpenCell(row, nc) && isOpenCell(nr, col))) continue;
+         int next = nr * nCols + nc;
+         uint64_t bit = uint64_t(1) << (next & 63);
+         if (ws.seen[next >> 6] & bit) continue;
+         ws.seen[next >> 6] |= bit;
+         ws.dist[next] = ws.dist[cell] + 1;
+         ws.parent[next] = cell;
+         ws.queue[tail++] = next;
+      }
+   }
+   return -1;
+}
+
+/*
+ * Implementation notes: searchBestFirst
+ * -------------------------------------
+ * This method implements both Dijkstra's algorithm and A*, which
+ * differ only in whether the heap is ordered by the distance alone or
+ * by the distance plus the heuristic estimate.  Rather than finding
+ * and updating a cell already in the heap, the method pushes a new
+ * entry whenever it finds a shorter distance and ignores entries for
+ * cells that are already closed when they reach the top.  Because the
+ * heuristic never overestimates the cost of a single step, the first
+ * time a cell is removed from the heap its distance is final.
+ */
+
+inline double GridPathfinder::searchBestFirst(Workspace & ws, int start,
+                                              int goal,
+                                              bool useHeuristic) const {
+   int nDirs = (moves == EIGHT_CONNECTED) ? 8 : 4;
+   ws.dist[start] = 0;
+   ws.parent[start] = -1;
+   ws.seen[start >> 6] |= uint64_t(1) << (start & 63);
+   heapPush(ws, useHeuristic ? heuristic(start, goal) : 0, start);
+   while (ws.heapSize > 0) {
+      int cell = heapPop(ws).cell;
+      uint64_t cellBit = uint64_t(1) << (cell & 63);
+      if (ws.closed[cell >> 6] & cellBit) continue;
+      ws.closed[cell >> 6] |= cellBit;
+      if (cell == goal) return ws.dist[cell];
+      int row = cell / nCols;
+      int col = cell - row * nCols;
+      for (int d = 0; d < nDirs; d++) {
+         int nr = row + PATH_DROW[d];
+         int nc = col + PATH_DCOL[d];
+         if (!isOpenCell(nr, nc)) continue;
+         if (d >= 4 && !(isOpenCell(row, nc) && isOpenCell(nr, col))) continue;
+         int next = nr * nCols + nc;
+         uint64_t bit = uint64_t(1) << (next & 63);
+         if (ws.closed[next >> 6] & bit) continue;
+         double step = (d >= 4) ? costs[next] * PATH_SQRT2 : costs[next];
+         double dist = ws.dist[cell] + step;
+         if (!(ws.seen[next >> 6] & bit) || dist < ws.dist[next]) {
+            ws.seen[next >> 6] |= bit;
+            ws.dist[next] = dist;
+            ws.parent[next] = cell;
+            heapPush(ws, useHeuristic ? dist + heuristic(next, goal) : dist,
+                     next);
+         }
+      }
+   }
+   return -1;
+}
+
+/*
+ * Implementation notes: searchJPS
+ * -------------------------------
+ * Jump point search is A* in which each expansion skips along straight
+ * and diagonal lines until it reaches a cell at which the shortest path
+ * might turn, which is called a jump point.  Only jump points enter the
+ * heap, and the parent of each is the jump point from which it was
+ * reached.  Because a diagonal step may not cut a corner, the rules for
+ * pruning the neighbors of a cell and for stopping a jump are:
+ *
+ *  - A cell reached diagonally continues diagonally and also along
+ *    each of the two straight directions that make up the diagonal.
+ *
+ *  - A cell reached along a straight line continues straight and may
+ *    also turn to either side, or diagonally forward to either side,
+ *    if the cell on that side is open.
+ *
+ *  - A straight jump stops at a cell that has an open cell on one
+ *    side when the cell behind that one is a wall, because a shorter
+ *    path to the open cell may turn there.  A diagonal jump stops at
+ *    any cell from which a straight jump finds a jump point.
+ *
+ * The distance between two jump points is the octile distance between
+ * them, scaled by the common cost of the open cells.
+ */
+
+inline double GridPathfinder::searchJPS(Workspace & ws, int start,
+                                        int goal) const {
+   ws.dist[start] = 0;
+   ws.parent[start] = -1;
+   ws.seen[start >> 6] |= uint64_t(1) << (start & 63);
+   heapPush(ws, heuristic(start, goal), start);
+   int dRows[8];
+   int dCols[8];
+   while (ws.heapSize > 0) {
+      int cell = heapPop(ws).cell;
+      uint64_t cellBit = uint64_t(1) << (cell & 63);
+      if (ws.closed[cell >> 6] & cellBit) continue;
+      ws.closed[cell >> 6] |= cellBit;
+      if (cell == goal) return ws.dist[cell];
+      int row = cell / nCols;
+      int col = cell - row * nCols;
+      int nDirs = 0;
+      int parent = ws.parent[cell];
+      if (parent < 0) {
+         for (int d = 0; d < 8; d++) {
+            dRows[nDirs] = PATH_DROW[d];
+            dCols[nDirs++] = PATH_DCOL[d];
+         }
+      } else {
+         int pr = parent / nCols;
+         int dr = (row > pr) - (row < pr);
+         int dc = (col > parent - pr * nCols) - (col < parent - pr * nCols);
+         if (dr != 0 && dc != 0) {
+            dRows[nDirs] = dr;
+            dCols[nDirs++] = dc;
+            dRows[nDirs] = dr;
+            dCols[nDirs++] = 0;
+            dRows[nDirs] = 0;
+            dCols[nDirs++] = dc;
+         } else if (dr == 0) {
+            for (int side = -1; side <= 1; side += 2) {
+               if (isOpenCell(row + side, col)) {
+                  dRows[nDirs] = side;
+                  dCols[nDirs++] = 0;
+                  dRows[nDirs] = side;
+                  dCols[nDirs++] = dc;
+               }
+            }
+            dRows[nDirs] = 0;
+            dCols[nDirs++] = dc;
+         } else {
+            for (int side = -1; side <= 1; side += 2) {
+               if (isOpenCell(row, col + side)) {
+                  dRows[nDirs] = 0;
+                  dCols[nDirs++] = side;
+                  dRows[nDirs] = dr;
+                  dCols[nDirs++] = side;
+               }
+            }
+            dRows[nDirs] = dr;
+            dCols[nDirs++] = 0;
+         }
+      }
+      for (int i = 0; i < nDirs; i++) {
+         int dr = dRows[i];
+         int dc = dCols[i];
+         if (dr != 0 && dc != 0
+             && !(isOpenCell(row, col + dc) && isOpenCell(row + dr, col))) {
+            continue;
+         }
+         int next = jump(row + dr, col + dc, dr, dc, goal);
+         if (next < 0) continue;
+         uint64_t bit = uint64_t(1) << (next & 63);
+         if (ws.closed[next >> 6] & bit) continue;
+         double dist = ws.dist[cell] + stepLength(cell, next) * minCost;
+         if (!(ws.seen[next >> 6] & bit) || dist < ws.dist[next]) {
+            ws.seen[next >> 6] |= bit;
+            ws.dist[next] = dist;
+            ws.parent[next] = cell;
+            heapPush(ws, dist + heuristic(next, goal), next);
+         }
+      }
+   }
+   return -1;
+}
+
+/*
+ * Implementation notes: jump
+ * --------------------------
+ * This method moves from (row, col) in the direction (dRow, dCol) and
+ * returns the index of the first jump point, or -1 if the line runs
+ * into a wall or the edge of the map first.  A diagonal jump calls
+ * this method recursively for its straight components, but those
+ * calls never recurse further, so the depth is at most two.
+ */
+
+inline int GridPathfinder::jump(int row, int col, int dRow, int dCol,
+                                int goal) const {
+   while (isOpenCell(row, col)) {
+      int cell = row * nCols + col;
+      if (cell == goal) return cell;
+      if (dRow != 0 && dCol != 0) {
+         if (jump(row, col + dCol, 0, dCol, goal) >= 0
+             || jump(row + dRow, col, dRow, 0, goal) >= 0) {
+            return cell;
+         }
+      } else if (dRow == 0) {
+         if ((isOpenCell(row - 1, col) && !isOpenCell(row - 1, col - dCol))
+             || (isOpenCell(row + 1, col)
+                 && !isOpenCell(row + 1, col - dCol))) {
+            return cell;
+         }
+      } else {
+         if ((isOpenCell(row, col - 1) && !isOpenCell(row - dRow, col - 1))
+             || (isOpenCell(row, col + 1)
+                 && !isOpenCell(row - dRow, col + 1))) {
+            return cell;
+         }
+      }
+      if (!isOpenCell(row, col + dCol) || !isOpenCell(row + dRow, col)) {
+         return -1;
+      }
+      row += dRow;
+      col += dCol;
+   }
+   return -1;
+}
+
+/*
+ * Implementation notes: heuristic, stepLength
+ * -------------------------------------------
+ * The heuristic is the smallest cost of any open cell multiplied by
+ * the length of the shortest move sequence on an empty map, which is
+ * the Manhattan distance for four-connected moves and the octile
+ * distance for eight-connected moves.
+ */
+
+inline double GridPathfinder::heuristic(int cell, int goal) const {
+   return stepLength(cell, goal) * minCost;
+}
+
+inline double GridPathfinder::stepLength(int from, int to) const {
+   int fromRow = from / nCols;
+   int toRow = to / nCols;
+   int dRow = std::abs(toRow - fromRow);
+   int dCol = std::abs((to - toRow * nCols) - (from - fromRow * nCols));
+   if (moves == FOUR_CONNECTED) return dRow + dCol;
+   if (dRow < dCol) return (dCol - dRow) + dRow * PATH_SQRT2;
+   return (dRow - dCol) + dCol * PATH_SQRT2;
+}
+
+inline bool GridPathfinder::isOpenCell(int row, int col) const {
+   return row >= 0 && row < nRows && col >= 0 && col < nCols
+       && costs[row * nCols + col] >= 0;
+}
+
+/*
+ * Implementation notes: tracePath
+ * -------------------------------
+ * The parent links run backward from the goal, and in jump point search
+ * they may connect cells that are several steps apart along a straight
+ * or diagonal line.  This method fills in the intermediate cells and
+ * then reverses the path so that it runs from the start.
+ */
+
+inline void GridPathfinder::tracePath(const Workspace & ws, int goal,
+                                      Vector<Point> & path) const {
+   int cell = goal;
+   int row = cell / nCols;
+   int col = cell - row * nCols;
+   path.add(Point(col, row));
+   while (ws.parent[cell] >= 0) {
+      int parent = ws.parent[cell];
+      int pr = parent / nCols;
+      int pc = parent - pr * nCols;
+      int dr = (pr > row) - (pr < row);
+      int dc = (pc > col) - (pc < col);
+      while (row != pr || col != pc) {
+         row += dr;
+         col += dc;
+         path.add(Point(col, row));
+      }
+      cell = parent;
+   }
+   for (int i = 0, j = path.size() - 1; i < j; i++, j--) {
+      Point tmp = path[i];
+      path[i] = path[j];
+      path[j] = tmp;
+   }
+}
+
+/*
+ * Implementation notes: Workspace management
+ * ------------------------------------------
+ * prepareWorkspace reallocates the arrays only when the map has grown,
+ * and otherwise clears just the two bitmaps, which take one word for
+ * every 64 cells.
+ */
+
+inline void GridPathfinder::initWorkspace(Workspace & ws) {
+   ws.capacity = 0;
+   ws.dist = NULL;
+   ws.parent = NULL;
+   ws.seen = NULL;
+   ws.closed = NULL;
+   ws.queue = NULL;
+   ws.heap = NULL;
+   ws.heapSize = 0;
+   ws.heapCapacity = 0;
+}
+
+inline void GridPathfinder::freeWorkspace(Workspace & ws) {
+   delete[] ws.dist;
+   delete[] ws.parent;
+   delete[] ws.seen;
+   delete[] ws.closed;
+   delete[] ws.queue;
+   delete[] ws.heap;
+   initWorkspace(ws);
+}
+
+inline void GridPathfinder::prepareWorkspace(Workspace & ws, int nCells) {
+   int nWords = (nCells + 63) / 64;
+   if (nCells > ws.capacity) {
+      freeWorkspace(ws);
+      ws.capacity = nCells;
+      ws.dist = new double[nCells];
+      ws.parent = new int[nCells];
+      ws.seen = new uint64_t[nWords];
+      ws.closed = new uint64_t[nWords];
+      ws.queue = new int[nCells];
+   }
+   for (int i = 0; i < nWords; i++) {
+      ws.seen[i] = 0;
+      ws.closed[i] = 0;
+   }
+   ws.heapSize = 0;
+}
+
+inline void GridPathfinder::heapPush(Workspace & ws, double key, int cell) {
+   if (ws.heapSize == ws.heapCapacity) {
+      int capacity = (ws.heapCapacity == 0) ? 256 : 2 * ws.heapCapacity;
+      HeapEntry *heap = new HeapEntry[capacity];
+      for (int i = 0; i < ws.heapSize; i++) {
+         heap[i] = ws.heap[i];
+      }
+      delete[] ws.heap;
+      ws.heap = heap;
+      ws.heapCapacity = capacity;
+   }
+   int index = ws.heapSize++;
+   while (index > 0) {
+      int parent = (index - 1) / 2;
+      if (ws.heap[parent].key <= key) break;
+      ws.heap[index] = ws.heap[parent];
+      index = parent;
+   }
+   ws.heap[index].key = key;
+   ws.heap[index].cell = cell;
+}
+
+inline GridPathfinder::HeapEntry GridPathfinder::heapPop(Workspace & ws) {
+   HeapEntry top = ws.heap[0];
+   HeapEntry last = ws.heap[--ws.heapSize];
+   int n = ws.heapSize;
+   int index = 0;
+   while (true) {
+      int child = 2 * index + 1;
+      if (child >= n) break;
+      if (child + 1 < n && ws.heap[child + 1].key < ws.heap[child].key) {
+         child++;
+      }
+      if (last.key <= ws.heap[child].key) break;
+      ws.heap[index] = ws.heap[child];
+      index = child;
+   }
+   if (n > 0) ws.heap[index] = last;
+   return top;
+}
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ * File: threadpoolpriv.h
+ * ----------------------
+ * This file contains the private section of the threadpool.h interface.
+ */
+
+/*
+ * Implementation notes: ThreadPool data structure
+ * -----------------------------------------------
+ * The workers wait on lock until the generation counter changes, which
+ * signals that taskFn, taskData, and taskCount describe a new
+ * operation.  Each worker then makes the calls that belong to its own
+ * index, decrements pending, and signals lock when pending reaches zero
+ * so that the caller can return.  The submitLock ensures that only one
+ * operation is in progress at a time.  Because the synchronized
+ * statement releases its lock only when control leaves the statement
+ * normally, the code never uses break or return inside it, and every
+ * exception thrown by a task is caught before it can leave one.
+ */
+
+private:
+
+/* Type used to pass each worker its identity */
+
+   struct WorkerState {
+      ThreadPool *pool;
+      int index;
+      long generation;
+   };
+
+/* Type used by runParallel to pass a typed call through taskFn */
+
+   template <typename ClientType>
+   struct TypedTask {
+      void (*fn)(ClientType & data, int index);
+      ClientType *data;
+   };
+
+/* Instance variables */
+
+   Thread *threads;                  /* The worker threads               */
+   WorkerState *workers;             /* The state passed to each worker  */
+   mutable Lock lock;                /* Protects the fields below        */
+   Lock submitLock;                  /* Held by the caller of runTasks   */
+   int nThreads;                     /* Threads in the pool, with caller */
+   long generation;                  /* Incremented for each operation   */
+   int pending;                      /* Workers yet to finish            */
+   bool shuttingDown;                /* True when the workers must exit  */
+   void (*taskFn)(void *data, int index);   /* The current operation     */
+   void *taskData;                   /* Argument to taskFn               */
+   int taskCount;                    /* Number of calls to taskFn        */
+   bool failed;                      /* True once a task has thrown      */
+   std::string failure;              /* Message of the first exception   */
+
+/* Private method prototypes */
+
+   void startWorkers(int nThreads);
+   void stopWorkers();
+   void runTasks(void (*fn)(void *data, int index), void *data,
+                 int nTasks);
+   void runShare(void (*fn)(void *data, int index), void *data,
+                 int first, int nTasks, int stride);
+   void recordFailure(std::string msg);
+   static void workerMain(WorkerState & state);
+   static ThreadPool *& activePool();
+
+   template <typename ClientType>
+   static void runTypedTask(void *data, int index);
+
+/*
+ * Hidden features
+ * ---------------
+ * A pool owns running threads, so it cannot be copied.  The copy
+ * constructor and assignment operator are declared private and are
+ * never defined.
+ */
+
+   ThreadPool(const ThreadPool & src);
+   ThreadPool & operator=(const ThreadPool & src);
@@ -155,6 +155,9 @@ template <typename ElemType>
 		 * set.unionWith(set2);  Adds all elements from set2 to this set.
 		 * set.intersect(set2);  Removes any element not in set2 from this set.
 		 * set.subtract(set2);   Removes all element in set2 from this set.
+		 *
+		 * Unless set2 is much smaller than this set, each of these runs in
+		 * time proportional to the combined size of the two sets.
 	 	*/    
 	 	void unionWith(Set & otherSet);
 	    void intersect(Set & otherSet);
@@ -215,6 +218,8 @@ template <typename ElemType>
 		 * This member function creates an iterator that allows the client
 		 * to iterate through the elements in this set. The elements are
 		 * accessed in order as determined by the elem comparison function.
+		 * The iterator walks the set in place, so creating one is cheap,
+		 * but the set must not be modified while it is in use.
 		 */
 		Iterator iterator();
 
@@ -243,8 +248,7 @@ template <typename ElemType>
 			private:
 				Iterator(Set *setptr);
 				Set *sp;
-				Vector<ElemType> elems;
-				int curIndex;
+				typename BST<ElemType>::Iterator itr;
 				friend class Set;
 		};
 		friend class Iterator;
@@ -271,6 +275,9 @@ template <typename ElemType>
 	private:
 		BST<ElemType> bst;
 		int (*cmpFn)(ElemType, ElemType);
+
+		void mergeWith(Set &otherSet, bool keepMine, bool keepTheirs, bool keepCommon);
+		static bool fewLookups(int nLookups, int setSize);
 			
 };
 	
@@ -335,31 +342,50 @@ template <typename ElemType>
 /*
  * Implementation notes: Set operations
  * ------------------------------------
- * The code for equals, isSubsetOf, unionWith, intersect, and subtract
- * is similar in structure.  Each one uses an iterator to walk over
- * one (or both) sets, doing add/remove/comparision.
+ * Because both sets produce their elements in sorted order, equals and
+ * isSubsetOf can walk the two sets side by side, and unionWith, intersect,
+ * and subtract can merge them into a sorted vector in a single pass. The
+ * merged vector is then turned back into a balanced tree in linear time.
+ * When otherSet is small enough that looking up or changing its elements
+ * one at a time is cheaper than a pass over this set, unionWith, subtract,
+ * and isSubsetOf fall back on add, remove, and contains.
  */
 
 template <typename ElemType>
   bool Set<ElemType>::equals(Set & otherSet)
 	{
 		if (cmpFn != otherSet.cmpFn) Error("otherSet passed to equals doesn't have same comparison function");
+		if (size() != otherSet.size()) return false;
 	    Iterator thisItr = iterator(), otherItr = otherSet.iterator();
-	    while (thisItr.hasNext() && otherItr.hasNext()) {
+	    while (thisItr.hasNext()) {
     		if (cmpFn(thisItr.next(), otherItr.next()) != 0) 
 	    		return false;
 	    }
-	    return (!thisItr.hasNext() && !otherItr.hasNext());
+	    return true;
 	}
 
 template <typename ElemType>
   bool Set<ElemType>::isSubsetOf(Set & otherSet)
 	{
 		if (cmpFn != otherSet.cmpFn) Error("otherSet passed to isSubsetOf doesn't have same comparison function");
+		if (size() > otherSet.size()) return false;
 		Iterator itr = iterator();
+		if (fewLookups(size(), otherSet.size())) {
+		    while (itr.hasNext()) {
+		    	if (!otherSet.contains(itr.next())) 
+			    	return false;
+	    	}
+		    return true;
+		}
+		Iterator otherItr = otherSet.iterator();
 	    while (itr.hasNext()) {
-	    	if (!otherSet.contains(itr.next())) 
-		    	return false;
+	    	ElemType elem = itr.next();
+	    	int sign;
+	    	do {
+	    		if (!otherItr.hasNext()) return false;
+	    		sign = cmpFn(otherItr.next(), elem);
+	    	} while (sign < 0);
+	    	if (sign > 0) return false;
     	}
 	    return true;
 	}
@@ -368,30 +394,101 @@ template <typename ElemType>
   void Set<ElemType>::unionWith(Set & otherSet)
 	{
 		if (cmpFn != otherSet.cmpFn) Error("otherSet passed to unionWith doesn't have same comparison function");
-		Iterator itr = otherSet.iterator();
-		while (itr.hasNext())
-			add(itr.next());
+		if (fewLookups(otherSet.size(), size())) {
+			Iterator itr = otherSet.iterator();
+			while (itr.hasNext())
+				add(itr.next());
+		} else {
+			mergeWith(otherSet, true, true, true);
+		}
 	}
 
 template <typename ElemType>
   void Set<ElemType>::intersect(Set & otherSet)
 	{
 		if (cmpFn != otherSet.cmpFn) Error("otherSet passed to intersect doesn't have same comparison function");
-		Iterator itr = iterator();
-		while (itr.hasNext()) {
-			ElemType elem = itr.next();
-			if (!otherSet.contains(elem))
-				remove(elem);
-		}
+		mergeWith(otherSet, false, false, true);
 	}
 
 template <typename ElemType>
   void Set<ElemType>::subtract(Set & otherSet)
 	{
 		if (cmpFn != otherSet.cmpFn) Error("otherSet passed to subtract doesn't have same comparison function");
-		Iterator itr = otherSet.iterator();
-		while (itr.hasNext())
-			remove(itr.next());
+		if (fewLookups(otherSet.size(), size())) {
+			Iterator itr = otherSet.iterator();
+			while (itr.hasNext())
+				remove(itr.next());
+		} else {
+			mergeWith(otherSet, true, false, false);
+		}
+	}
+
+/*
+ * Private member function: mergeWith
+ * Usage: mergeWith(otherSet, keepMine, keepTheirs, keepCommon);
+ * -------------------------------------------------------------
+ * This function merges the elements of this set and otherSet in sorted
+ * order and replaces the contents of this set with the result. The three
+ * flags say whether to keep the elements found only in this set, only in
+ * otherSet, or in both. When an element is in both sets, the copy from
+ * otherSet is kept if keepTheirs is set, which matches the way add
+ * overwrites an existing element, and the copy from this set otherwise.
+ */
+template <typename ElemType>
+  void Set<ElemType>::mergeWith(Set &otherSet, bool keepMine, bool keepTheirs, bool keepCommon)
+	{
+		Vector<ElemType> result;
+		Iterator mine = iterator(), theirs = otherSet.iterator();
+		bool haveMine = mine.hasNext(), haveTheirs = theirs.hasNext();
+		ElemType a = ElemType(), b = ElemType();
+		if (haveMine) a = mine.next();
+		if (haveTheirs) b = theirs.next();
+		while (haveMine && haveTheirs) {
+			int sign = cmpFn(a, b);
+			if (sign < 0) {
+				if (keepMine) result.add(a);
+			} else if (sign > 0) {
+				if (keepTheirs) result.add(b);
+			} else if (keepCommon) {
+				result.add(keepTheirs ? b : a);
+			}
+			if (sign <= 0) {
+				haveMine = mine.hasNext();
+				if (haveMine) a = mine.next();
+			}
+			if (sign >= 0) {
+				haveTheirs = theirs.hasNext();
+				if (haveTheirs) b = theirs.next();
+			}
+		}
+		while (haveMine && keepMine) {
+			result.add(a);
+			haveMine = mine.hasNext();
+			if (haveMine) a = mine.next();
+		}
+		while (haveTheirs && keepTheirs) {
+			result.add(b);
+			haveTheirs = theirs.hasNext();
+			if (haveTheirs) b = theirs.next();
+		}
+		bst.buildFromSorted(result);
+	}
+
+/*
+ * Private member function: fewLookups
+ * Usage: if (fewLookups(n, size())) . . .
+ * ---------------------------------------
+ * This function returns true if performing nLookups searches in a set of
+ * setSize elements, each costing about log2(setSize) comparisons, is
+ * cheaper than a linear pass over the set.
+ */
+template <typename ElemType>
+  bool Set<ElemType>::fewLookups(int nLookups, int setSize)
+	{
+		int depth = 1;
+		for (int n = setSize; n > 1; n /= 2)
+			depth++;
+		return ((double) nLookups * depth < setSize);
 	}
 
 	
@@ -412,14 +509,11 @@ template <typename ElemType>
 /* 
  * Set::Iterator class implementation
  * ----------------------------------
- * The Iterator for Set tracks a pointer to the original Set and a vector containing
- * of the elems that was assembled at the time of iteration creation.  The
- * iterator tracks an index into that vector that identifies the next key to return.
- * Each use of next() increments that index, hasNext() verifies the index < the vector's 
- * size. This is an example of an "offline" iterator because it copies the set's 
- * data, instead of accessing it in-place. This is a bit inefficient (since it copies)
- * but it makes the iterator simplier to write and sidesteps any problems where the 
- * client is modifying the set during iteration.
+ * The Iterator for Set is a thin wrapper around the in-order iterator of the
+ * underlying BST. It reads the tree in place, holding only the path from the
+ * root to the next element, so no copy of the set's data is made. This makes
+ * it an "online" iterator, and the client must not modify the set while
+ * iterating over it.
  */
 
 template <typename ElemType> 
@@ -434,27 +528,17 @@ template <typename ElemType>
 		return Iterator(this);
 	}
 
-		
-
-template <typename ElemType>
-  static void AddToVector(ElemType elem, Vector<ElemType> &vec)
-	{
-		vec.add(elem);
-	}
-	
 template <typename ElemType> 
-  Set<ElemType>::Iterator::Iterator(Set *setptr) : elems(setptr->size())
+  Set<ElemType>::Iterator::Iterator(Set *setptr) : itr(setptr->bst.iterator())
 	{
 		sp = setptr;
-		sp->mapAll<Vector<ElemType> >(AddToVector, elems);
-		curIndex = 0;
 	}
 
 template <typename ElemType> 
   bool Set<ElemType>::Iterator::hasNext() 
 	{
 		if (sp == NULL) Error("hasNext called on uninitialized iterator");
-		 return curIndex < elems.size();
+		return itr.hasNext();
 	}
 
 template <typename ElemType> 
@@ -462,7 +546,7 @@ template <typename ElemType>
 	{
 		if (sp == NULL) Error("next called on uninitialized iterator");
 		if (!hasNext()) Error("Attempt to get next from iterator where hasNext() is false");
-		return elems[curIndex++];
+		return itr.next();
 	}
 	
 #endif // _set_h_
@@ -118,23 +118,39 @@ template <typename ElemType>
 		/*
 		 * Deep copying support
 		 * --------------------
-		 * Because all data members have correct behavior on operator=
-		 * and copy constructor, the default as synthesized by
-		 * the compiler make a correct copy of the Stack. When pass/return
-		 * stacks by value, or assign one to another, the entire contents 
-		 * of the stack, including all elements, are copied. Each stack
+		 * This copy constructor and operator= are defined to make a
+		 * deep copy, making it possible to pass/return stacks by value
+		 * and assign from one stack to another. The entire contents of 
+		 * the stack, including all elements, are copied. Each stack
 		 * element is copied from the original stack to the copy using
 		 * assignment (operator=). Making copies is generally avoided 
 		 * because of the expense and thus, stacks are typically passed by 
 		 * reference, however, when a copy is needed, these operations 
-		 * correctly are supported.
-		 *
-		 * const Stack &operator=(const Stack &rhs); 
-		 * Stack(const Stack &rhs);
+		 * are supported.
 		 */
+		const Stack &operator=(const Stack &rhs); 
+		Stack(const Stack &rhs);
 
 		private:
-			Vector<ElemType> elems;
+			static const int CHUNK_SIZE = 64;
+			static const int MAX_FREE_CHUNKS = 16;
+			struct chunk {
+				union {
+					char bytes[CHUNK_SIZE * sizeof(ElemType)];
+					double alignDouble;
+					long double alignLongDouble;
+					long alignLong;
+					void *alignPointer;
+				} storage;
+				chunk *next;
+			};
+			chunk *top, *freeList;
+			int topCount, count, numFree;
+			static ElemType *slot(chunk *c, int index);
+			chunk *newChunk();
+			void recycleChunk(chunk *c);
+			void deleteChunks();
+			void copyOtherData(const Stack &rhs);
 	};
 	
 
@@ -152,57 +168,183 @@ template <typename ElemType>
 /* 
  * Stack class implementation
  * ---------------------------
- * The Stack is internally managed using a Vector. This layered implementation makes the
- * job quite trivial, most member functions are one-liners.
+ * The Stack is internally managed as a singly linked list of chunks, each of which
+ * holds up to CHUNK_SIZE elements in an array. The top chunk is at the head of the
+ * list and holds topCount elements; every chunk below it is full. Pushing and popping
+ * call the allocator only once per CHUNK_SIZE elements, and a chunk is never copied
+ * once it is allocated. As in the Queue, chunks that empty out are kept on a short
+ * free list for reuse. Also as in the Queue, elements are constructed in the raw
+ * storage of a chunk when they are pushed and destroyed when they are popped.
  */
+#include "genlib.h" // for Error
+#include <cstdlib> // for NULL
+#include <new> // for placement new
 
 
 template <typename ElemType> 
   Stack<ElemType>::Stack()
-	{}
+	{
+		top = freeList = NULL;
+		topCount = count = numFree = 0;
+	}
 	
 template <typename ElemType> 
   Stack<ElemType>::~Stack()
-	{}
+	{
+		deleteChunks();
+	}
 
 template <typename ElemType> 
   int Stack<ElemType>::size()
 	{
-		return elems.size();
+		return count;
 	}
 
 template <typename ElemType> 
   bool Stack<ElemType>::isEmpty()
 	{
-		return (size() == 0);
+		return (count == 0);
 	}
 	
 template <typename ElemType> 
   void Stack<ElemType>::push(ElemType elem)
 	{
-		elems.add(elem);
+		if (top == NULL || topCount == CHUNK_SIZE) {
+			chunk *newOne = newChunk();
+			newOne->next = top;
+			top = newOne;
+			topCount = 0;
+		}
+		new (slot(top, topCount++)) ElemType(elem);
+		count++;
 	}
 	
 template <typename ElemType> 
   ElemType Stack<ElemType>::pop()
 	{
 		if (isEmpty()) Error("Attempt to pop from empty stack");
-		ElemType top = elems[elems.size()-1];
-		elems.removeAt(elems.size()-1);
-		return top;
+		ElemType *last = slot(top, --topCount);
+		ElemType result = *last;
+		last->~ElemType();
+		count--;
+		if (topCount == 0 && top->next != NULL) {
+			chunk *toRecycle = top;
+			top = top->next;
+			topCount = CHUNK_SIZE;
+			recycleChunk(toRecycle);
+		}
+		return result;
 	}
 	
 template <typename ElemType> 
   ElemType Stack<ElemType>::peek()
 	{
 		if (isEmpty()) Error("Attempt to peek at empty stack");
-		return elems[elems.size()-1];
+		return *slot(top, topCount - 1);
 	}
 	
 template <typename ElemType> 
   void Stack<ElemType>::clear()
 	{
-		elems.clear();
+		deleteChunks();
+	}
+
+/*
+ * Chunk management
+ * ----------------
+ * These functions work the same way as their counterparts in the Queue.
+ */
+template <typename ElemType> 
+  ElemType *Stack<ElemType>::slot(chunk *c, int index)
+	{
+		return reinterpret_cast<ElemType *>(c->storage.bytes) + index;
+	}
+
+template <typename ElemType> 
+  typename Stack<ElemType>::chunk *Stack<ElemType>::newChunk()
+	{
+		chunk *c;
+		if (freeList != NULL) {
+			c = freeList;
+			freeList = freeList->next;
+			numFree--;
+		} else {
+			c = new chunk;
+		}
+		c->next = NULL;
+		return c;
+	}
+
+template <typename ElemType> 
+  void Stack<ElemType>::recycleChunk(chunk *c)
+	{
+		if (numFree < MAX_FREE_CHUNKS) {
+			c->next = freeList;
+			freeList = c;
+			numFree++;
+		} else {
+			delete c;
+		}
+	}
+
+template <typename ElemType> 
+  void Stack<ElemType>::deleteChunks()
+	{
+		int n = topCount;
+		while (top != NULL) {
+			for (int i = 0; i < n; i++)
+				slot(top, i)->~ElemType();
+			n = CHUNK_SIZE;
+			chunk *next = top->next;
+			delete top;
+			top = next;
+		}
+		while (freeList != NULL) {
+			chunk *next = freeList->next;
+			delete freeList;
+			freeList = next;
+		}
+		topCount = count = numFree = 0;
+	}
+
+template <typename ElemType> 
+  const Stack<ElemType> &Stack<ElemType>::operator=(const Stack &rhs) 
+	{
+		if (this != &rhs) {
+			clear();
+			copyOtherData(rhs);
+		}
+		return *this;
+	}
+
+template <typename ElemType> 
+  Stack<ElemType>::Stack(const Stack &rhs)
+	{
+		top = freeList = NULL;
+		topCount = count = numFree = 0;
+		copyOtherData(rhs);
+	}
+
+/*
+ * copyOtherData copies the chunks of rhs one at a time, from the top down, so that
+ * the copy has the same layout as the original.
+ */
+template <typename ElemType> 
+  void Stack<ElemType>::copyOtherData(const Stack &rhs) 
+	{
+		chunk **link = &top;
+		int n = rhs.topCount;
+		for (chunk *cur = rhs.top; cur != NULL; cur = cur->next) {
+			chunk *copy = new chunk;
+			for (int i = 0; i < n; i++)
+				new (slot(copy, i)) ElemType(*slot(cur, i));
+			copy->next = NULL;
+			*link = copy;
+			link = &copy->next;
+			n = CHUNK_SIZE;
+		}
+		topCount = rhs.topCount;
+		count = rhs.count;
 	}
 
 	
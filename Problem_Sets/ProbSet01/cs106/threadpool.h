@@ -0,0 +1,230 @@
+/*
+ * File: threadpool.h
+ * ------------------
+ * This interface exports the <code>ThreadPool</code> class, which keeps
+ * a fixed set of worker threads ready to share the work of a loop, along
+ * with functions that apply an operation to every element of an array,
+ * a <code>Vector</code>, or a <code>Grid</code> in parallel.  Clients
+ * that use these functions must include this interface explicitly,
+ * because it brings in the names exported by <code>thread.h</code>.
+ */
+
+#ifndef _threadpool_h
+#define _threadpool_h
+
+#include <stdint.h>
+#include "error.h"
+#include "grid.h"
+#include "thread.h"
+#include "vector.h"
+
+/*
+ * Class: ThreadPool
+ * -----------------
+ * This class manages a group of threads that wait for work.  Starting
+ * a thread is expensive compared with the cost of handing work to one
+ * that is already running, so a pool makes it practical to parallelize
+ * loops that take only a few milliseconds.  A pool with
+ * <i>n</i> threads uses the calling thread as one of them and keeps
+ * <i>n</i>&nbsp;-&nbsp;1 workers.
+ *
+ * <p>The work is divided by <i>static chunking:</i> each operation is
+ * split into a fixed number of tasks before it starts, and the tasks
+ * are dealt out to the threads in turn.
+ *
+ * <p>A task that calls back into the pool it is running on does not
+ * wait for the pool, which is busy with the task itself; the nested
+ * operation instead runs all of its tasks on the calling thread.  If a
+ * task throws an exception, the thread that ran it skips the rest of
+ * its tasks.  The pool waits for the other threads to finish and then
+ * reports the first exception on the thread that started the operation
+ * by calling <code>error</code> with its message.
+ */
+
+class ThreadPool {
+
+public:
+
+/*
+ * Constructor: ThreadPool
+ * Usage: ThreadPool pool(nThreads);
+ * ---------------------------------
+ * Creates a pool with the specified number of threads, counting the
+ * thread that uses the pool.  The workers are started immediately
+ * and wait until there is work for them to do.
+ */
+
+   explicit ThreadPool(int nThreads);
+
+/*
+ * Destructor: ~ThreadPool
+ * Usage: (usually implicit)
+ * -------------------------
+ * Stops the worker threads and waits for them to finish.
+ */
+
+   ~ThreadPool();
+
+/*
+ * Method: getThreadCount
+ * Usage: int nThreads = pool.getThreadCount();
+ * --------------------------------------------
+ * Returns the number of threads in the pool, including the caller.
+ * Another thread may change the size of the pool at any time, so
+ * clients that divide work according to this value should pass the
+ * number of tasks to <code>runParallel</code> explicitly.
+ */
+
+   int getThreadCount() const;
+
+/*
+ * Method: setThreadCount
+ * Usage: pool.setThreadCount(nThreads);
+ * -------------------------------------
+ * Stops the current workers and starts a new set so that the pool
+ * has the specified number of threads.  This method waits for any
+ * operation in progress to finish.  It signals an error if it is
+ * called from a task running on the same pool.
+ */
+
+   void setThreadCount(int nThreads);
+
+/*
+ * Method: runParallel
+ * Usage: pool.runParallel(fn, data);
+ *        pool.runParallel(fn, data, nTasks);
+ * ------------------------------------------
+ * Calls <code>fn(data, index)</code> once for each <code>index</code>
+ * from 0 to <code>nTasks&nbsp;-&nbsp;1</code> and returns when all of
+ * the calls have finished.  Thread <i>t</i> of the pool makes the calls
+ * whose index leaves a remainder of <i>t</i> when divided by the number
+ * of threads, and thread 0 is the calling thread.  If
+ * <code>nTasks</code> is omitted, there is one call for each thread in
+ * the pool, each on a different thread.  Operations requested by
+ * several threads are carried out one at a time.
+ */
+
+   template <typename ClientType>
+   void runParallel(void (*fn)(ClientType & data, int index),
+                    ClientType & data);
+
+   template <typename ClientType>
+   void runParallel(void (*fn)(ClientType & data, int index),
+                    ClientType & data, int nTasks);
+
+#include "private/threadpoolpriv.h"
+
+};
+
+/*
+ * Function: getDefaultThreadPool
+ * Usage: ThreadPool & pool = getDefaultThreadPool();
+ * --------------------------------------------------
+ * Returns the pool used by the parallel functions for the collection
+ * classes.  The pool is created the first time this function is
+ * called and has one thread for each processor that the system
+ * reports as online.  Clients can change its size by calling
+ * <code>setThreadCount</code>.
+ */
+
+ThreadPool & getDefaultThreadPool();
+
+/*
+ * Function: parallelMapAll
+ * Usage: parallelMapAll(pool, array, n, fn);
+ * ------------------------------------------
+ * Calls <code>fn(array[i])</code> for each <code>i</code> from 0 to
+ * <code>n&nbsp;-&nbsp;1</code>, dividing the array among the threads in
+ * <code>pool</code>.  The function <code>fn</code> may be an ordinary
+ * function or any object that can be called like one, including a
+ * C++11 lambda expression.  Because the calls run concurrently and in
+ * no particular order, <code>fn</code> must not modify shared data
+ * without synchronization.
+ */
+
+template <typename ValueType, typename FunctionType>
+void parallelMapAll(ThreadPool & pool, ValueType *array, int n,
+                    FunctionType fn);
+
+/*
+ * Function: parallelTransform
+ * Usage: parallelTransform(pool, array, n, fn);
+ * ---------------------------------------------
+ * Replaces each element of the array with <code>fn(array[i])</code>,
+ * dividing the array among the threads in <code>pool</code>.
+ */
+
+template <typename ValueType, typename FunctionType>
+void parallelTransform(ThreadPool & pool, ValueType *array, int n,
+                       FunctionType fn);
+
+/*
+ * Function: parallelReduce
+ * Usage: ResultType result = parallelReduce(pool, array, n, identity,
+ *                                           combine, deterministic);
+ * ------------------------------------------------------------------
+ * Combines the elements of the array into a single result.  Each chunk
+ * of the array is reduced separately by starting with
+ * <code>identity</code> and setting <code>result</code> to
+ * <code>combine(result,&nbsp;array[i])</code> for each element in turn.
+ * The partial results are then combined, in order, by calling
+ * <code>combine(result,&nbsp;partial)</code>.  The operation must
+ * therefore be associative, and <code>identity</code> must leave any
+ * value unchanged.  If the result type differs from the element type,
+ * <code>combine</code> must be an object whose <code>operator()</code>
+ * is overloaded to accept both kinds of second argument.
+ *
+ * <p>By default, the array is divided into one chunk per thread, so
+ * the grouping of the operations depends on the size of the pool.  If
+ * <code>deterministic</code> is <code>true</code>, the array is instead
+ * divided into chunks whose boundaries depend only on <code>n</code>.
+ * The result is then exactly the same for any number of threads,
+ * which matters for floating-point sums.
+ */
+
+template <typename ValueType, typename ResultType, typename CombineType>
+ResultType parallelReduce(ThreadPool & pool, const ValueType *array, int n,
+                          ResultType identity, CombineType combine,
+                          bool deterministic = false);
+
+/*
+ * Functions: parallelMapAll, parallelTransform, parallelReduce
+ * Usage: parallelMapAll(vec, fn);
+ *        parallelTransform(grid, fn);
+ *        ResultType result = parallelReduce(vec, identity, combine);
+ *        ResultType result = parallelReduce(grid, identity, combine,
+ *                                           deterministic);
+ * ------------------------------------------------------------------
+ * These forms apply the array functions above to the elements of a
+ * <code>Vector</code> or a <code>Grid</code>, using the pool returned
+ * by <code>getDefaultThreadPool</code>.  For example,
+ * <code>parallelReduce(vec, 0.0, std::plus<double>())</code> returns
+ * the sum of the elements of <code>vec</code>.  A grid that shares
+ * its elements by copy-on-write is given its own copy of them before
+ * <code>parallelMapAll</code> or <code>parallelTransform</code> starts,
+ * because <code>fn</code> may change them.
+ */
+
+template <typename ValueType, typename FunctionType>
+void parallelMapAll(Vector<ValueType> & vec, FunctionType fn);
+
+template <typename ValueType, typename FunctionType>
+void parallelMapAll(Grid<ValueType> & grid, FunctionType fn);
+
+template <typename ValueType, typename FunctionType>
+void parallelTransform(Vector<ValueType> & vec, FunctionType fn);
+
+template <typename ValueType, typename FunctionType>
+void parallelTransform(Grid<ValueType> & grid, FunctionType fn);
+
+template <typename ValueType, typename ResultType, typename CombineType>
+ResultType parallelReduce(const Vector<ValueType> & vec, ResultType identity,
+                          CombineType combine, bool deterministic = false);
+
+template <typename ValueType, typename ResultType, typename CombineType>
+ResultType parallelReduce(const Grid<ValueType> & grid, ResultType identity,
+                          CombineType combine, bool deterministic = false);
+
+#include "private/threadpoolimpl.cpp"
+
+#endif
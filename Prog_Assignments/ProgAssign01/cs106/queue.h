@@ -127,12 +127,24 @@ template <typename ElemType>
 		
 		
 		private:
-			struct cell {
-				ElemType elem;
-				cell *next;
+			static const int CHUNK_SIZE = 64;
+			static const int MAX_FREE_CHUNKS = 16;
+			struct chunk {
+				union {
+					char bytes[CHUNK_SIZE * sizeof(ElemType)];
+					double alignDouble;
+					long double alignLongDouble;
+					long alignLong;
+					void *alignPointer;
+				} storage;
+				chunk *next;
 			};
-			cell *head, *tail;
-			void deleteCells();
+			chunk *head, *tail, *freeList;
+			int headIndex, tailIndex, count, numFree;
+			static ElemType *slot(chunk *c, int index);
+			chunk *newChunk();
+			void recycleChunk(chunk *c);
+			void deleteChunks();
 			void copyOtherData(const Queue &rhs);
 	};
 	
@@ -150,61 +162,79 @@ template <typename ElemType>
 /* 
  * Queue class implementation
  * ---------------------------
- * The Queue is internally managed as a singly linked list of cells, with a head and
- * tali pointer.  The front of the queue is at the head, the end is at the tail.
+ * The Queue is internally managed as a singly linked list of chunks, each of which
+ * holds up to CHUNK_SIZE elements in an array. The front of the queue is at position
+ * headIndex of the head chunk, and the next element is stored at position tailIndex
+ * of the tail chunk. Storing many elements per chunk means that enqueue and dequeue
+ * call the allocator only once per CHUNK_SIZE elements, and that neighboring elements
+ * are stored next to each other in memory. Chunks that empty out are kept on a short
+ * free list so that a queue whose size hovers around a chunk boundary can reuse them
+ * instead of allocating new ones. A chunk holds raw storage rather than an array of
+ * ElemType, and each element is copy-constructed in its slot when it is enqueued and
+ * destroyed when it is dequeued, so ElemType need not have a default constructor.
  */
 #include "genlib.h" // for Error
 #include <cstdlib> // for NULL
+#include <new> // for placement new
 
 
 template <typename ElemType> 
   Queue<ElemType>::Queue()
 	{
-		head = tail = NULL;
+		head = tail = freeList = NULL;
+		headIndex = tailIndex = count = numFree = 0;
 	}
 	
 template <typename ElemType> 
   Queue<ElemType>::~Queue()
 	{
-		deleteCells();
+		deleteChunks();
 	}
 
 template <typename ElemType> 
   int Queue<ElemType>::size()
 	{
-		int count = 0;
-		for (cell *cur = head; cur != NULL; cur = cur->next)
-			count++;
 		return count;
 	}
 
 template <typename ElemType> 
   bool Queue<ElemType>::isEmpty()
 	{
-		return (head == NULL);
+		return (count == 0);
 	}
 	
 template <typename ElemType> 
   void Queue<ElemType>::enqueue(ElemType elem)
 	{
-		cell *newOne = new cell;
-		newOne->elem = elem;
-		newOne->next = NULL;
-		if (head != NULL)
-			tail->next = newOne;
-		else
-			head = newOne;
-		tail = newOne;
+		if (tail == NULL || tailIndex == CHUNK_SIZE) {
+			chunk *newOne = newChunk();
+			if (tail != NULL)
+				tail->next = newOne;
+			else
+				head = newOne;
+			tail = newOne;
+			tailIndex = 0;
+		}
+		new (slot(tail, tailIndex++)) ElemType(elem);
+		count++;
 	}
 	
 template <typename ElemType> 
   ElemType Queue<ElemType>::dequeue()
 	{
 		if (isEmpty()) Error("Attempt to dequeue from empty queue");
-		ElemType first = head->elem;
-		cell *toDelete = head;
-		head = head->next;
-		delete toDelete;
+		ElemType *front = slot(head, headIndex++);
+		ElemType first = *front;
+		front->~ElemType();
+		count--;
+		if (count == 0) {
+			headIndex = tailIndex = 0;  // reuse the only chunk from the start
+		} else if (headIndex == CHUNK_SIZE) {
+			chunk *toRecycle = head;
+			head = head->next;
+			headIndex = 0;
+			recycleChunk(toRecycle);
+		}
 		return first;
 	}
 	
@@ -212,24 +242,81 @@ template <typename ElemType>
   ElemType Queue<ElemType>::peek()
 	{
 		if (isEmpty()) Error("Attempt to peek at empty queue");
-		return head->elem;
+		return *slot(head, headIndex);
 	}
 
 template <typename ElemType> 
   void Queue<ElemType>::clear()
 	{
-		deleteCells();
+		deleteChunks();
 	}
 
+/*
+ * Chunk management
+ * ----------------
+ * slot returns the address of the given position in the storage of a chunk. newChunk
+ * takes a chunk from the free list when one is available and allocates a new one
+ * otherwise. recycleChunk puts an empty chunk back on the free list, unless the list
+ * is already full, in which case the chunk is deleted. The cap keeps a queue that
+ * was once very long from holding on to all of its old storage.
+ */
 template <typename ElemType> 
-  void Queue<ElemType>::deleteCells()
+  ElemType *Queue<ElemType>::slot(chunk *c, int index)
 	{
+		return reinterpret_cast<ElemType *>(c->storage.bytes) + index;
+	}
+
+template <typename ElemType> 
+  typename Queue<ElemType>::chunk *Queue<ElemType>::newChunk()
+	{
+		chunk *c;
+		if (freeList != NULL) {
+			c = freeList;
+			freeList = freeList->next;
+			numFree--;
+		} else {
+			c = new chunk;
+		}
+		c->next = NULL;
+		return c;
+	}
+
+template <typename ElemType> 
+  void Queue<ElemType>::recycleChunk(chunk *c)
+	{
+		if (numFree < MAX_FREE_CHUNKS) {
+			c->next = freeList;
+			freeList = c;
+			numFree++;
+		} else {
+			delete c;
+		}
+	}
+
+template <typename ElemType> 
+  void Queue<ElemType>::deleteChunks()
+	{
+		chunk *cur = head;
+		int index = headIndex;
+		for (int i = 0; i < count; i++) {
+			if (index == CHUNK_SIZE) {
+				cur = cur->next;
+				index = 0;
+			}
+			slot(cur, index++)->~ElemType();
+		}
 		while (head != NULL) {
-			cell *next = head->next;
+			chunk *next = head->next;
 			delete head;
 			head = next;
 		}
+		while (freeList != NULL) {
+			chunk *next = freeList->next;
+			delete freeList;
+			freeList = next;
+		}
 		tail = NULL;
+		headIndex = tailIndex = count = numFree = 0;
 	}
 
 template <typename ElemType> 
@@ -245,15 +332,23 @@ template <typename ElemType>
 template <typename ElemType> 
   Queue<ElemType>::Queue(const Queue &rhs)
 	{
-		head = tail = NULL;
+		head = tail = freeList = NULL;
+		headIndex = tailIndex = count = numFree = 0;
 		copyOtherData(rhs);
 	}	
 	
 template <typename ElemType> 
   void Queue<ElemType>::copyOtherData(const Queue &rhs) 
 	{
-		for (cell *cur = rhs.head; cur != NULL; cur = cur->next)
-			enqueue(cur->elem);
+		int index = rhs.headIndex;
+		chunk *cur = rhs.head;
+		for (int i = 0; i < rhs.count; i++) {
+			if (index == CHUNK_SIZE) {
+				cur = cur->next;
+				index = 0;
+			}
+			enqueue(*slot(cur, index++));
+		}
 	}
 
 
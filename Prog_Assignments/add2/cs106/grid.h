@@ -142,6 +142,20 @@ class Grid {
 		ElemType &operator()(int row, int col);
 
 
+		/*
+		 * Member function: rowPtr
+		 * Usage: ElemType *rp = grid.rowPtr(row);
+		 * ---------------------------------------
+		 * This member function returns a pointer to the first element of
+		 * the specified row.  The elements of a row are contiguous, so
+		 * rp[col] refers to the element in column col.  Raises an error
+		 * if row is outside the range [0, numRows()-1], but no check is
+		 * made on later uses of the pointer, which remains valid until
+		 * the grid is resized or destroyed.
+		 */
+		ElemType *rowPtr(int row);
+
+
 		/*
 		 * Deep copying support
 		 * --------------------
@@ -260,6 +274,15 @@ template <typename ElemType>
 		return elements[(row * nCols) + col];
 	}
 
+template <typename ElemType>
+  ElemType *Grid<ElemType>::rowPtr(int row) 
+	{ 
+		if (row < 0 || row >= numRows())
+			Error("Attempt to access row " + IntegerToString(row) +
+			      " in a grid of size (" + IntegerToString(numRows()) + ", " + IntegerToString(numCols()) + ")");
+		return elements + (row * nCols);
+	}
+
 template <typename ElemType>
  const Grid<ElemType> & Grid<ElemType>::operator=(const Grid &rhs) 
  	{
@@ -195,8 +195,9 @@ template <typename ValueType>
 		 * ----------------------------
 		 * This member function creates an iterator that allows the client
 		 * to iterate through the keys in this map.  Note that the iterator
-		 * returns the _keys_ one by one.  If needed, you can retrieve the 
-		 * associated value from the map using getValue or operator[].
+		 * returns the _keys_ one by one.  The value associated with the key
+		 * most recently returned can be read or changed through the iterator's
+		 * value member function, which avoids a second lookup in the map.
 		 */
 		Iterator iterator();
 
@@ -213,20 +214,35 @@ template <typename ValueType>
 		 * that calls next() while hasNext() is true, like this:
 		 *
 		 *	Map<int>::Iterator itr = map.iterator();
-		 *  while (itr.hasNext())
+		 *  while (itr.hasNext()) {
 		 *      string key = itr.next();
+		 *      int value = itr.value();
+		 *  }
+		 *
+		 * After a call to next(), key() returns the same key again and value()
+		 * returns a reference to its associated value. The iterator walks the
+		 * map's internal table in place, so creating one is cheap and leaving a
+		 * loop early costs nothing extra. As a consequence, the map must not be
+		 * modified while an iterator is in use, although values may be changed
+		 * through value().
 		 */
+		private:
+			struct cell;
+		public:
 		class Iterator {
 			public:
 				Iterator(); 
 				bool hasNext();
 				string next();
+				string key();
+				ValueType &value();
 			
 			private:
 				Iterator(Map *mp);
+				void advance();
 				Map *mp;
-				Vector<string> keys;
-				int curIndex;
+				int bucket;
+				cell *cur, *last;
 				friend class Map;
 		};
 		friend class Iterator;
@@ -252,6 +268,7 @@ template <typename ValueType>
 			struct cell {
 				string key;
 				ValueType value;
+				unsigned long hashcode;
 				cell *next;
 			};
 			
@@ -260,8 +277,9 @@ template <typename ValueType>
 	
 			void initBuckets(int nBuckets);
 			void deleteBuckets(Vector<cell *> &bucketsToDelete);
-			int hash(string s);
-			cell *findCell(cell *head, string key, cell **prev = NULL);
+			unsigned long hash(const string &s);
+			cell *findCell(cell *head, const string &key, unsigned long hashcode,
+			               cell **prev = NULL);
 			void expandAndRehash();
 			void copyOtherEntries(const Map &rhs);
 	};
@@ -286,6 +304,9 @@ template <typename ValueType>
  * by chaining). The buckets are dynamically allocated so that we can change the
  * the number of buckets (rehash) when the load factor becomes too high. The
  * map should provide O(1) performance on the add/remove/getValue operations.
+ * Each cell remembers the full hash code of its key. This lets a search skip
+ * cells whose codes differ without comparing strings, and lets a rehash move
+ * cells to their new buckets without hashing the keys again.
  */
 
 
@@ -323,13 +344,14 @@ template <typename ValueType>
 template <typename ValueType>
   void Map<ValueType>::remove(string key)
 	{
-	   	int hashCode = hash(key);
-	   	cell *prev, *found = findCell(buckets[hashCode], key, &prev);
+	   	unsigned long hashcode = hash(key);
+	   	int bucket = hashcode % buckets.size();
+	   	cell *prev, *found = findCell(buckets[bucket], key, hashcode, &prev);
 		if (found != NULL) {
 			if (prev != NULL) 
 				prev->next = found->next;	 // splice out of list if in middle
 			else 
-				buckets[hashCode] = found->next;	// remove head node if first
+				buckets[bucket] = found->next;	// remove head node if first
 			numEntries--;
 			delete found;
 		}
@@ -346,8 +368,8 @@ template <typename ValueType>
 template <typename ValueType>
   bool Map<ValueType>::containsKey(string key)
 	{
-		int hashCode = hash(key);
-		return (findCell(buckets[hashCode], key) != NULL);
+		unsigned long hashcode = hash(key);
+		return (findCell(buckets[hashcode % buckets.size()], key, hashcode) != NULL);
 	}
 	
 
@@ -364,15 +386,16 @@ template <typename ValueType>
 template <typename ValueType> 
   ValueType & Map<ValueType>::operator[](string key)
 	{
-		int hashCode = hash(key);
-		cell *cp = findCell(buckets[hashCode], key);
+		unsigned long hashcode = hash(key);
+		cell *cp = findCell(buckets[hashcode % buckets.size()], key, hashcode);
 		if (cp == NULL) {
 		    if (numEntries > buckets.size()*2) expandAndRehash();
-		    hashCode = hash(key); // num buckets has changed
+		    int bucket = hashcode % buckets.size(); // num buckets may have changed
 			cp = new cell;
 			cp->key = key;
-			cp->next = buckets[hashCode];
-			buckets[hashCode] = cp;
+			cp->hashcode = hashcode;
+			cp->next = buckets[bucket];
+			buckets[bucket] = cp;
 			numEntries++;
 		}
 		return cp->value;
@@ -439,21 +462,24 @@ template <typename ValueType>
 
 /*
  * Private member function: findCell
- * Usage: cp = findCell(cp, key, &prev);
- * -------------------------------------
+ * Usage: cp = findCell(cp, key, hashcode, &prev);
+ * -----------------------------------------------
  * This function finds a cell in the chain beginning at cp that
- * matches key.  If a match is found, a pointer to that cell is
- * returned.  If no match is found, the function returns NULL.
- * The optional third argument is a pointer to the previous cell
+ * matches key, whose hash code is given by the third argument.
+ * If a match is found, a pointer to that cell is returned.  If no
+ * match is found, the function returns NULL.  The strings are
+ * compared only for cells whose hash codes are equal.
+ * The optional fourth argument is a pointer to the previous cell
  * pointer, which the client may need if attempting to splice out
  * the found cell. If not specified, NULL is the default value.
  */
 template <typename ValueType>
   typename Map<ValueType>::cell 
-         *Map<ValueType>::findCell(cell *cp, string key, cell **prevByRef)
+         *Map<ValueType>::findCell(cell *cp, const string &key, unsigned long hashcode,
+                                   cell **prevByRef)
 	{
 		cell *prev = NULL;
-	    while (cp != NULL && key != cp->key) {
+	    while (cp != NULL && (cp->hashcode != hashcode || key != cp->key)) {
 	    	prev = cp;
 	        cp = cp->next;
 	    }
@@ -464,21 +490,22 @@ template <typename ValueType>
 
 /*
  * Private member function: hash
- * Usage: bucket = hash(key);
- * --------------------------
- * This function takes the key and uses it to derive a hash code,
- * which is an integer in the range [0, buckets.size() - 1].  The hash
- * code is computed using a method called linear congruence.
+ * Usage: hashcode = hash(key);
+ * ----------------------------
+ * This function takes the key and uses it to derive a hash code.
+ * The hash code is computed using a method called linear congruence.
+ * Callers reduce it to a bucket index in the range
+ * [0, buckets.size() - 1] by taking the remainder.
  */
 template <typename ValueType>
-  int Map<ValueType>::hash(string s)
+  unsigned long Map<ValueType>::hash(const string &s)
 	{
 		const long Multiplier = -1664117991;
 	    unsigned long hashcode = 0;
 	    for (string::size_type i = 0; i < s.length(); i++) {
 	        hashcode = hashcode * Multiplier + s[i];
 	    }
-	    return (hashcode % buckets.size());
+	    return hashcode;
 	}
 
 
@@ -488,20 +515,31 @@ template <typename ValueType>
  * Usage: expandAndRehash();
  * -------------------------
  * This member function is used to increase the number of buckets in the map
- * and then rehashes all existing entries and adds them into new buckets.  This
- * operation is used when the load factor (i.e. the number of cells per bucket)
- * has increased enough to warrant this O(N) operation to enlarge and redistribute
- * the entries.
+ * and then moves all existing entries into new buckets.  This operation is
+ * used when the load factor (i.e. the number of cells per bucket) has
+ * increased enough to warrant this O(N) operation to enlarge and redistribute
+ * the entries.  The existing cells are relinked into the new buckets using
+ * their stored hash codes, so no cells are allocated or freed and no keys
+ * or values are copied.
  */
 template <typename ValueType>
   void Map<ValueType>::expandAndRehash()
 	{
-		Vector<cell *>oldBuckets = buckets;	// make copy of existing buckets
-		initBuckets(oldBuckets.size()*2 + 1); 	// make bigger array of empty buckets
-	    for (int i = 0; i < oldBuckets.size(); i++)
-	        for (cell *cp = oldBuckets[i]; cp != NULL; cp = cp->next)
-	            add(cp->key, cp->value);	// add all old cells into new buckets
-	    deleteBuckets(oldBuckets);			// delete previous cells
+		int nBuckets = buckets.size()*2 + 1;
+		Vector<cell *> newBuckets(nBuckets);
+		for (int i = 0; i < nBuckets; i++)
+			newBuckets.add(NULL);
+	    for (int i = 0; i < buckets.size(); i++) {
+	        cell *cp = buckets[i];
+	        while (cp != NULL) {
+	            cell *next = cp->next;
+	            int bucket = cp->hashcode % nBuckets;
+	            cp->next = newBuckets[bucket];	// push onto front of new chain
+	            newBuckets[bucket] = cp;
+	            cp = next;
+	        }
+	    }
+	    buckets = newBuckets;
 	}
 
 		
@@ -524,18 +562,14 @@ template <typename ValueType>
 	}	
 	
 	
-template <typename ValueType>
-  static void AddToMap(string key, ValueType val, Map<ValueType> &map)
-	{
-		map.add(key, val);
-  	}
-	
 /*
  * Private member function: copyOtherEntries
  * Usage: copyOtherEntries(otherMap);
  * ----------------------------------
  * This member functions adds a copy of all entries from the other map to
- * this one.
+ * this one.  The copy gets the same number of buckets as the original, so
+ * each chain can be cloned cell by cell, hash codes included, without
+ * hashing any keys or searching any chains.
  */
 template <typename ValueType> 
 	void Map<ValueType>::copyOtherEntries(const Map &constRhs)
@@ -545,8 +579,20 @@ template <typename ValueType>
 		// trigger compiler problems. We cast away const-ness to avoid this
 		// erroneous complaints. Sigh.
 		Map &rhs = const_cast<Map &>(constRhs);
-		initBuckets(rhs.size());
-		rhs.mapAll<Map<ValueType> >(AddToMap, *this);	// add by using mapping function
+		initBuckets(rhs.buckets.size());
+		for (int i = 0; i < rhs.buckets.size(); i++) {
+			cell **link = &buckets[i];
+			for (cell *cp = rhs.buckets[i]; cp != NULL; cp = cp->next) {
+				cell *copy = new cell;
+				copy->key = cp->key;
+				copy->value = cp->value;
+				copy->hashcode = cp->hashcode;
+				copy->next = NULL;
+				*link = copy;
+				link = &copy->next;
+			}
+		}
+		numEntries = rhs.numEntries;
 	}	
 		
 
@@ -556,20 +602,22 @@ template <typename ValueType>
 /* 
  * Map::Iterator class implementation
  * ----------------------------------
- * The Iterator for Map tracks a pointer to the original Map and a vector containing
- * of the map keys that was assembled at the time of iteration creation.  The
- * iterator tracks an index into that vector that identifies the next key to return.
- * Each use of next() increments that index, hasNext() verifies the index < the vector's 
- * size. This is an example of an "offline" iterator because it copies the map's 
- * data, instead of accessing it in-place. This is a bit inefficient (since it copies)
- * but it makes the iterator simplier to write and sidesteps any problems where the 
- * client is modifying the map during iteration.
+ * The Iterator for Map tracks a pointer to the original Map, the index of the bucket
+ * it is currently walking, and a pointer to the cell holding the next key to return.
+ * Each use of next() returns that key and then advances along the chain, moving on
+ * to the next non-empty bucket when the chain runs out. hasNext() simply checks
+ * whether there is a current cell. This is an "online" iterator because it reads
+ * the map's data in place rather than copying it, so no work is done for keys the
+ * client never asks for. The cell most recently returned is remembered so that the
+ * client can get at its key and value directly.
  */
 
 template <typename ValueType> 
   Map<ValueType>::Iterator::Iterator()
 	{
 		mp = NULL;
+		cur = last = NULL;
+		bucket = 0;
 	}
 
 template <typename ValueType> 
@@ -578,27 +626,34 @@ template <typename ValueType>
 		return Iterator(this);
 	}
 
-		
-
-template <typename ValueType>
-  static void AddToVector(string key, ValueType val, Vector<string> &vec)
+template <typename ValueType> 
+  Map<ValueType>::Iterator::Iterator(Map *mapptr)
 	{
-		vec.add(key);
+		mp = mapptr;
+		bucket = -1;
+		cur = last = NULL;
+		advance();
 	}
-	
+
+/*
+ * Private member function: advance
+ * --------------------------------
+ * Moves cur to the following cell in the current chain, or to the head of the
+ * next non-empty bucket, leaving it NULL once every bucket has been visited.
+ */
 template <typename ValueType> 
-  Map<ValueType>::Iterator::Iterator(Map *mapptr) : keys(mapptr->size())
+  void Map<ValueType>::Iterator::advance()
 	{
-		mp = mapptr;
-		mp->mapAll<Vector<string> >(AddToVector, keys);
-		curIndex = 0;
+		if (cur != NULL) cur = cur->next;
+		while (cur == NULL && ++bucket < mp->buckets.size())
+			cur = mp->buckets[bucket];
 	}
 
 template <typename ValueType> 
   bool Map<ValueType>::Iterator::hasNext() 
 	{
 		if (mp == NULL) Error("hasNext called on uninitialized iterator");
-		 return curIndex < keys.size();
+		return cur != NULL;
 	}
 
 template <typename ValueType> 
@@ -606,7 +661,23 @@ template <typename ValueType>
 	{
 		if (mp == NULL) Error("next called on uninitialized iterator");
 		if (!hasNext()) Error("Attempt to get next from iterator where hasNext() is false");
-		return keys[curIndex++];
+		last = cur;
+		advance();
+		return last->key;
+	}
+
+template <typename ValueType> 
+  string Map<ValueType>::Iterator::key() 
+	{
+		if (last == NULL) Error("key called on iterator before next");
+		return last->key;
+	}
+
+template <typename ValueType> 
+  ValueType &Map<ValueType>::Iterator::value() 
+	{
+		if (last == NULL) Error("value called on iterator before next");
+		return last->value;
 	}
 	
 #endif // _map_h_
@@ -0,0 +1,112 @@
+/*
+ * File: arena.h
+ * -------------
+ * This interface exports the <code>Arena</code> class, which allocates
+ * many objects of the same type from a few large blocks of memory.
+ */
+
+#ifndef _arena_h
+#define _arena_h
+
+#include "error.h"
+
+/*
+ * Class: Arena<ValueType>
+ * -----------------------
+ * This class creates objects of type <code>ValueType</code> in large
+ * blocks of memory called <i>slabs</i> rather than allocating each one
+ * separately on the heap.  Each slab holds twice as many objects as the
+ * one before it, so an arena holding <i>N</i> objects has made only
+ * about log<sub>2</sub>&nbsp;<i>N</i> allocations.  An object that is
+ * destroyed individually leaves a free slot that the next call to
+ * <code>create</code> reuses.  The <code>clear</code> method and the
+ * destructor run the destructors of the remaining objects and release
+ * every slab at once, which is much faster than deleting the objects
+ * one at a time.
+ */
+
+template <typename ValueType>
+class Arena {
+
+public:
+
+/*
+ * Constructor: Arena
+ * Usage: Arena<ValueType> arena;
+ * ------------------------------
+ * Initializes a new empty arena.  No memory is allocated until the
+ * first object is created.
+ */
+
+   Arena();
+
+/*
+ * Destructor: ~Arena
+ * Usage: (usually implicit)
+ * -------------------------
+ * Destroys every object remaining in the arena and frees its slabs.
+ */
+
+   ~Arena();
+
+/*
+ * Method: create
+ * Usage: ValueType *ptr = arena.create();
+ * ---------------------------------------
+ * Returns a pointer to a new object initialized in the same way as
+ * one created by <code>new ValueType()</code>.  The object belongs to
+ * the arena and must not be passed to <code>delete</code>.
+ */
+
+   ValueType *create();
+
+/*
+ * Method: destroy
+ * Usage: arena.destroy(ptr);
+ * --------------------------
+ * Runs the destructor of an object created by this arena and makes its
+ * storage available for reuse.  This method signals an error if
+ * <code>ptr</code> is not a live object in this arena.
+ */
+
+   void destroy(ValueType *ptr);
+
+/*
+ * Method: contains
+ * Usage: if (arena.contains(ptr)) . . .
+ * -------------------------------------
+ * Returns <code>true</code> if <code>ptr</code> is an object created by
+ * this arena that has not yet been destroyed.  This method takes time
+ * proportional to the number of slabs.
+ */
+
+   bool contains(ValueType *ptr) const;
+
+/*
+ * Methods: size, isEmpty
+ * Usage: int nObjects = arena.size();
+ *        if (arena.isEmpty()) . . .
+ * -----------------------------------
+ * These methods return the number of live objects in the arena and
+ * whether that number is zero.
+ */
+
+   int size() const;
+   bool isEmpty() const;
+
+/*
+ * Method: clear
+ * Usage: arena.clear();
+ * ---------------------
+ * Destroys every object in the arena and frees all of its slabs.
+ */
+
+   void clear();
+
+#include "private/arenapriv.h"
+
+};
+
+#include "private/arenaimpl.cpp"
+
+#endif
@@ -0,0 +1,181 @@
+/*
+ * File: bitgrid.h
+ * ---------------
+ * This interface exports the <code>BitGrid</code> class, a
+ * two-dimensional array of boolean values that stores each value in a
+ * single bit.
+ */
+
+#ifndef _bitgrid_h
+#define _bitgrid_h
+
+#include <stdint.h>
+#include "error.h"
+#include "strlib.h"
+
+/*
+ * Class: BitGrid
+ * --------------
+ * The <code>BitGrid</code> class stores a grid of boolean values using
+ * one bit per cell, which takes an eighth of the space of a
+ * <code>Grid&lt;bool&gt;</code>.  The cells are read and written with
+ * <code>get</code> and <code>set</code>, which take the place of
+ * reading and assigning <code>grid[row][col]</code> in a
+ * <code>Grid</code>.  Because each row is packed into 64-bit
+ * words, operations that count cells, shift the grid, or combine rows
+ * with logical operators process 64 cells at a time.
+ */
+
+class BitGrid {
+
+public:
+
+/*
+ * Constructor: BitGrid
+ * Usage: BitGrid grid;
+ *        BitGrid grid(nRows, nCols);
+ * ----------------------------------
+ * Initializes a new grid.  The second form of the constructor creates
+ * a grid with the specified number of rows and columns, in which every
+ * cell is <code>false</code>.  The default constructor creates an empty
+ * grid for which the client must call <code>resize</code> to set the
+ * dimensions.
+ */
+
+   BitGrid();
+   BitGrid(int nRows, int nCols);
+
+/*
+ * Destructor: ~BitGrid
+ * Usage: (usually implicit)
+ * -------------------------
+ * Frees any heap storage associated with this grid.
+ */
+
+   ~BitGrid();
+
+/*
+ * Methods: numRows, numCols
+ * Usage: int nRows = grid.numRows();
+ * ----------------------------------
+ * These methods return the number of rows and columns in the grid.
+ */
+
+   int numRows() const;
+   int numCols() const;
+
+/*
+ * Method: resize
+ * Usage: grid.resize(nRows, nCols);
+ * ---------------------------------
+ * Reinitializes the grid to have the specified number of rows and
+ * columns, all of which are <code>false</code>.
+ */
+
+   void resize(int nRows, int nCols);
+
+/*
+ * Method: inBounds
+ * Usage: if (grid.inBounds(row, col)) . . .
+ * -----------------------------------------
+ * Returns <code>true</code> if the specified row and column position
+ * is inside the bounds of the grid.
+ */
+
+   bool inBounds(int row, int col) const;
+
+/*
+ * Methods: get, set
+ * Usage: if (grid.get(row, col)) . . .
+ *        grid.set(row, col, value);
+ * -------------------------------------
+ * These methods read and write the cell at the specified position.
+ * They signal an error if the position is outside the grid.
+ */
+
+   bool get(int row, int col) const;
+   void set(int row, int col, bool value);
+
+/*
+ * Method: fill
+ * Usage: grid.fill(value);
+ * ------------------------
+ * Sets every cell of the grid to <code>value</code>.
+ */
+
+   void fill(bool value);
+
+/*
+ * Methods: count, countRow
+ * Usage: long n = grid.count();
+ *        int n = grid.countRow(row);
+ * ----------------------------------
+ * These methods return the number of cells that are <code>true</code>
+ * in the entire grid or in the specified row.  They count a word at a
+ * time using the processor's population-count instruction where the
+ * compiler provides access to it.
+ */
+
+   long count() const;
+   int countRow(int row) const;
+
+/*
+ * Method: shift
+ * Usage: grid.shift(dRows, dCols);
+ * --------------------------------
+ * Moves the value of every cell <code>(row, col)</code> to
+ * <code>(row&nbsp;+&nbsp;dRows, col&nbsp;+&nbsp;dCols)</code>.  Values
+ * shifted past an edge are lost, and the cells left behind become
+ * <code>false</code>.
+ */
+
+   void shift(int dRows, int dCols);
+
+/*
+ * Methods: andRow, orRow, xorRow
+ * Usage: grid.andRow(row, src, srcRow);
+ * -------------------------------------
+ * These methods combine row <code>row</code> of this grid with row
+ * <code>srcRow</code> of <code>src</code>, which may be this grid,
+ * using the corresponding logical operator, and store the result in
+ * <code>row</code>.  The two grids must have the same number of columns.
+ */
+
+   void andRow(int row, const BitGrid & src, int srcRow);
+   void orRow(int row, const BitGrid & src, int srcRow);
+   void xorRow(int row, const BitGrid & src, int srcRow);
+
+/*
+ * Operators: &=, |=, ^=
+ * Usage: grid1 &= grid2;
+ * ----------------------
+ * These operators combine each cell of this grid with the corresponding
+ * cell of another grid of the same dimensions.
+ */
+
+   BitGrid & operator&=(const BitGrid & src);
+   BitGrid & operator|=(const BitGrid & src);
+   BitGrid & operator^=(const BitGrid & src);
+
+/*
+ * Methods: rowWords, wordsPerRow
+ * Usage: uint64_t *words = grid.rowWords(row);
+ * --------------------------------------------
+ * These methods give direct access to the packed representation.  The
+ * value in column <code>col</code> is bit <code>col&nbsp;%&nbsp;64</code>
+ * of <code>words[col&nbsp;/&nbsp;64]</code>, and each row occupies
+ * <code>wordsPerRow()</code> words.  The bits beyond the last column
+ * must remain zero.
+ */
+
+   uint64_t *rowWords(int row);
+   const uint64_t *rowWords(int row) const;
+   int wordsPerRow() const;
+
+#include "private/bitgridpriv.h"
+
+};
+
+#include "private/bitgridimpl.cpp"
+
+#endif
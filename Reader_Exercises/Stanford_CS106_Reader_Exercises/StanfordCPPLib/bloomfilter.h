@@ -0,0 +1,212 @@
+/*
+ * File: bloomfilter.h
+ * -------------------
+ * This interface exports the <code>BloomFilter</code> class, a compact
+ * probabilistic structure that can quickly rule out values that are not
+ * members of a collection.
+ */
+
+#ifndef _bloomfilter_h
+#define _bloomfilter_h
+
+#include <cmath>
+#include <stdint.h>
+#include <string>
+#include "error.h"
+#include "private/atomic.h"
+
+/*
+ * The hash functions used by default are exported by hashmap.h, whose
+ * HashMap class refers to BloomFilter, so the class is declared before
+ * that interface is included.
+ */
+
+template <typename KeyType>
+class BloomFilter;
+
+#include "hashmap.h"
+
+/*
+ * Class: BloomFilter<KeyType>
+ * ---------------------------
+ * This class implements a <i>Bloom&nbsp;filter,</i> which records a
+ * set of keys in a fixed-size bit array.  A Bloom filter never reports
+ * that a key is absent if that key has been added, but it may
+ * occasionally report that a key is present when it is not.  The
+ * rate at which such <i>false positives</i> occur is chosen by the
+ * client when the filter is created.
+ *
+ * <p>Bloom filters are most useful as a prefilter in front of a slower
+ * lookup structure.  If most queries are misses, the filter rejects
+ * them without touching the underlying collection, as in the following
+ * code, which checks a <code>Lexicon</code> built from a file:
+ *
+ *<pre>
+ *    Lexicon english("English.dat");
+ *    BloomFilter<string> filter(english.size());
+ *    filter.addAll(english);
+ *    . . .
+ *    word = toLowerCase(word);
+ *    if (filter.mightContain(word) && english.contains(word)) . . .
+ *</pre>
+ *
+ * The <code>HashMap</code> and <code>Set</code> classes can maintain
+ * their own filter internally; see their <code>enableBloomFilter</code>
+ * methods.
+ */
+
+template <typename KeyType>
+class BloomFilter {
+
+public:
+
+/*
+ * Constructor: BloomFilter
+ * Usage: BloomFilter<KeyType> filter(expectedSize);
+ *        BloomFilter<KeyType> filter(expectedSize, falsePositiveRate);
+ *        BloomFilter<KeyType> filter(expectedSize, falsePositiveRate, hashFn);
+ * --------------------------------------------------------------------------
+ * Initializes a new empty filter sized to hold <code>expectedSize</code>
+ * keys while producing false positives at roughly the specified rate,
+ * which defaults to one percent.  The optional <code>hashFn</code>
+ * argument computes a hash code for a key; if it is omitted, the
+ * filter uses the <code>hashCode</code> function from
+ * <code>hashmap.h</code>.  Adding more keys than
+ * <code>expectedSize</code> is legal but raises the false-positive rate.
+ */
+
+   explicit BloomFilter(int expectedSize,
+                        double falsePositiveRate = 0.01,
+                        int (*hashFn)(const KeyType &) = bloomHashCode);
+
+/*
+ * Destructor: ~BloomFilter
+ * Usage: (usually implicit)
+ * -------------------------
+ * Frees any heap storage associated with this filter.
+ */
+
+   ~BloomFilter();
+
+/*
+ * Method: add
+ * Usage: filter.add(key);
+ * -----------------------
+ * Records <code>key</code> in the filter.
+ */
+
+   void add(const KeyType & key);
+
+/*
+ * Method: addAll
+ * Usage: filter.addAll(collection);
+ * ---------------------------------
+ * Adds every value produced by iterating over <code>collection</code>,
+ * which may be any class that supports <code>begin</code> and
+ * <code>end</code>, including <code>Lexicon</code>, <code>Set</code>,
+ * <code>Vector</code>, and the key iteration of <code>HashMap</code>.
+ */
+
+   template <typename CollectionType>
+   void addAll(const CollectionType & collection);
+
+/*
+ * Method: mightContain
+ * Usage: if (filter.mightContain(key)) . . .
+ * ------------------------------------------
+ * Returns <code>false</code> if <code>key</code> has definitely not
+ * been added to the filter and <code>true</code> if it may have been.
+ * Answering this query touches a single 64-byte block of the filter.
+ */
+
+   bool mightContain(const KeyType & key) const;
+
+/*
+ * Method: clear
+ * Usage: filter.clear();
+ * ----------------------
+ * Removes all keys from the filter.  The counters are not affected.
+ */
+
+   void clear();
+
+/*
+ * Method: resize
+ * Usage: filter.resize(expectedSize);
+ * -----------------------------------
+ * Clears the filter and reallocates its bit array to hold the new
+ * number of keys at the original false-positive rate.
+ */
+
+   void resize(int expectedSize);
+
+/*
+ * Method: capacity
+ * Usage: int n = filter.capacity();
+ * ---------------------------------
+ * Returns the number of keys the filter was sized to hold.
+ */
+
+   int capacity() const;
+
+/*
+ * Method: size
+ * Usage: int n = filter.size();
+ * -----------------------------
+ * Returns the number of calls to <code>add</code> since the filter
+ * was created or last cleared.
+ */
+
+   int size() const;
+
+/*
+ * Method: getFalsePositiveRate
+ * Usage: double rate = filter.getFalsePositiveRate();
+ * ---------------------------------------------------
+ * Returns the false-positive rate requested when the filter was created.
+ */
+
+   double getFalsePositiveRate() const;
+
+/*
+ * Methods: queryCount, rejectCount, falsePositiveCount
+ * Usage: long n = filter.queryCount();
+ * ------------------------------------
+ * These methods return the tuning counters kept by the filter.
+ * <code>queryCount</code> is the number of calls to
+ * <code>mightContain</code>; <code>rejectCount</code> is the number
+ * of those calls that returned <code>false</code>; and
+ * <code>falsePositiveCount</code> is the number of times a client
+ * has called <code>recordFalsePositive</code> after a lookup that
+ * passed the filter failed in the underlying collection.
+ */
+
+   long queryCount() const;
+   long rejectCount() const;
+   long falsePositiveCount() const;
+
+/*
+ * Method: recordFalsePositive
+ * Usage: filter.recordFalsePositive();
+ * ------------------------------------
+ * Notes that a key which passed the filter turned out to be absent.
+ */
+
+   void recordFalsePositive() const;
+
+/*
+ * Method: resetCounters
+ * Usage: filter.resetCounters();
+ * ------------------------------
+ * Sets all of the tuning counters back to zero.
+ */
+
+   void resetCounters();
+
+#include "private/bloomfilterpriv.h"
+
+};
+
+#include "private/bloomfilterimpl.cpp"
+
+#endif
@@ -0,0 +1,171 @@
+/*
+ * File: boundedpqueue.h
+ * ---------------------
+ * This interface exports the <code>BoundedPriorityQueue</code> class,
+ * a priority queue that keeps only a fixed number of its best entries.
+ */
+
+#ifndef _boundedpqueue_h
+#define _boundedpqueue_h
+
+#include <functional>
+#include "error.h"
+#include "vector.h"
+
+/*
+ * Class: BoundedPriorityQueue<ValueType,PriorityType,Compare>
+ * -----------------------------------------------------------
+ * This class is a variant of <code>PriorityQueue</code> that holds at
+ * most a fixed number of entries, called its <i>bound</i>.  As long as
+ * the queue is not full, every entry is accepted.  Once it is full, a
+ * new entry is kept only if it has a higher priority than the worst
+ * entry in the queue, which is then discarded.  As in
+ * <code>PriorityQueue</code>, lower priority numbers correspond to
+ * higher priorities, and entries with equal priorities are ranked in
+ * the order in which they were enqueued.  The optional
+ * <code>PriorityType</code> and <code>Compare</code> parameters have
+ * the same meaning as they do for <code>PriorityQueue</code>; with
+ * <code>std::greater</code>, for example, the queue keeps the entries
+ * with the largest priorities.
+ *
+ * <p>This class makes it possible to select the best K items from a
+ * stream of any length using memory proportional to K, as in the
+ * following code:
+ *
+ *<pre>
+ *    BoundedPriorityQueue<string> best(10);
+ *    while (getline(infile, line)) {
+ *       best.enqueue(line, score(line));
+ *    }
+ *    Vector<string> results = best.drainSorted();
+ *</pre>
+ */
+
+template <typename ValueType,
+          typename PriorityType = double,
+          typename Compare = std::less<PriorityType> >
+class BoundedPriorityQueue {
+
+public:
+
+/*
+ * Constructor: BoundedPriorityQueue
+ * Usage: BoundedPriorityQueue<ValueType> pq(bound);
+ * -------------------------------------------------
+ * Initializes a new empty queue that holds at most <code>bound</code>
+ * entries.  All of the storage for the queue is allocated here.
+ */
+
+   explicit BoundedPriorityQueue(int bound);
+
+/*
+ * Destructor: ~BoundedPriorityQueue
+ * Usage: (usually implicit)
+ * -------------------------
+ * Frees any heap storage associated with this queue.
+ */
+
+   ~BoundedPriorityQueue();
+
+/*
+ * Method: size
+ * Usage: int n = pq.size();
+ * -------------------------
+ * Returns the number of values in the queue.
+ */
+
+   int size() const;
+
+/*
+ * Method: isEmpty
+ * Usage: if (pq.isEmpty()) . . .
+ * ------------------------------
+ * Returns <code>true</code> if the queue contains no elements.
+ */
+
+   bool isEmpty() const;
+
+/*
+ * Method: isFull
+ * Usage: if (pq.isFull()) . . .
+ * -----------------------------
+ * Returns <code>true</code> if the queue contains as many elements as
+ * its bound allows.
+ */
+
+   bool isFull() const;
+
+/*
+ * Method: getBound
+ * Usage: int k = pq.getBound();
+ * -----------------------------
+ * Returns the maximum number of entries the queue can hold.
+ */
+
+   int getBound() const;
+
+/*
+ * Method: clear
+ * Usage: pq.clear();
+ * ------------------
+ * Removes all elements from the queue.
+ */
+
+   void clear();
+
+/*
+ * Method: enqueue
+ * Usage: pq.enqueue(value, priority);
+ *        if (pq.enqueue(value, priority)) . . .
+ * ---------------------------------------------
+ * Offers <code>value</code> to the queue with the specified priority.
+ * If the queue is full and the new entry does not rank ahead of the
+ * worst entry, the queue is unchanged and <code>enqueue</code> returns
+ * <code>false</code> after a single comparison.  Otherwise, the entry
+ * is added, displacing the worst entry if necessary, and the method
+ * returns <code>true</code>.
+ */
+
+   bool enqueue(ValueType value, const PriorityType & priority);
+
+/*
+ * Method: peekWorst
+ * Usage: ValueType last = pq.peekWorst();
+ * ---------------------------------------
+ * Returns the lowest-ranked value in the queue without removing it.
+ * When the queue is full, this is the value that the next accepted
+ * entry will displace.
+ */
+
+   ValueType peekWorst() const;
+
+/*
+ * Method: worstPriority
+ * Usage: PriorityType threshold = pq.worstPriority();
+ * ---------------------------------------------------
+ * Returns the priority of the lowest-ranked value in the queue.  When
+ * the queue is full, a new entry must rank strictly ahead of this
+ * priority in order to be accepted, which allows clients to skip
+ * the work of computing values that cannot qualify.
+ */
+
+   PriorityType worstPriority() const;
+
+/*
+ * Method: drainSorted
+ * Usage: Vector<ValueType> vec = pq.drainSorted();
+ * ------------------------------------------------
+ * Removes every entry from the queue and returns the values in the
+ * order in which a <code>PriorityQueue</code> would dequeue them, so
+ * that the highest-priority value comes first.
+ */
+
+   Vector<ValueType> drainSorted();
+
+#include "private/boundedpqueuepriv.h"
+
+};
+
+#include "private/boundedpqueueimpl.cpp"
+
+#endif
@@ -0,0 +1,191 @@
+/*
+ * File: edgelist.h
+ * ----------------
+ * This interface exports the <code>EdgeList</code> class, which reads
+ * the arcs of a large graph from a file and adds them to a
+ * <code>Graph</code>.
+ */
+
+#ifndef _edgelist_h
+#define _edgelist_h
+
+#include <climits>
+#include <cstdio>
+#include <stdint.h>
+#include <string>
+#include "error.h"
+#include "graph.h"
+#include "strlib.h"
+#include "symboltable.h"
+#include "threadpool.h"
+#include "vector.h"
+
+/*
+ * Class: EdgeList
+ * ---------------
+ * This class holds a list of arcs in compact form: the names of the
+ * nodes are stored once each in a <code>SymbolTable</code>, and the
+ * arcs are stored in parallel arrays of node ids and weights.  An edge
+ * list can be read from a text file, in which each line describes one
+ * arc as
+ *
+ *<pre>
+ *    start finish [weight]
+ *</pre>
+ *
+ * or from a binary file written by <code>writeBinary</code>, which
+ * loads much faster.  The <code>addToGraph</code> method then creates
+ * the nodes and arcs in a <code>Graph</code>.
+ *
+ * <p>In a text file, the fields are separated by spaces or tabs, the
+ * weight is optional and defaults to 1, and blank lines and lines
+ * beginning with <code>#</code> are ignored.  The text is read in large
+ * blocks, and each block is divided among the threads of a
+ * <code>ThreadPool</code>, which parse their lines and look up the
+ * names in tables of their own.  The results are then merged so that
+ * the node ids and the order of the arcs are exactly those that a
+ * single thread would produce: the ids are assigned in the order in
+ * which the names first appear in the file, and the arcs are listed
+ * in the order of their lines.
+ */
+
+class EdgeList {
+
+public:
+
+/*
+ * Constructor: EdgeList
+ * Usage: EdgeList edges;
+ * ----------------------
+ * Initializes a new empty edge list.
+ */
+
+   EdgeList();
+
+/*
+ * Destructor: ~EdgeList
+ * Usage: (usually implicit)
+ * -------------------------
+ * Frees any heap storage associated with this edge list.
+ */
+
+   ~EdgeList();
+
+/*
+ * Method: read
+ * Usage: edges.read(filename);
+ * ----------------------------
+ * Replaces the contents of the edge list with the arcs in the file,
+ * which may be in either the text or the binary format.  The method
+ * checks the first bytes of the file to decide which format it is.
+ */
+
+   void read(const std::string & filename);
+
+/*
+ * Method: readText
+ * Usage: edges.readText(filename);
+ *        edges.readText(filename, pool);
+ * --------------------------------------
+ * Replaces the contents of the edge list with the arcs in a text
+ * file, using the threads in <code>pool</code> or, if it is omitted,
+ * in the pool returned by <code>getDefaultThreadPool</code>.  If a
+ * line cannot be parsed, this method signals an error that gives the
+ * line number.
+ */
+
+   void readText(const std::string & filename);
+   void readText(const std::string & filename, ThreadPool & pool);
+
+/*
+ * Methods: readBinary, writeBinary
+ * Usage: edges.readBinary(filename);
+ *        edges.writeBinary(filename);
+ * -----------------------------------
+ * These methods read and write the binary format, which consists of a
+ * short header, the node names, and the arrays of node ids and
+ * weights exactly as they are stored in memory.  The numbers are
+ * written in the byte order of the machine that writes the file.
+ */
+
+   void readBinary(const std::string & filename);
+   void writeBinary(const std::string & filename) const;
+
+/*
+ * Methods: size, getNodeCount
+ * Usage: int nArcs = edges.size();
+ *        int nNodes = edges.getNodeCount();
+ * -----------------------------------------
+ * These methods return the number of arcs in the list and the number
+ * of distinct node names.
+ */
+
+   int size() const;
+   int getNodeCount() const;
+
+/*
+ * Method: clear
+ * Usage: edges.clear();
+ * ---------------------
+ * Removes all arcs and names from the list.
+ */
+
+   void clear();
+
+/*
+ * Method: getNames
+ * Usage: const SymbolTable & names = edges.getNames();
+ * ----------------------------------------------------
+ * Returns the table of node names, which gives the name that goes with
+ * each node id.
+ */
+
+   const SymbolTable & getNames() const;
+
+/*
+ * Methods: getStart, getFinish, getWeight, hasWeights
+ * Usage: int start = edges.getStart(i);
+ *        int finish = edges.getFinish(i);
+ *        double weight = edges.getWeight(i);
+ *        if (edges.hasWeights()) . . .
+ * ----------------------------------------
+ * These methods return the ids of the nodes at the ends of arc
+ * <code>i</code> and its weight.  The <code>hasWeights</code> method
+ * returns <code>true</code> if any line of the file gave a weight.
+ */
+
+   int getStart(int i) const;
+   int getFinish(int i) const;
+   double getWeight(int i) const;
+   bool hasWeights() const;
+
+/*
+ * Method: addToGraph
+ * Usage: edges.addToGraph(g);
+ *        edges.addToGraph(g, setWeight);
+ * --------------------------------------
+ * Adds the nodes and arcs in the list to the graph <code>g</code>.
+ * Names that already belong to nodes in the graph refer to those
+ * nodes; the others become new nodes.  If <code>setWeight</code> is
+ * supplied, it is called as <code>setWeight(arc,&nbsp;weight)</code>
+ * for each new arc so that the client can store the weight in its
+ * <code>ArcType</code>.  Each name is looked up once, and the arcs are
+ * added together by the <code>addArcs</code> method of the graph,
+ * which uses the ids in the list directly if the graph was empty.
+ * Turning on arena allocation in the graph first makes both adding the
+ * arcs and freeing them later considerably faster.
+ */
+
+   template <typename NodeType,typename ArcType>
+   void addToGraph(Graph<NodeType,ArcType> & g) const;
+
+   template <typename NodeType,typename ArcType,typename WeightSetter>
+   void addToGraph(Graph<NodeType,ArcType> & g, WeightSetter setWeight) const;
+
+#include "private/edgelistpriv.h"
+
+};
+
+#include "private/edgelistimpl.cpp"
+
+#endif
@@ -0,0 +1,181 @@
+/*
+ * File: frozengraph.h
+ * -------------------
+ * This interface exports the <code>FrozenGraph</code> class, an
+ * immutable snapshot of a <code>Graph</code> stored in a compact form
+ * that can be traversed quickly.
+ */
+
+#ifndef _frozengraph_h
+#define _frozengraph_h
+
+#include <stdint.h>
+#include "error.h"
+#include "graph.h"
+
+/*
+ * Class: FrozenGraph<NodeType,ArcType>
+ * ------------------------------------
+ * This class holds a copy of the structure of a graph in
+ * <i>compressed sparse row</i> form.  Each node is given a dense
+ * integer <i>id</i> from 0 to <code>size()&nbsp;-&nbsp;1</code>, in
+ * the order in which the graph's node set lists the nodes.  The arcs
+ * are numbered so that the arcs leaving node <code>id</code> are
+ * those from <code>offsets[id]</code> up to but not including
+ * <code>offsets[id&nbsp;+&nbsp;1]</code>, and the node at the end of
+ * arc <code>i</code> is <code>targets[i]</code>.  A loop over the
+ * neighbors of a node is therefore a loop over consecutive elements
+ * of an array:
+ *
+ *<pre>
+ *    const int *offsets = fg.getOutOffsets();
+ *    const int *targets = fg.getOutTargets();
+ *    for (int i = offsets[id]; i < offsets[id + 1]; i++) {
+ *       int neighbor = targets[i];
+ *       . . .
+ *    }
+ *</pre>
+ *
+ * <p>A second index, built the same way, lists the arcs that enter
+ * each node.  The snapshot keeps pointers to the original nodes and
+ * arcs, so clients can map ids back to <code>NodeType</code> and
+ * <code>ArcType</code> objects, but it does not change when the graph
+ * changes.  Because a snapshot is never modified after it is built,
+ * any number of threads may read it at the same time.
+ */
+
+template <typename NodeType,typename ArcType>
+class FrozenGraph {
+
+public:
+
+/*
+ * Constructor: FrozenGraph
+ * Usage: FrozenGraph<NodeType,ArcType> fg;
+ *        FrozenGraph<NodeType,ArcType> fg(g);
+ *        FrozenGraph<NodeType,ArcType> fg(g, weightFn);
+ * -----------------------------------------------------
+ * Creates a snapshot of the graph <code>g</code>.  If the
+ * <code>weightFn</code> argument is supplied, the snapshot also stores
+ * the value of <code>weightFn(arc)</code> as the weight of each arc.
+ * The argument may be a function that takes an <code>ArcType *</code>
+ * and returns a <code>double</code>, or any object that can be called
+ * like one.  The default constructor creates an empty snapshot.
+ */
+
+   FrozenGraph();
+   explicit FrozenGraph(Graph<NodeType,ArcType> & g);
+
+   template <typename WeightFunction>
+   FrozenGraph(Graph<NodeType,ArcType> & g, WeightFunction weightFn);
+
+/*
+ * Destructor: ~FrozenGraph
+ * Usage: (usually implicit)
+ * -------------------------
+ * Frees the arrays in the snapshot.  The nodes and arcs themselves
+ * belong to the graph and are not freed.
+ */
+
+   ~FrozenGraph();
+
+/*
+ * Methods: size, getArcCount
+ * Usage: int nNodes = fg.size();
+ *        int nArcs = fg.getArcCount();
+ * ------------------------------------
+ * These methods return the number of nodes and arcs in the snapshot.
+ */
+
+   int size() const;
+   int getArcCount() const;
+
+/*
+ * Methods: getNode, getId, containsNode
+ * Usage: NodeType *node = fg.getNode(id);
+ *        int id = fg.getId(node);
+ *        if (fg.containsNode(node)) . . .
+ * ---------------------------------------
+ * These methods translate between node ids and node pointers.  The
+ * <code>getId</code> method uses a hash table and takes constant time
+ * on average.  It signals an error if the node is not in the
+ * snapshot, which <code>containsNode</code> can check in advance.
+ */
+
+   NodeType *getNode(int id) const;
+   int getId(NodeType *node) const;
+   bool containsNode(NodeType *node) const;
+
+/*
+ * Methods: getOutDegree, getInDegree
+ * Usage: int degree = fg.getOutDegree(id);
+ * ----------------------------------------
+ * These methods return the number of arcs that leave or enter the
+ * node with the specified id.
+ */
+
+   int getOutDegree(int id) const;
+   int getInDegree(int id) const;
+
+/*
+ * Methods: getOutOffsets, getOutTargets, getOutWeights
+ * Usage: const int *offsets = fg.getOutOffsets();
+ *        const int *targets = fg.getOutTargets();
+ *        const double *weights = fg.getOutWeights();
+ * -------------------------------------------------
+ * These methods return the arrays that make up the outgoing index.
+ * The offsets array has <code>size()&nbsp;+&nbsp;1</code> elements;
+ * the targets and weights arrays have one element for each arc.  If
+ * the snapshot was built without a weight function,
+ * <code>getOutWeights</code> returns <code>NULL</code>.
+ */
+
+   const int *getOutOffsets() const;
+   const int *getOutTargets() const;
+   const double *getOutWeights() const;
+
+/*
+ * Methods: getInOffsets, getInSources, getInArcs
+ * Usage: const int *offsets = fg.getInOffsets();
+ *        const int *sources = fg.getInSources();
+ *        const int *arcs = fg.getInArcs();
+ * --------------------------------------------
+ * These methods return the arrays that make up the incoming index.
+ * The arcs that enter node <code>id</code> occupy the positions from
+ * <code>offsets[id]</code> up to <code>offsets[id&nbsp;+&nbsp;1]</code>;
+ * for each position <code>i</code>, <code>sources[i]</code> is the id
+ * of the node at which the arc starts and <code>arcs[i]</code> is the
+ * number of the arc in the outgoing index.  Within each node, the
+ * incoming arcs are sorted by the id of their start node.
+ */
+
+   const int *getInOffsets() const;
+   const int *getInSources() const;
+   const int *getInArcs() const;
+
+/*
+ * Methods: getArc, getStart, getTarget, getWeight
+ * Usage: ArcType *arc = fg.getArc(i);
+ *        int start = fg.getStart(i);
+ *        int finish = fg.getTarget(i);
+ *        double weight = fg.getWeight(i);
+ * ---------------------------------------
+ * These methods return information about the arc whose number in the
+ * outgoing index is <code>i</code>.  If the snapshot has no weights,
+ * <code>getWeight</code> returns 1.  The <code>getStart</code> method
+ * uses binary search on the offsets array and so takes time
+ * proportional to the logarithm of the number of nodes.
+ */
+
+   ArcType *getArc(int i) const;
+   int getStart(int i) const;
+   int getTarget(int i) const;
+   double getWeight(int i) const;
+
+#include "private/frozengraphpriv.h"
+
+};
+
+#include "private/frozengraphimpl.cpp"
+
+#endif
@@ -9,10 +9,17 @@
 #ifndef _graph_h
 #define _graph_h
 
+#include <algorithm>
+#include <stdint.h>
 #include <string>
+#include "arena.h"
 #include "error.h"
 #include "map.h"
+#include "private/atomic.h"
 #include "set.h"
+#include "strlib.h"
+#include "symboltable.h"
+#include "vector.h"
 
 /*
  * Function: nodeCompare
@@ -32,6 +39,11 @@ int nodeCompare(NodeType *n1, NodeType *n2);
 template <typename NodeType,typename ArcType>
 int arcCompare(ArcType *a1, ArcType *a2);
 
+/* Forward reference to the snapshot class defined in frozengraph.h */
+
+template <typename NodeType,typename ArcType>
+class FrozenGraph;
+
 /*
  * Class: Graph<NodeType,ArcType>
  * ------------------------------
@@ -56,6 +68,9 @@ class Graph {
 
 public:
 
+/* Forward references */
+   class NeighborView;
+
 /*
  * Constructor: Graph
  * Usage: Graph<NodeType,ArcType> g;
@@ -113,7 +128,7 @@ public:
  * method return a pointer to the node.
  */
 
-   NodeType *addNode(std::string name);
+   NodeType *addNode(const std::string & name);
    NodeType *addNode(NodeType *node);
 
 /*
@@ -123,22 +138,35 @@ public:
  * --------------------------
  * Removes a node from the graph, where the node can be specified
  * either by its name or as a pointer value.  Removing a node also
- * removes all arcs that contain that node.
+ * removes all arcs that contain that node.  The graph keeps track of
+ * the arcs that end at each node as well as those that start there, so
+ * this method takes time proportional to the number of arcs that touch
+ * the node rather than the number of arcs in the graph.  If the node
+ * or any of its arcs came from the arena of the graph, as described
+ * under <code>setArenaAllocation</code>, the graph returns them to the
+ * arena, and the client must not use pointers to them afterward.  The
+ * graph does not free any other node or arc that it removes, which
+ * the client remains free to delete or to add to a graph again.
  */
 
-   void removeNode(std::string name);
+   void removeNode(const std::string & name);
    void removeNode(NodeType *node);
 
 /*
  * Method: getNode
  * Usage: NodeType *node = g.getNode(name);
+ *        NodeType *node = g.getNode(id);
  * ----------------------------------------
  * Looks up a node in the name table attached to the graph and
- * returns a pointer to that node.  If no node with the specified
- * name exists, <code>getNode</code> signals an error.
+ * returns a pointer to that node.  The node can be specified either
+ * by its name or by its id, as described under <code>getNodeId</code>.
+ * If no node with the specified name or id exists, <code>getNode</code>
+ * signals an error.  The name table is a hash table, so looking up a
+ * name takes constant time on average.
  */
 
-   NodeType *getNode(std::string name);
+   NodeType *getNode(const std::string & name);
+   NodeType *getNode(int id);
 
 /*
  * Method: nodeExists
@@ -147,54 +175,171 @@ public:
  * Returns <code>true</code> if a node with the given name exists.
  */
 
-   bool nodeExists(std::string name);
+   bool nodeExists(const std::string & name);
+
+/*
+ * Method: getNodeId
+ * Usage: int id = g.getNodeId(name);
+ *        int id = g.getNodeId(node);
+ * ----------------------------------
+ * Returns the <i>id</i> of a node, which is a small integer that can be
+ * used in place of the name in any method that takes a node name.  The
+ * graph assigns ids consecutively from 0 in the order in which names
+ * are first added, so clients can keep information about each node in
+ * a <code>Vector</code> or array indexed by id.  A node keeps its id
+ * until the graph is cleared.  Looking up a node by id avoids hashing
+ * its name, which makes the id forms of <code>addArc</code>,
+ * <code>removeArc</code>, and <code>isConnected</code> the fastest way
+ * to refer to nodes that the client has already looked up.  These ids
+ * are not the same as those in a <code>FrozenGraph</code>, which
+ * follow the order of the node set.
+ */
+
+   int getNodeId(const std::string & name);
+   int getNodeId(NodeType *node);
 
 /*
  * Method: addArc
  * Usage: g.addArc(s1, s2);
  *        g.addArc(n1, n2);
+ *        g.addArc(id1, id2);
  *        g.addArc(arc);
- * ---------------------
+ * -----------------------
  * Adds an arc to the graph.  The endpoints of the arc can be specified
- * either as strings indicating the names of the nodes or as pointers
- * to the node structures.  Alternatively, the client can create the arc
- * structure explicitly and pass that pointer to the <code>addArc</code>
- * method.  All three of these versions return a pointer to the arc in
- * case the client needs to capture this value.
+ * as strings indicating the names of the nodes, as pointers to the
+ * node structures, or as node ids.  Alternatively, the client can
+ * create the arc structure explicitly and pass that pointer to the
+ * <code>addArc</code> method.  All of these versions return a pointer
+ * to the arc in case the client needs to capture this value.
  */
 
-   ArcType *addArc(std::string s1, std::string s2);
+   ArcType *addArc(const std::string & s1, const std::string & s2);
    ArcType *addArc(NodeType *n1, NodeType *n2);
+   ArcType *addArc(int id1, int id2);
    ArcType *addArc(ArcType *arc);
 
+/*
+ * Method: addArcs
+ * Usage: g.addArcs(ids1, ids2, n);
+ *        g.addArcs(ids1, ids2, n, arcs);
+ * --------------------------------------
+ * Adds <code>n</code> new arcs to the graph, where arc <code>i</code>
+ * starts at the node whose id is <code>ids1[i]</code> and finishes at
+ * the node whose id is <code>ids2[i]</code>.  If the <code>arcs</code>
+ * array is supplied, the pointer to each new arc is stored in the
+ * corresponding element.  The graph creates the arcs itself, using its
+ * arena if arena allocation is on.  Rather than inserting the arcs into
+ * the arc sets one at a time, this method sorts them and merges them
+ * into each set in a single pass, so adding a large number of arcs at
+ * once takes time proportional to the size of the graph plus
+ * <code>n&nbsp;log&nbsp;n</code>.  If any id does not belong to a
+ * node, this method signals an error before adding any arcs.
+ */
+
+   void addArcs(const int *ids1, const int *ids2, int n,
+                ArcType **arcs = NULL);
+
 /*
  * Method: removeArc
  * Usage: g.removeArc(s1, s2);
  *        g.removeArc(n1, n2);
+ *        g.removeArc(id1, id2);
  *        g.removeArc(arc);
- * ------------------------
+ * --------------------------
  * Removes an arc from the graph, where the arc can be specified in any
- * of three ways: by the names of its endpoints, by the node pointers
- * at its endpoints, or as an arc pointer.  If more than one arc
- * connects the specified endpoints, all of them are removed.
+ * of four ways: by the names of its endpoints, by the node pointers or
+ * node ids at its endpoints, or as an arc pointer.  If more than one arc
+ * connects the specified endpoints, all of them are removed.  As with
+ * <code>removeNode</code>, an arc that came from the arena of the graph
+ * goes back to the arena, but any other arc is left for the client to
+ * free.  Removing an arc takes constant time apart from the cost of
+ * removing it from the arc sets.
  */
 
-   void removeArc(std::string s1, std::string s2);
+   void removeArc(const std::string & s1, const std::string & s2);
    void removeArc(NodeType *n1, NodeType *n2);
+   void removeArc(int id1, int id2);
    void removeArc(ArcType *arc);
 
 /*
  * Method: isConnected
  * Usage: if (g.isConnected(n1, n2)) . . .
  *        if (g.isConnected(s1, s2)) . . .
- * ---------------------------------------
+ *        if (g.isConnected(id1, id2)) . . .
+ * -----------------------------------------
  * Returns <code>true</code> if the graph contains an arc from
  * <code>n1</code> to <code>n2</code>.  As in the <code>addArc</code>
- * method, nodes can be specified either as node pointers or by name.
+ * method, nodes can be specified as node pointers, by name, or by id.
+ * This method takes time proportional to the number of arcs leaving
+ * <code>n1</code> unless the adjacency index is enabled, in which case
+ * it takes constant time on average.
  */
 
    bool isConnected(NodeType *n1, NodeType *n2);
-   bool isConnected(std::string s1, std::string s2);
+   bool isConnected(const std::string & s1, const std::string & s2);
+   bool isConnected(int id1, int id2);
+
+/*
+ * Methods: setAdjacencyIndex, hasAdjacencyIndex
+ * Usage: g.setAdjacencyIndex(true);
+ *        if (g.hasAdjacencyIndex()) . . .
+ * ---------------------------------------
+ * Turns the adjacency index on or off and reports whether it is on.
+ * The index is a hash table that records which pairs of nodes are
+ * connected by at least one arc, which makes <code>isConnected</code>
+ * run in constant time.  Keeping the index up to date adds a small
+ * cost to <code>addArc</code> and <code>removeArc</code> and uses
+ * additional memory in proportion to the number of arcs, so it is
+ * off by default.  Copies of a graph have the index if the original
+ * does.
+ */
+
+   void setAdjacencyIndex(bool flag);
+   bool hasAdjacencyIndex();
+
+/*
+ * Methods: setArenaAllocation, hasArenaAllocation
+ * Usage: g.setArenaAllocation(true);
+ *        if (g.hasArenaAllocation()) . . .
+ * ----------------------------------------
+ * Turns arena allocation on or off and reports whether it is on.  When
+ * it is on, the nodes and arcs that the graph creates itself come from
+ * a pair of <code>Arena</code> objects belonging to the graph rather
+ * than from individual calls to <code>new</code>.  The arenas allocate
+ * memory in a few large slabs and release it all at once, which makes
+ * building a large graph and then clearing or destroying it much
+ * faster.  Nodes and arcs that the client creates and passes to
+ * <code>addNode</code> or <code>addArc</code> must still be allocated
+ * with <code>new</code>, and the graph deletes them as usual.  Turning
+ * the mode off affects only objects created afterward.  Copies of a
+ * graph use arena allocation if the original does.
+ */
+
+   void setArenaAllocation(bool flag);
+   bool hasArenaAllocation();
+
+/*
+ * Methods: setCopyOnWrite, isCopyOnWrite
+ * Usage: g.setCopyOnWrite(true);
+ *        if (g.isCopyOnWrite()) . . .
+ * -----------------------------------
+ * Turns copy-on-write sharing on or off and reports whether it is on.
+ * When it is on, copying the graph takes constant time, because the
+ * copy shares the nodes and arcs of the original.  The first graph to
+ * change through one of the methods that add or remove nodes or arcs,
+ * <code>clear</code>, or <code>setAdjacencyIndex</code> then makes its
+ * own copy of everything before making the change.  Node and arc
+ * pointers passed to that method are converted to refer to the new
+ * copies, but pointers the client obtained earlier still refer to the
+ * nodes and arcs of the other graphs.  Changes that the client makes
+ * directly to the fields of a node or arc are visible in every graph
+ * that shares it, and the sets returned by <code>getNodeSet</code> and
+ * <code>getArcSet</code> must not be modified.  Copies of a graph
+ * share its data if the original does.
+ */
+
+   void setCopyOnWrite(bool flag);
+   bool isCopyOnWrite();
 
 /*
  * Method: getNodeSet
@@ -210,15 +355,17 @@ public:
  * Usage: foreach (ArcType *arc in g.getArcSet()) . . .
  *        foreach (ArcType *arc in g.getArcSet(node)) . . .
  *        foreach (ArcType *arc in g.getArcSet(name)) . . .
+ *        foreach (ArcType *arc in g.getArcSet(id)) . . .
  * --------------------------------------------------------
- * Returns the set of all arcs in the graph or, in the second and
- * third forms, the arcs that start at the specified node, which
- * can be indicated either as a pointer or by name.
+ * Returns the set of all arcs in the graph or, in the other forms,
+ * the arcs that start at the specified node, which can be indicated
+ * as a pointer, by name, or by id.
  */
 
    Set<ArcType *> & getArcSet();
    Set<ArcType *> & getArcSet(NodeType *node);
-   Set<ArcType *> & getArcSet(std::string name);
+   Set<ArcType *> & getArcSet(const std::string & name);
+   Set<ArcType *> & getArcSet(int id);
 
 /*
  * Method: getNeighbors
@@ -230,12 +377,48 @@ public:
  */
 
    Set<NodeType *> getNeighbors(NodeType *node);
-   Set<NodeType *> getNeighbors(std::string node);
+   Set<NodeType *> getNeighbors(const std::string & node);
+
+/*
+ * Method: neighbors
+ * Usage: foreach (NodeType *neighbor in g.neighbors(node)) . . .
+ * --------------------------------------------------------------
+ * Returns a lightweight view of the nodes at the ends of the arcs that
+ * leave <code>node</code>.  Unlike <code>getNeighbors</code>, this
+ * method does not build a new set.  The view refers directly to the
+ * arc set of the node, and its iterator produces the finish node of
+ * each arc as it advances, so a loop that uses the iterator explicitly
+ * allocates no memory.  A neighbor appears once for each arc that
+ * leads to it, in the order of the arc set.  The arcs leaving
+ * <code>node</code> must not change while the view is in use.
+ */
+
+   NeighborView neighbors(NodeType *node);
+
+/*
+ * Method: freeze
+ * Usage: FrozenGraph<NodeType,ArcType> fg = g.freeze();
+ *        FrozenGraph<NodeType,ArcType> fg = g.freeze(weightFn);
+ * -------------------------------------------------------------
+ * Returns an immutable snapshot of the graph in which the nodes are
+ * numbered consecutively and the arcs are stored in flat arrays, as
+ * described in <code>frozengraph.h</code>.  Algorithms that visit many
+ * nodes run much faster on the snapshot than on the graph itself.  If
+ * <code>weightFn</code> is supplied, the snapshot also records
+ * <code>weightFn(arc)</code> for each arc.  Changes made to the graph
+ * after the call have no effect on the snapshot.
+ */
+
+   FrozenGraph<NodeType,ArcType> freeze();
+
+   template <typename WeightFunction>
+   FrozenGraph<NodeType,ArcType> freeze(WeightFunction weightFn);
 
 #include "private/graphpriv.h"
 
 };
 
 #include "private/graphimpl.cpp"
+#include "frozengraph.h"
 
 #endif
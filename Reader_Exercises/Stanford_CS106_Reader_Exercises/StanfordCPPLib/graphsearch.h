@@ -0,0 +1,200 @@
+/*
+ * File: graphsearch.h
+ * -------------------
+ * This interface exports the <code>GraphSearch</code> class, which
+ * runs breadth-first search, Dijkstra's algorithm, and A* search on a
+ * <code>Graph</code>, along with functions for topological sorting and
+ * for finding strongly connected components.
+ */
+
+#ifndef _graphsearch_h
+#define _graphsearch_h
+
+#include <climits>
+#include <string>
+#include "error.h"
+#include "frozengraph.h"
+#include "graph.h"
+#include "pqueue.h"
+#include "vector.h"
+
+/*
+ * Class: GraphSearch<NodeType,ArcType>
+ * ------------------------------------
+ * This class searches a snapshot of a graph, which it makes with
+ * <code>freeze</code> when it is constructed.  Each node is referred to
+ * internally by its id in the snapshot, and the distances, parent
+ * links, and search state are kept in flat arrays indexed by id.  The
+ * priority queue is an <i>indexed heap,</i> which records the position
+ * of each node so that a shorter distance can be recorded by moving
+ * the node's existing entry rather than adding another one.  The
+ * arrays are allocated once and reused by every search, so a search
+ * allocates memory only for the path it returns.
+ *
+ * <p>The results of the most recent search are available through
+ * <code>isReachable</code>, <code>getDistance</code>, and
+ * <code>getPath</code>.  Because the search works on a snapshot,
+ * changes to the graph after the <code>GraphSearch</code> object is
+ * created are not seen by the search.
+ */
+
+template <typename NodeType,typename ArcType>
+class GraphSearch {
+
+public:
+
+/*
+ * Constructor: GraphSearch
+ * Usage: GraphSearch<NodeType,ArcType> search(g);
+ *        GraphSearch<NodeType,ArcType> search(g, weightFn);
+ *        GraphSearch<NodeType,ArcType> search(fg);
+ * -----------------------------------------------------
+ * Creates a search object for the graph <code>g</code>.  The length of
+ * each arc is <code>weightFn(arc)</code> if a weight function is
+ * supplied and 1 otherwise.  The weight function may be an ordinary
+ * function that takes an <code>ArcType *</code> and returns a
+ * <code>double</code>, or any object that can be called like one.  The
+ * third form searches a copy of an existing snapshot.
+ */
+
+   explicit GraphSearch(Graph<NodeType,ArcType> & g);
+
+   template <typename WeightFunction>
+   GraphSearch(Graph<NodeType,ArcType> & g, WeightFunction weightFn);
+
+   explicit GraphSearch(const FrozenGraph<NodeType,ArcType> & fg);
+
+/*
+ * Destructor: ~GraphSearch
+ * Usage: (usually implicit)
+ * -------------------------
+ * Frees the storage used by the search.
+ */
+
+   ~GraphSearch();
+
+/*
+ * Method: breadthFirstSearch
+ * Usage: search.breadthFirstSearch(start);
+ * ----------------------------------------
+ * Visits every node that can be reached from <code>start</code> in
+ * breadth-first order.  Afterward, <code>getDistance</code> returns
+ * the number of arcs on the shortest path to each node, ignoring
+ * weights.
+ */
+
+   void breadthFirstSearch(NodeType *start);
+
+/*
+ * Method: dijkstra
+ * Usage: search.dijkstra(start);
+ * ------------------------------
+ * Uses Dijkstra's algorithm to find the shortest path from
+ * <code>start</code> to every node that can be reached from it.  All
+ * weights must be nonnegative.
+ */
+
+   void dijkstra(NodeType *start);
+
+/*
+ * Method: findShortestPath
+ * Usage: Vector<ArcType *> path = search.findShortestPath(start, finish);
+ *        Vector<ArcType *> path = search.findShortestPath(start, finish, h);
+ * --------------------------------------------------------------------------
+ * Returns the arcs on a shortest path from <code>start</code> to
+ * <code>finish</code>, or an empty vector if there is no such path.
+ * The first form runs Dijkstra's algorithm and stops as soon as the
+ * distance to <code>finish</code> is known.  The second runs A* search,
+ * which uses <code>h(node,&nbsp;finish)</code> as an estimate of the
+ * distance from <code>node</code> to <code>finish</code> and explores
+ * the nodes that look closest to the goal first.  The estimate must
+ * never be larger than the true distance; if it is, the path may not
+ * be the shortest one.  Because these methods stop early, the results
+ * they leave behind are exact only for <code>finish</code>.
+ */
+
+   Vector<ArcType *> findShortestPath(NodeType *start, NodeType *finish);
+
+   template <typename HeuristicFunction>
+   Vector<ArcType *> findShortestPath(NodeType *start, NodeType *finish,
+                                      HeuristicFunction h);
+
+/*
+ * Methods: isReachable, getDistance
+ * Usage: if (search.isReachable(node)) . . .
+ *        double dist = search.getDistance(node);
+ * ----------------------------------------------
+ * These methods report the results of the most recent search.
+ * <code>isReachable</code> returns <code>true</code> if the search
+ * reached <code>node</code>, and <code>getDistance</code> returns the
+ * length of the shortest path to it, or -1 if there is none.
+ */
+
+   bool isReachable(NodeType *node);
+   double getDistance(NodeType *node);
+
+/*
+ * Method: getPath
+ * Usage: Vector<ArcType *> path = search.getPath(node);
+ * -----------------------------------------------------
+ * Returns the arcs on the path that the most recent search found from
+ * its start node to <code>node</code>, or an empty vector if the
+ * search did not reach it.
+ */
+
+   Vector<ArcType *> getPath(NodeType *node);
+
+/*
+ * Method: getSnapshot
+ * Usage: const FrozenGraph<NodeType,ArcType> & fg = search.getSnapshot();
+ * -----------------------------------------------------------------------
+ * Returns the snapshot on which the searches run.
+ */
+
+   const FrozenGraph<NodeType,ArcType> & getSnapshot() const;
+
+#include "private/graphsearchpriv.h"
+
+};
+
+/*
+ * Function: topologicalSort
+ * Usage: Vector<NodeType *> order = topologicalSort(g);
+ * -----------------------------------------------------
+ * Returns the nodes of <code>g</code> in an order in which every arc
+ * leads from an earlier node to a later one.  Among the nodes that
+ * could come next, the one that appears first in the node set is
+ * chosen, so the result is the same each time.  This function signals
+ * an error if the graph contains a cycle.  The argument may also be a
+ * <code>FrozenGraph</code>.
+ */
+
+template <typename NodeType,typename ArcType>
+Vector<NodeType *> topologicalSort(Graph<NodeType,ArcType> & g);
+
+template <typename NodeType,typename ArcType>
+Vector<NodeType *> topologicalSort(const FrozenGraph<NodeType,ArcType> & fg);
+
+/*
+ * Function: stronglyConnectedComponents
+ * Usage: Vector< Vector<NodeType *> > sccs = stronglyConnectedComponents(g);
+ * --------------------------------------------------------------------------
+ * Divides the nodes of <code>g</code> into <i>strongly connected
+ * components,</i> which are the largest sets of nodes in which every
+ * node can reach every other.  The function uses Tarjan's algorithm,
+ * which finds the components in reverse topological order: no arc
+ * leads from a component to one that appears earlier in the result.
+ * The argument may also be a <code>FrozenGraph</code>.
+ */
+
+template <typename NodeType,typename ArcType>
+Vector< Vector<NodeType *> >
+   stronglyConnectedComponents(Graph<NodeType,ArcType> & g);
+
+template <typename NodeType,typename ArcType>
+Vector< Vector<NodeType *> >
+   stronglyConnectedComponents(const FrozenGraph<NodeType,ArcType> & fg);
+
+#include "private/graphsearchimpl.cpp"
+
+#endif
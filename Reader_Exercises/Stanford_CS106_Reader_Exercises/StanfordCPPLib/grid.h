@@ -11,6 +11,7 @@
 
 #include "error.h"
 #include "foreach.h"
+#include "private/atomic.h"
 #include "strlib.h"
 
 /*
@@ -37,8 +38,9 @@ class Grid {
 
 public:
 
-/* Forward reference */
+/* Forward references */
    class GridRow;
+   class RowView;
 
 /*
  * Constructor: Grid
@@ -111,11 +113,104 @@ public:
  * This extension enables the use of traditional array notation to
  * get or set individual elements.  This method signals an error if
  * the <code>row</code> and <code>col</code> arguments are outside
- * the grid boundaries.
+ * the grid boundaries.  Loops that need to avoid the check on every
+ * element can use <code>rowPtr</code> or <code>row</code> instead.
  */
 
    GridRow operator[](int row);
 
+/*
+ * Method: rowPtr
+ * Usage: ValueType *rp = grid.rowPtr(row);
+ * ----------------------------------------
+ * Returns a pointer to the first element of the specified row.  The
+ * elements of a row are contiguous, so <code>rp[col]</code> selects
+ * the element in column <code>col</code>.  This method checks that
+ * <code>row</code> is in range, but no check is made on subsequent
+ * uses of the pointer.  Inner loops that step along a row can
+ * therefore run at the speed of ordinary array code.  The pointer
+ * remains valid until the grid is resized or destroyed.
+ */
+
+   ValueType *rowPtr(int row);
+   const ValueType *rowPtr(int row) const;
+
+/*
+ * Method: row
+ * Usage: Grid<ValueType>::RowView rv = grid.row(row);
+ * ---------------------------------------------------
+ * Returns a lightweight view of the specified row, which supports
+ * <code>rv.size()</code>, indexing with <code>rv[col]</code>, and the
+ * pointer-valued <code>rv.begin()</code> and <code>rv.end()</code>.
+ * Unlike the result of <code>operator[]</code>, the view may be stored
+ * in a variable and reused for a whole row.  Like
+ * <code>rowPtr</code>, it checks the row index once, when the view is
+ * created, and does not check the column indices.
+ */
+
+   RowView row(int row);
+
+/*
+ * Method: data
+ * Usage: ValueType *array = grid.data();
+ * --------------------------------------
+ * Returns a pointer to the underlying array of elements, which holds
+ * the grid in <i>row-major order.</i>  The element at
+ * <code>(row,&nbsp;col)</code> is <code>array[row * numCols() + col]</code>.
+ * The pointer remains valid until the grid is resized or destroyed.
+ */
+
+   ValueType *data();
+   const ValueType *data() const;
+
+/*
+ * Methods: setCopyOnWrite, isCopyOnWrite
+ * Usage: grid.setCopyOnWrite(true);
+ *        if (grid.isCopyOnWrite()) . . .
+ * --------------------------------------
+ * Turns copy-on-write sharing on or off and reports whether it is on.
+ * When it is on, copying the grid takes constant time: the copy shares
+ * the element array of the original until one of them is changed, at
+ * which point that grid makes its own copy of the array.  Any method
+ * that can give write access to the elements counts as a change,
+ * which includes <code>operator[]</code> and the non-constant forms of
+ * <code>rowPtr</code>, <code>row</code>, and <code>data</code>.  To
+ * read a shared grid without copying it, use a constant reference to
+ * the grid, <code>foreach</code>, or <code>mapAll</code>.  A pointer
+ * obtained before the grid is copied may refer to the array of the
+ * copy once either grid has been changed, so clients should obtain
+ * such pointers again after copying the grid.  Making the private copy
+ * is not synchronized, so a shared grid must be detached in one thread
+ * before several threads use the methods that change it.
+ */
+
+   void setCopyOnWrite(bool flag);
+   bool isCopyOnWrite() const;
+
+/*
+ * Method: fill
+ * Usage: grid.fill(value);
+ * ------------------------
+ * Stores <code>value</code> in every element of the grid.
+ */
+
+   void fill(const ValueType & value);
+
+/*
+ * Method: transform
+ * Usage: grid.transform(fn);
+ * --------------------------
+ * Replaces each element of the grid with the result of calling
+ * <code>fn</code> on that element.  The argument may be a function or
+ * any object that can be called like one.  The elements are processed
+ * in a single pass over the underlying array.  For arithmetic element
+ * types, the compiler can usually vectorize this loop if <code>fn</code>
+ * is a function object whose definition it can see.
+ */
+
+   template <typename FunctionType>
+   void transform(FunctionType fn);
+
 /*
  * Macro: foreach
  * Usage: foreach (ValueType value in grid) . . .
@@ -0,0 +1,217 @@
+/*
+ * File: gridpath.h
+ * ----------------
+ * This interface exports the <code>GridPathfinder</code> class, which
+ * finds shortest paths between cells of a grid whose values give the
+ * cost of entering each cell.
+ */
+
+#ifndef _gridpath_h
+#define _gridpath_h
+
+#include <stdint.h>
+#include "error.h"
+#include "point.h"
+#include "threadpool.h"
+#include "vector.h"
+
+/*
+ * Type: PathMoves
+ * ---------------
+ * This enumerated type specifies the moves that a path may make.
+ * <code>FOUR_CONNECTED</code> allows steps to the four horizontal and
+ * vertical neighbors of a cell.  <code>EIGHT_CONNECTED</code> also
+ * allows diagonal steps, but only when both of the cells beside the
+ * diagonal are open, so a path never cuts the corner of a wall.
+ */
+
+enum PathMoves { FOUR_CONNECTED, EIGHT_CONNECTED };
+
+/*
+ * Type: PathAlgorithm
+ * -------------------
+ * This enumerated type selects the search algorithm:
+ *
+ *<pre>
+ *    PATH_BFS       Breadth-first search, which minimizes the number of
+ *                   moves and ignores the costs of the cells
+ *    PATH_DIJKSTRA  Dijkstra's algorithm, which minimizes the total cost
+ *    PATH_ASTAR     A* search, which finds the same cost as Dijkstra's
+ *                   algorithm but is directed toward the goal
+ *    PATH_JPS       Jump point search, a form of A* for maps in which
+ *                   every open cell has the same cost
+ *</pre>
+ */
+
+enum PathAlgorithm { PATH_BFS, PATH_DIJKSTRA, PATH_ASTAR, PATH_JPS };
+
+/*
+ * Type: PathQuery
+ * ---------------
+ * This type describes one search in a batch passed to
+ * <code>findPaths</code>.
+ */
+
+struct PathQuery {
+   int startRow;
+   int startCol;
+   int goalRow;
+   int goalCol;
+};
+
+/*
+ * Type: PathResult
+ * ----------------
+ * This type holds the result of one search in a batch.  The
+ * <code>cost</code> field is -1 if the goal cannot be reached.
+ */
+
+struct PathResult {
+   double cost;
+   Vector<Point> path;
+};
+
+/*
+ * Class: GridPathfinder
+ * ---------------------
+ * This class holds a copy of a cost map, which is a grid of numbers in
+ * which each value is the cost of entering that cell.  A negative value
+ * marks a wall that cannot be entered.  A diagonal step costs the value
+ * of the cell it enters multiplied by the square root of 2.  Paths are
+ * returned as a sequence of <code>Point</code> values from the start to
+ * the goal, in which <i>x</i> is the column and <i>y</i> is the row.
+ *
+ * <p>The cost map may be any grid class that provides
+ * <code>numRows</code>, <code>numCols</code>, and <code>rowPtr</code>,
+ * which includes both the <code>Grid</code> class in
+ * <code>grid.h</code> and the older class in <code>cs106/grid.h</code>.
+ * Paths use only the <code>Vector</code> operations that the older
+ * library also provides, so this interface can be used in projects
+ * built on either one.  The map is copied into a flat array when it is
+ * loaded, and each search keeps its distances and parents in flat
+ * arrays and its visited cells in a bitmap, so a search allocates no
+ * memory once the first search on a map of that size is complete.
+ */
+
+class GridPathfinder {
+
+public:
+
+/*
+ * Constructor: GridPathfinder
+ * Usage: GridPathfinder finder;
+ *        GridPathfinder finder(costs, moves);
+ * -------------------------------------------
+ * Initializes a new pathfinder.  The second form loads the cost map
+ * from the grid <code>costs</code> and sets the allowed moves, which
+ * default to <code>FOUR_CONNECTED</code>.
+ */
+
+   GridPathfinder();
+
+   template <typename GridType>
+   explicit GridPathfinder(GridType & costs,
+                           PathMoves moves = FOUR_CONNECTED);
+
+/*
+ * Destructor: ~GridPathfinder
+ * Usage: (usually implicit)
+ * -------------------------
+ * Frees any heap storage associated with this pathfinder.
+ */
+
+   ~GridPathfinder();
+
+/*
+ * Method: setCosts
+ * Usage: finder.setCosts(costs);
+ * ------------------------------
+ * Replaces the cost map with a copy of the grid <code>costs</code>.
+ * Later changes to the grid have no effect on the pathfinder until
+ * this method is called again.
+ */
+
+   template <typename GridType>
+   void setCosts(GridType & costs);
+
+/*
+ * Methods: setMoves, getMoves
+ * Usage: finder.setMoves(EIGHT_CONNECTED);
+ * ----------------------------------------
+ * These methods set and return the moves that a path may make.
+ */
+
+   void setMoves(PathMoves moves);
+   PathMoves getMoves() const;
+
+/*
+ * Methods: numRows, numCols
+ * Usage: int nRows = finder.numRows();
+ * ------------------------------------
+ * These methods return the dimensions of the cost map.
+ */
+
+   int numRows() const;
+   int numCols() const;
+
+/*
+ * Method: isOpen
+ * Usage: if (finder.isOpen(row, col)) . . .
+ * -----------------------------------------
+ * Returns <code>true</code> if the cell is inside the map and is not
+ * a wall.
+ */
+
+   bool isOpen(int row, int col) const;
+
+/*
+ * Method: findPath
+ * Usage: double cost = finder.findPath(algorithm, startRow, startCol,
+ *                                      goalRow, goalCol, path);
+ * -------------------------------------------------------------------
+ * Searches for a path from the start cell to the goal cell using the
+ * specified algorithm.  If there is one, this method stores its cells
+ * in <code>path</code> and returns its cost, which for
+ * <code>PATH_BFS</code> is the number of moves.  If there is not,
+ * this method clears <code>path</code> and returns -1.  The start and
+ * goal must be inside the map.
+ *
+ * <p><code>PATH_JPS</code> requires every open cell to have the same
+ * cost and signals an error if they do not.  With
+ * <code>FOUR_CONNECTED</code> moves it performs an ordinary A* search.
+ *
+ * <p>This method uses working storage that belongs to the pathfinder,
+ * so two threads must not call it at the same time on the same
+ * pathfinder.  To run many searches in parallel, use
+ * <code>findPaths</code>.
+ */
+
+   double findPath(PathAlgorithm algorithm, int startRow, int startCol,
+                   int goalRow, int goalCol, Vector<Point> & path);
+
+/*
+ * Method: findPaths
+ * Usage: finder.findPaths(algorithm, queries, results, n);
+ *        finder.findPaths(algorithm, queries, results, n, pool);
+ * --------------------------------------------------------------
+ * Carries out the <code>n</code> searches in the array
+ * <code>queries</code> and stores the results in the corresponding
+ * elements of the array <code>results</code>.  The searches are divided
+ * among the threads of <code>pool</code>, which defaults to the pool
+ * returned by <code>getDefaultThreadPool</code>.  Each thread has its
+ * own working storage, and the results are the same as those from
+ * calling <code>findPath</code> for each query.
+ */
+
+   void findPaths(PathAlgorithm algorithm, const PathQuery *queries,
+                  PathResult *results, int n);
+   void findPaths(PathAlgorithm algorithm, const PathQuery *queries,
+                  PathResult *results, int n, ThreadPool & pool);
+
+#include "private/gridpathpriv.h"
+
+};
+
+#include "private/gridpathimpl.cpp"
+
+#endif
@@ -0,0 +1,198 @@
+/*
+ * File: gridstencil.h
+ * -------------------
+ * This interface exports the <code>GridStencil</code> template class,
+ * which repeatedly updates every cell of a grid from the values in a
+ * small neighborhood around that cell.  Simulations such as the Game
+ * of Life, diffusion, and image blurring all follow this pattern.
+ */
+
+#ifndef _gridstencil_h
+#define _gridstencil_h
+
+#include "error.h"
+#include "grid.h"
+#include "thread.h"
+
+/*
+ * Type: EdgePolicy
+ * ----------------
+ * This enumerated type specifies the value a stencil sees when a
+ * neighborhood extends past the edge of the grid.  <code>EDGE_CLAMP</code>
+ * repeats the nearest cell on the border, <code>EDGE_WRAP</code> treats
+ * the grid as a torus, and <code>EDGE_CONSTANT</code> supplies a fixed
+ * value chosen by the client.
+ */
+
+enum EdgePolicy { EDGE_CLAMP, EDGE_WRAP, EDGE_CONSTANT };
+
+/*
+ * Class: GridStencil<ValueType>
+ * -----------------------------
+ * This class holds a grid together with a second buffer of the same
+ * size.  Each call to <code>step</code> computes a new value for every
+ * cell by calling a client-supplied <i>kernel</i> on the neighborhood
+ * of that cell in the current buffer, writes the results into the
+ * other buffer, and then swaps the two.  No copy of the grid is made
+ * between generations.
+ *
+ * <p>The kernel is any function or function object that takes a
+ * <code>const GridStencil<ValueType>::Neighborhood &</code> and
+ * returns the new value of the cell.  The following code, for example,
+ * runs 100 generations of the Game of Life on a torus:
+ *
+ *<pre>
+ *    struct LifeRule {
+ *       char operator()(const GridStencil<char>::Neighborhood & nb) const {
+ *          int n = nb(-1, -1) + nb(-1, 0) + nb(-1, 1) + nb(0, -1)
+ *                + nb(0, 1) + nb(1, -1) + nb(1, 0) + nb(1, 1);
+ *          return (n == 3 || (n == 2 && nb.center())) ? 1 : 0;
+ *       }
+ *    };
+ *
+ *    GridStencil<char> life(board);
+ *    life.setEdgePolicy(EDGE_WRAP);
+ *    life.step(LifeRule(), 100);
+ *</pre>
+ */
+
+template <typename ValueType>
+class GridStencil {
+
+public:
+
+/* Forward reference */
+   class Neighborhood;
+
+/*
+ * Constructor: GridStencil
+ * Usage: GridStencil<ValueType> stencil(grid);
+ *        GridStencil<ValueType> stencil(grid, radius);
+ * ----------------------------------------------------
+ * Initializes a stencil whose current generation is a copy of
+ * <code>grid</code>.  The <code>radius</code> is the distance from the
+ * center to the edge of the neighborhood and must be 1, for a
+ * 3x3 neighborhood, or 2, for a 5x5 neighborhood.  The stencil
+ * starts with the <code>EDGE_CLAMP</code> policy and a single thread.
+ */
+
+   explicit GridStencil(const Grid<ValueType> & grid, int radius = 1);
+
+/*
+ * Destructor: ~GridStencil
+ * Usage: (usually implicit)
+ * -------------------------
+ * Frees any heap storage associated with this stencil.
+ */
+
+   ~GridStencil();
+
+/*
+ * Methods: numRows, numCols, getRadius
+ * Usage: int nRows = stencil.numRows();
+ * -------------------------------------
+ * These methods return the dimensions of the grid and the radius of
+ * the neighborhood.
+ */
+
+   int numRows() const;
+   int numCols() const;
+   int getRadius() const;
+
+/*
+ * Method: setEdgePolicy
+ * Usage: stencil.setEdgePolicy(policy);
+ *        stencil.setEdgePolicy(EDGE_CONSTANT, value);
+ * ---------------------------------------------------
+ * Sets the policy used for neighbors outside the grid.  The
+ * <code>value</code> argument is used only by <code>EDGE_CONSTANT</code>.
+ */
+
+   void setEdgePolicy(EdgePolicy policy, ValueType value = ValueType());
+
+/*
+ * Method: getEdgePolicy
+ * Usage: EdgePolicy policy = stencil.getEdgePolicy();
+ * ---------------------------------------------------
+ * Returns the current edge policy.
+ */
+
+   EdgePolicy getEdgePolicy() const;
+
+/*
+ * Method: setThreadCount
+ * Usage: stencil.setThreadCount(nThreads);
+ * ----------------------------------------
+ * Sets the number of threads used by <code>step</code>.  The rows of
+ * the grid are divided into that many contiguous bands, each of which
+ * is computed by its own thread.  If there is more than one thread, the
+ * kernel is called concurrently and must not modify shared data.
+ */
+
+   void setThreadCount(int nThreads);
+
+/*
+ * Method: getThreadCount
+ * Usage: int nThreads = stencil.getThreadCount();
+ * -----------------------------------------------
+ * Returns the number of threads used by <code>step</code>.
+ */
+
+   int getThreadCount() const;
+
+/*
+ * Method: setTileWidth
+ * Usage: stencil.setTileWidth(nCols);
+ * -----------------------------------
+ * Sets the number of columns in each tile.  Each thread sweeps down
+ * its band one tile-wide strip at a time, so that the rows of the
+ * neighborhood stay in the cache from one output row to the next.
+ * The default width keeps the rows for one strip within about 16K
+ * bytes, and there is rarely a need to change it.
+ */
+
+   void setTileWidth(int nCols);
+
+/*
+ * Method: step
+ * Usage: stencil.step(kernel);
+ *        stencil.step(kernel, nSteps);
+ * ------------------------------------
+ * Advances the grid by one generation, or by <code>nSteps</code>
+ * generations, by applying <code>kernel</code> to every cell.  All
+ * the cells of a generation see the values from the previous one.
+ */
+
+   template <typename KernelType>
+   void step(KernelType kernel, int nSteps = 1);
+
+/*
+ * Method: getGrid
+ * Usage: Grid<ValueType> & grid = stencil.getGrid();
+ * --------------------------------------------------
+ * Returns a reference to the grid that holds the current generation.
+ * The client may read or change its elements between steps but must
+ * not resize it.  After each step, this reference refers to the other
+ * buffer, so it should be obtained again rather than saved.
+ */
+
+   Grid<ValueType> & getGrid();
+
+/*
+ * Methods: get, set
+ * Usage: ValueType value = stencil.get(row, col);
+ *        stencil.set(row, col, value);
+ * ------------------------------------------------
+ * These methods read and write a single cell in the current generation.
+ */
+
+   ValueType get(int row, int col);
+   void set(int row, int col, ValueType value);
+
+#include "private/gridstencilpriv.h"
+
+};
+
+#include "private/gridstencilimpl.cpp"
+
+#endif
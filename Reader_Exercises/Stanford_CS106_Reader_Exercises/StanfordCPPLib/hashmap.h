@@ -15,6 +15,29 @@
 #include "foreach.h"
 #include "vector.h"
 
+/*
+ * Function: hashCode
+ * Usage: int hash = hashCode(key);
+ * --------------------------------
+ * Returns a hash code for the specified key, which is always a
+ * nonnegative integer.  This function is overloaded to support
+ * all of the primitive types and the C++ <code>string</code> type.
+ */
+
+int hashCode(std::string key);
+int hashCode(int key);
+int hashCode(char key);
+int hashCode(long key);
+int hashCode(double key);
+
+/*
+ * The hashCode functions must be declared before the templates that
+ * call them, including the default hash function of BloomFilter, so
+ * bloomfilter.h is included after them.
+ */
+
+#include "bloomfilter.h"
+
 /*
  * Class: HashMap<KeyType,ValueType>
  * ---------------------------------
@@ -138,6 +161,45 @@ public:
 
    ValueType & operator[](KeyType key);
 
+/*
+ * Method: enableBloomFilter
+ * Usage: map.enableBloomFilter();
+ *        map.enableBloomFilter(falsePositiveRate);
+ * ------------------------------------------------
+ * Attaches a <code>BloomFilter</code> to this map that is consulted
+ * before the hash table by <code>containsKey</code> and
+ * <code>get</code>.  The filter is built from the current keys and
+ * maintained as new keys are added, so most lookups for missing keys
+ * are rejected without walking a bucket chain.  Its counters record
+ * only these lookups, not the insertions made by <code>put</code> and
+ * <code>operator[]</code>.  The
+ * optional argument sets the target false-positive rate, which
+ * defaults to one percent.  Enabling a filter is worthwhile only when
+ * most lookups are expected to fail.
+ */
+
+   void enableBloomFilter(double falsePositiveRate = 0.01);
+
+/*
+ * Method: disableBloomFilter
+ * Usage: map.disableBloomFilter();
+ * --------------------------------
+ * Removes any filter previously attached by <code>enableBloomFilter</code>.
+ */
+
+   void disableBloomFilter();
+
+/*
+ * Method: getBloomFilter
+ * Usage: const BloomFilter<KeyType> *filter = map.getBloomFilter();
+ * -----------------------------------------------------------------
+ * Returns a pointer to the attached filter, which clients can use to
+ * read its hit and miss counters, or <code>NULL</code> if no filter
+ * is enabled.
+ */
+
+   const BloomFilter<KeyType> *getBloomFilter() const;
+
 /*
  * Macro: foreach
  * Usage: foreach (KeyType key in map) . . .
@@ -171,19 +233,4 @@ public:
 
 #include "private/hashmapimpl.cpp"
 
-/*
- * Function: hashCode
- * Usage: int hash = hashCode(key);
- * --------------------------------
- * Returns a hash code for the specified key, which is always a
- * nonnegative integer.  This function is overloaded to support
- * all of the primitive types and the C++ <code>string</code> type.
- */
-
-int hashCode(std::string key);
-int hashCode(int key);
-int hashCode(char key);
-int hashCode(long key);
-int hashCode(double key);
-
 #endif
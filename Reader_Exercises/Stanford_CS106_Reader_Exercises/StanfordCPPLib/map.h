@@ -12,6 +12,7 @@
 #include "cmpfn.h"
 #include "error.h"
 #include "foreach.h"
+#include "private/atomic.h"
 #include "stack.h"
 
 /*
@@ -82,6 +83,23 @@ public:
 
    void put(KeyType key, ValueType value);
 
+/*
+ * Method: putSorted
+ * Usage: map.putSorted(keys, values, n);
+ * --------------------------------------
+ * Associates each of the first <code>n</code> elements of
+ * <code>keys</code> with the element of <code>values</code> at the same
+ * index, just as <code>n</code> calls to <code>put</code> would.  The
+ * keys must be distinct and listed in increasing order according to
+ * the comparison function of the map; if they are not,
+ * <code>putSorted</code> signals an error and leaves the map unchanged.
+ * Instead of inserting the keys one at a time, this method merges them
+ * with the existing entries and rebuilds the tree, which takes time
+ * proportional to the size of the map plus <code>n</code>.
+ */
+
+   void putSorted(const KeyType *keys, const ValueType *values, int n);
+
 /*
  * Method: get
  * Usage: ValueType value = map.get(key);
@@ -135,6 +153,28 @@ public:
 
    ValueType & operator[](KeyType key);
 
+/*
+ * Methods: setCopyOnWrite, isCopyOnWrite
+ * Usage: map.setCopyOnWrite(true);
+ *        if (map.isCopyOnWrite()) . . .
+ * -------------------------------------
+ * Turns copy-on-write sharing on or off and reports whether it is on.
+ * When it is on, copying the map takes constant time: the copy shares
+ * the entries of the original, and whichever map is changed first
+ * makes its own copy of the entries at that point.  Copies of a
+ * copy-on-write map are also copy-on-write.  The methods that change
+ * the map are <code>put</code>, <code>remove</code>, <code>clear</code>,
+ * and the <code>[]</code> operator, which cannot tell whether the
+ * reference it returns will be used only to read the value; clients
+ * that share a map should use <code>get</code> to read from it.
+ * Copying is thread-safe in the sense that two threads may copy,
+ * change, and destroy maps that share their entries, as long as no
+ * single map is used by more than one thread at a time.
+ */
+
+   void setCopyOnWrite(bool flag);
+   bool isCopyOnWrite() const;
+
 /*
  * Macro: foreach
  * Usage: foreach (KeyType key in map) . . .
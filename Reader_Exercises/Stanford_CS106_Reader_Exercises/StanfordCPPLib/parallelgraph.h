@@ -0,0 +1,150 @@
+/*
+ * File: parallelgraph.h
+ * ---------------------
+ * This interface exports the <code>ParallelGraphSearch</code> class,
+ * which uses several threads to run breadth-first search and to find
+ * the connected components of a large <code>Graph</code>.
+ */
+
+#ifndef _parallelgraph_h
+#define _parallelgraph_h
+
+#include <stdint.h>
+#include "error.h"
+#include "frozengraph.h"
+#include "graph.h"
+#include "private/atomic.h"
+#include "threadpool.h"
+
+/*
+ * Class: ParallelGraphSearch<NodeType,ArcType>
+ * --------------------------------------------
+ * This class searches a snapshot of a graph, which it makes with
+ * <code>freeze</code> when it is constructed, using the threads of a
+ * <code>ThreadPool</code>.  The search methods take the pool as an
+ * optional argument; without it, they use the pool returned by
+ * <code>getDefaultThreadPool</code>, which has one thread per
+ * processor.
+ *
+ * <p>The results do not depend on the number of threads or on the
+ * order in which the threads happen to run.  The distances found by
+ * <code>breadthFirstSearch</code> are the same as those found by the
+ * <code>breadthFirstSearch</code> method of <code>GraphSearch</code>,
+ * and the components are numbered in the order of the first node of
+ * each component in the node set, which is the numbering a serial
+ * search in that order would produce.
+ */
+
+template <typename NodeType,typename ArcType>
+class ParallelGraphSearch {
+
+public:
+
+/*
+ * Constructor: ParallelGraphSearch
+ * Usage: ParallelGraphSearch<NodeType,ArcType> search(g);
+ *        ParallelGraphSearch<NodeType,ArcType> search(fg);
+ * ------------------------------------------------------
+ * Creates a search object for the graph <code>g</code>, or for a copy
+ * of an existing snapshot.
+ */
+
+   explicit ParallelGraphSearch(Graph<NodeType,ArcType> & g);
+   explicit ParallelGraphSearch(const FrozenGraph<NodeType,ArcType> & fg);
+
+/*
+ * Destructor: ~ParallelGraphSearch
+ * Usage: (usually implicit)
+ * -------------------------
+ * Frees the storage used by the search.
+ */
+
+   ~ParallelGraphSearch();
+
+/*
+ * Method: breadthFirstSearch
+ * Usage: search.breadthFirstSearch(start);
+ *        search.breadthFirstSearch(start, pool);
+ * ----------------------------------------------
+ * Finds the number of arcs on the shortest path from
+ * <code>start</code> to every node of the graph.  The search is
+ * <i>direction-optimizing:</i> while the set of nodes at the current
+ * distance is small, each thread follows the arcs that leave some of
+ * those nodes, but when the set grows large, each thread instead
+ * checks whether some of the nodes not yet reached have an incoming
+ * arc from the set, which examines far fewer arcs.
+ */
+
+   void breadthFirstSearch(NodeType *start);
+   void breadthFirstSearch(NodeType *start, ThreadPool & pool);
+
+/*
+ * Methods: isReachable, getDistance
+ * Usage: if (search.isReachable(node)) . . .
+ *        int dist = search.getDistance(node);
+ * ---------------------------------------------
+ * These methods report the results of the most recent call to
+ * <code>breadthFirstSearch</code>.  <code>getDistance</code> returns
+ * the number of arcs on the shortest path to <code>node</code>, or -1
+ * if there is no such path.
+ */
+
+   bool isReachable(NodeType *node);
+   int getDistance(NodeType *node);
+
+/*
+ * Method: findComponents
+ * Usage: int nComponents = search.findComponents();
+ *        int nComponents = search.findComponents(pool);
+ * ---------------------------------------------------
+ * Divides the nodes into <i>connected components,</i> treating each
+ * arc as if it could be followed in either direction, and returns the
+ * number of components.  The components are numbered from 0 in the
+ * order in which their first nodes appear in the node set.
+ */
+
+   int findComponents();
+   int findComponents(ThreadPool & pool);
+
+/*
+ * Method: getComponent
+ * Usage: int component = search.getComponent(node);
+ * --------------------------------------------------
+ * Returns the number of the component that contains
+ * <code>node</code>.  This method signals an error if
+ * <code>findComponents</code> has not been called.
+ */
+
+   int getComponent(NodeType *node);
+
+/*
+ * Methods: getDistances, getComponents
+ * Usage: const int *dist = search.getDistances();
+ *        const int *components = search.getComponents();
+ * ----------------------------------------------------
+ * These methods return the results of the most recent searches as
+ * arrays indexed by the node ids of the snapshot, which avoids looking
+ * up each node when a client needs all of the results.
+ * <code>getComponents</code> returns <code>NULL</code> if
+ * <code>findComponents</code> has not been called.
+ */
+
+   const int *getDistances() const;
+   const int *getComponents() const;
+
+/*
+ * Method: getSnapshot
+ * Usage: const FrozenGraph<NodeType,ArcType> & fg = search.getSnapshot();
+ * -----------------------------------------------------------------------
+ * Returns the snapshot on which the searches run.
+ */
+
+   const FrozenGraph<NodeType,ArcType> & getSnapshot() const;
+
+#include "private/parallelgraphpriv.h"
+
+};
+
+#include "private/parallelgraphimpl.cpp"
+
+#endif
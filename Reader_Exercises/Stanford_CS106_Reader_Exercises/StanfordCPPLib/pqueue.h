@@ -8,24 +8,67 @@
 #ifndef _pqueue_h
 #define _pqueue_h
 
+#include <functional>
+#include <iterator>
+#include <utility>
 #include "error.h"
 #include "vector.h"
 
 /*
- * Class: PriorityQueue<ValueType>
- * -------------------------------
+ * Class: PriorityQueue<ValueType,PriorityType,Compare>
+ * ----------------------------------------------------
  * This class models a linear structure called a <i>priority&nbsp;queue</i>
  * in which values are processed in order of priority.  As in conventional
  * English usage, lower priority numbers correspond to higher effective
  * priorities, so that a priority 1 item takes precedence over a
  * priority 2 item.
+ *
+ * <p>Most clients need only the <code>ValueType</code> parameter, in
+ * which case priorities are of type <code>double</code>.  The optional
+ * <code>PriorityType</code> parameter allows priorities of any type
+ * that can be copied and compared, such as <code>long</code> timestamps
+ * or a <code>std::pair</code> of a deadline and a cost.  The optional
+ * <code>Compare</code> parameter is a function-object type whose
+ * <code>operator()</code> returns <code>true</code> if its first
+ * argument should be processed before its second.  It defaults to
+ * <code>std::less</code>; supplying <code>std::greater</code> makes the
+ * queue return the largest priority first:
+ *
+ *<pre>
+ *    PriorityQueue<string, int, std::greater<int> > maxQueue;
+ *</pre>
  */
 
-template <typename ValueType>
+template <typename ValueType,
+          typename PriorityType = double,
+          typename Compare = std::less<PriorityType> >
 class PriorityQueue {
 
 public:
 
+/*
+ * Type: Handle
+ * ------------
+ * A <code>Handle</code> identifies a particular entry in the queue and
+ * is returned by <code>enqueue</code>.  Clients that need to adjust or
+ * withdraw an entry later, such as a shortest-path search that lowers
+ * the distance to a node, keep the handle and pass it to
+ * <code>changePriority</code> or <code>remove</code>.  A handle becomes
+ * invalid once its entry has been dequeued or removed.
+ */
+
+   class Handle {
+   public:
+      Handle() {
+         slot = -1;
+         sequence = -1;
+      }
+   private:
+      int slot;
+      long sequence;
+      friend class PriorityQueue;
+   };
+
 /*
  * Constructor: PriorityQueue
  * Usage: PriorityQueue<ValueType> pq;
@@ -35,6 +78,25 @@ public:
 
    PriorityQueue();
 
+/*
+ * Constructor: PriorityQueue
+ * Usage: PriorityQueue<ValueType> pq(begin, end);
+ * -----------------------------------------------
+ * Initializes a new priority queue containing the entries in the range
+ * from <code>begin</code> up to but not including <code>end</code>.
+ * Each element of the range must be a pair in which <code>first</code>
+ * is the value and <code>second</code> is its priority, as in a
+ * <code>Vector</code> of
+ * <code>std::pair&lt;ValueType,PriorityType&gt;</code>.
+ * Elements with equal priorities are dequeued in the order in which
+ * they appear in the range.  Building the queue this way takes O(N)
+ * time, rather than the O(N log N) time required for N calls to
+ * <code>enqueue</code>.
+ */
+
+   template <typename IteratorType>
+   PriorityQueue(IteratorType begin, IteratorType end);
+
 /*
  * Destructor: ~PriorityQueue
  * Usage: (usually implicit)
@@ -74,14 +136,31 @@ public:
 /*
  * Method: enqueue
  * Usage: pq.enqueue(value, priority);
- * -----------------------------------
+ *        PriorityQueue<ValueType>::Handle handle = pq.enqueue(value, priority);
+ * ----------------------------------------------------------------------------
  * Adds <code>value</code> to the queue with the specified priority.
  * Lower priority numbers correspond to higher priorities, which
  * means that all priority 1 elements are dequeued before any
- * priority 2 elements.
+ * priority 2 elements, unless the queue was declared with a different
+ * <code>Compare</code> type.  The return value is a handle for the new
+ * entry, which clients may ignore.
+ */
+
+   Handle enqueue(ValueType value, const PriorityType & priority);
+
+/*
+ * Method: enqueueAll
+ * Usage: pq.enqueueAll(begin, end);
+ * ---------------------------------
+ * Adds every entry in the range from <code>begin</code> up to but not
+ * including <code>end</code>, where each element is a (value, priority)
+ * pair as described for the range constructor.  Storage is expanded
+ * at most once, and a large batch is merged by rebuilding the heap in
+ * linear time instead of inserting its entries one at a time.
  */
 
-   void enqueue(ValueType value, double priority);
+   template <typename IteratorType>
+   void enqueueAll(IteratorType begin, IteratorType end);
 
 /*
  * Method: dequeue
@@ -104,6 +183,50 @@ public:
 
    ValueType peek() const;
 
+/*
+ * Method: changePriority
+ * Usage: pq.changePriority(handle, priority);
+ * -------------------------------------------
+ * Changes the priority of the entry identified by <code>handle</code>.
+ * The priority may be raised or lowered.  If the entry ends up tied
+ * with others, it keeps its original place in the first-in/first-out
+ * order among them.  This method runs in O(log N) time and signals
+ * an error if the handle no longer refers to an entry in the queue.
+ */
+
+   void changePriority(Handle handle, const PriorityType & priority);
+
+/*
+ * Method: remove
+ * Usage: pq.remove(handle);
+ * -------------------------
+ * Removes the entry identified by <code>handle</code> from the queue
+ * in O(log N) time.  This method signals an error if the handle no
+ * longer refers to an entry in the queue.
+ */
+
+   void remove(Handle handle);
+
+/*
+ * Method: contains
+ * Usage: if (pq.contains(handle)) . . .
+ * -------------------------------------
+ * Returns <code>true</code> if <code>handle</code> refers to an entry
+ * that is still in the queue.
+ */
+
+   bool contains(Handle handle) const;
+
+/*
+ * Method: getPriority
+ * Usage: PriorityType priority = pq.getPriority(handle);
+ * ------------------------------------------------------
+ * Returns the current priority of the entry identified by
+ * <code>handle</code>.
+ */
+
+   PriorityType getPriority(Handle handle) const;
+
 #include "private/pqueuepriv.h"
 
 };
@@ -0,0 +1,143 @@
+/*
+ * File: arenaimpl.cpp
+ * -------------------
+ * This file contains the implementation of the arena.h interface.
+ * Because of the way C++ compiles templates, this code must be
+ * available to the compiler when it reads the header file.
+ */
+
+#ifdef _arena_h
+
+#include <new>
+
+template <typename ValueType>
+Arena<ValueType>::Arena() {
+   slabs = NULL;
+   freeList = NULL;
+   count = 0;
+   nextSlabSize = INITIAL_SLAB_SIZE;
+}
+
+template <typename ValueType>
+Arena<ValueType>::~Arena() {
+   clear();
+}
+
+/*
+ * Implementation notes: create
+ * ----------------------------
+ * The object is constructed in its slot using placement new.  The
+ * empty parentheses value-initialize the object, which matches the
+ * behavior of new ValueType() for types with no constructor.
+ */
+
+template <typename ValueType>
+ValueType *Arena<ValueType>::create() {
+   if (freeList == NULL) addSlab();
+   Slot *slot = freeList;
+   ValueType *ptr = new (slot->storage.bytes) ValueType();
+   freeList = slot->next;
+   slot->live = true;
+   count++;
+   return ptr;
+}
+
+template <typename ValueType>
+void Arena<ValueType>::destroy(ValueType *ptr) {
+   Slot *slot = findSlot(ptr);
+   if (slot == NULL) error("destroy: Object is not in the arena");
+   ptr->~ValueType();
+   slot->live = false;
+   slot->next = freeList;
+   freeList = slot;
+   count--;
+}
+
+template <typename ValueType>
+bool Arena<ValueType>::contains(ValueType *ptr) const {
+   return findSlot(ptr) != NULL;
+}
+
+template <typename ValueType>
+int Arena<ValueType>::size() const {
+   return count;
+}
+
+template <typename ValueType>
+bool Arena<ValueType>::isEmpty() const {
+   return count == 0;
+}
+
+/*
+ * Implementation notes: clear
+ * ---------------------------
+ * The slots are visited in the order in which they lie in memory,
+ * which is faster than following pointers to objects scattered around
+ * the heap.  Slots that are not live hold no object and are skipped.
+ */
+
+template <typename ValueType>
+void Arena<ValueType>::clear() {
+   while (slabs != NULL) {
+      Slab *slab = slabs;
+      for (int i = 0; i < slab->nSlots; i++) {
+         Slot & slot = slab->slots[i];
+         if (slot.live) {
+            reinterpret_cast<ValueType *>(slot.storage.bytes)->~ValueType();
+         }
+      }
+      slabs = slab->next;
+      delete[] slab->slots;
+      delete slab;
+   }
+   freeList = NULL;
+   count = 0;
+   nextSlabSize = INITIAL_SLAB_SIZE;
+}
+
+/*
+ * Implementation notes: addSlab
+ * -----------------------------
+ * The slots of a new slab are pushed onto the free list in reverse
+ * order so that create hands them out in increasing address order.
+ */
+
+template <typename ValueType>
+void Arena<ValueType>::addSlab() {
+   Slab *slab = new Slab;
+   slab->nSlots = nextSlabSize;
+   slab->slots = new Slot[nextSlabSize];
+   slab->next = slabs;
+   slabs = slab;
+   for (int i = nextSlabSize - 1; i >= 0; i--) {
+      slab->slots[i].live = false;
+      slab->slots[i].next = freeList;
+      freeList = &slab->slots[i];
+   }
+   nextSlabSize *= 2;
+}
+
+/*
+ * Implementation notes: findSlot
+ * ------------------------------
+ * This method returns the slot that holds ptr, or NULL if ptr does not
+ * point to a live object in the arena.  A pointer counts as being in a
+ * slab only if it lies within the slab and at the start of a slot.
+ */
+
+template <typename ValueType>
+typename Arena<ValueType>::Slot *Arena<ValueType>::findSlot(
+                                              ValueType *ptr) const {
+   const char *cp = reinterpret_cast<const char *>(ptr);
+   for (Slab *slab = slabs; slab != NULL; slab = slab->next) {
+      const char *base = reinterpret_cast<const char *>(slab->slots);
+      if (cp >= base && cp < base + slab->nSlots * sizeof(Slot)) {
+         if ((cp - base) % sizeof(Slot) != 0) return NULL;
+         Slot *slot = &slab->slots[(cp - base) / sizeof(Slot)];
+         return (slot->live) ? slot : NULL;
+      }
+   }
+   return NULL;
+}
+
+#endif
@@ -0,0 +1,70 @@
+/*
+ * File: arenapriv.h
+ * -----------------
+ * This file contains the private section of the arena.h interface.
+ */
+
+/*
+ * Implementation notes: Arena data structure
+ * ------------------------------------------
+ * Each slab is an array of slots, and each slot holds the storage for
+ * one object followed by a flag that records whether the slot is in
+ * use.  The storage comes first in the slot, so the address of an
+ * object is also the address of its slot.  Slots that are not in use
+ * are chained together through their next fields to form the free
+ * list.  The arena refers to its slots only through pointers, which
+ * allows a class to contain an Arena of a type that is not yet
+ * complete, as Graph does with its node and arc types.
+ */
+
+private:
+
+/* Constants */
+
+   static const int INITIAL_SLAB_SIZE = 64;
+
+/* Type used for the storage of a single object */
+
+   struct Slot {
+      union {
+         char bytes[sizeof(ValueType)];
+         double alignDouble;
+         long double alignLongDouble;
+         long long alignLong;
+         void *alignPointer;
+      } storage;                 /* Space for the object itself         */
+      Slot *next;                /* Next free slot                      */
+      bool live;                 /* True if the slot holds an object    */
+   };
+
+/* Type used for the list of slabs */
+
+   struct Slab {
+      Slot *slots;               /* The array of slots                  */
+      int nSlots;                /* The number of slots in the array    */
+      Slab *next;                /* The slab allocated before this one  */
+   };
+
+/* Instance variables */
+
+   Slab *slabs;                  /* The most recently allocated slab    */
+   Slot *freeList;               /* Chain of unused slots               */
+   int count;                    /* The number of live objects          */
+   int nextSlabSize;             /* The number of slots in the next slab */
+
+/* Private method prototypes */
+
+   void addSlab();
+   Slot *findSlot(ValueType *ptr) const;
+
+/*
+ * Hidden features
+ * ---------------
+ * The objects in an arena belong to it, so copying an arena would
+ * require copying every object and adjusting every pointer to them.
+ * The copy constructor and assignment operator are therefore declared
+ * private and are never defined.
+ */
+
+   Arena(const Arena & src);
+   Arena & operator=(const Arena & src);
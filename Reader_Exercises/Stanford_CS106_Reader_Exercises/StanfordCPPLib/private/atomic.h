@@ -0,0 +1,127 @@
+/*
+ * File: atomic.h
+ * --------------
+ * This file defines the atomic operations on integers that the library
+ * uses for shared reference counts, statistics counters, and the data
+ * that parallel algorithms update from several threads at once.  All
+ * of the compiler-specific code is in this file, which is the only
+ * place that needs to change in order to support another compiler.
+ */
+
+#ifndef _atomic_h
+#define _atomic_h
+
+#include <stdint.h>
+
+/*
+ * Implementation notes: atomic operations
+ * ---------------------------------------
+ * GCC and Clang provide builtins for each of these operations.  The
+ * read-modify-write operations are full barriers, which is what the
+ * reference counts require, while atomicLoad and atomicStore are
+ * relaxed: they guarantee only that a value is never torn and that the
+ * access is not a data race.  Microsoft's compiler provides the same
+ * operations as the Interlocked intrinsics, which work on long, a
+ * 32-bit type on Windows.
+ */
+
+#if defined(__GNUC__)
+
+inline int atomicIncrement(int *p) {
+   return __sync_add_and_fetch(p, 1);
+}
+
+inline int atomicDecrement(int *p) {
+   return __sync_sub_and_fetch(p, 1);
+}
+
+inline int atomicFetchAndAdd(int *p, int n) {
+   return __sync_fetch_and_add(p, n);
+}
+
+inline long atomicFetchAndAdd(long *p, long n) {
+   return __sync_fetch_and_add(p, n);
+}
+
+inline uint64_t atomicFetchAndOr(uint64_t *p, uint64_t mask) {
+   return __sync_fetch_and_or(p, mask);
+}
+
+inline bool atomicCompareAndSwap(int *p, int expected, int desired) {
+   return __sync_bool_compare_and_swap(p, expected, desired);
+}
+
+inline int atomicLoad(const int *p) {
+   return __atomic_load_n(p, __ATOMIC_RELAXED);
+}
+
+inline long atomicLoad(const long *p) {
+   return __atomic_load_n(p, __ATOMIC_RELAXED);
+}
+
+inline uint64_t atomicLoad(const uint64_t *p) {
+   return __atomic_load_n(p, __ATOMIC_RELAXED);
+}
+
+inline void atomicStore(int *p, int value) {
+   __atomic_store_n(p, value, __ATOMIC_RELAXED);
+}
+
+inline void atomicStore(long *p, long value) {
+   __atomic_store_n(p, value, __ATOMIC_RELAXED);
+}
+
+#elif defined(_MSC_VER)
+
+#include <intrin.h>
+
+inline int atomicIncrement(int *p) {
+   return _InterlockedIncrement((volatile long *) p);
+}
+
+inline int atomicDecrement(int *p) {
+   return _InterlockedDecrement((volatile long *) p);
+}
+
+inline int atomicFetchAndAdd(int *p, int n) {
+   return _InterlockedExchangeAdd((volatile long *) p, n);
+}
+
+inline long atomicFetchAndAdd(long *p, long n) {
+   return _InterlockedExchangeAdd((volatile long *) p, n);
+}
+
+inline uint64_t atomicFetchAndOr(uint64_t *p, uint64_t mask) {
+   return _InterlockedOr64((volatile __int64 *) p, mask);
+}
+
+inline bool atomicCompareAndSwap(int *p, int expected, int desired) {
+   return _InterlockedCompareExchange((volatile long *) p,
+                                      desired, expected) == expected;
+}
+
+inline int atomicLoad(const int *p) {
+   return *(const volatile int *) p;
+}
+
+inline long atomicLoad(const long *p) {
+   return *(const volatile long *) p;
+}
+
+inline uint64_t atomicLoad(const uint64_t *p) {
+   return (uint64_t) _InterlockedOr64((volatile __int64 *) p, 0);
+}
+
+inline void atomicStore(int *p, int value) {
+   *(volatile int *) p = value;
+}
+
+inline void atomicStore(long *p, long value) {
+   *(volatile long *) p = value;
+}
+
+#else
+#  error "atomic.h: No atomic operations are defined for this compiler"
+#endif
+
+#endif
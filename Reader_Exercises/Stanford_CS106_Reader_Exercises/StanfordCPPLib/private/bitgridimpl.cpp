@@ -0,0 +1,290 @@
+/*
+ * File: bitgridimpl.cpp
+ * ---------------------
+ * This file contains the implementation of the bitgrid.h interface.
+ * BitGrid is not a template, but its methods are defined here and
+ * declared inline so that the library can be used by including the
+ * header alone.
+ */
+
+#ifdef _bitgrid_h
+
+inline BitGrid::BitGrid() {
+   words = NULL;
+   nRows = 0;
+   nCols = 0;
+   nWords = 0;
+   lastMask = 0;
+}
+
+inline BitGrid::BitGrid(int nRows, int nCols) {
+   words = NULL;
+   resize(nRows, nCols);
+}
+
+inline BitGrid::~BitGrid() {
+   delete[] words;
+}
+
+inline int BitGrid::numRows() const {
+   return nRows;
+}
+
+inline int BitGrid::numCols() const {
+   return nCols;
+}
+
+inline void BitGrid::resize(int nRows, int nCols) {
+   if (nRows < 0 || nCols < 0) {
+      error("Attempt to resize grid to invalid size ("
+            + integerToString(nRows) + ", "
+            + integerToString(nCols) + ")");
+   }
+   delete[] words;
+   this->nRows = nRows;
+   this->nCols = nCols;
+   nWords = (nCols + 63) / 64;
+   lastMask = (nCols % 64 == 0) ? ~(uint64_t) 0
+                                : ((uint64_t) 1 << (nCols % 64)) - 1;
+   words = new uint64_t[nRows * nWords];
+   fill(false);
+}
+
+inline bool BitGrid::inBounds(int row, int col) const {
+   return row >= 0 && col >= 0 && row < nRows && col < nCols;
+}
+
+inline bool BitGrid::get(int row, int col) const {
+   checkCell(row, col, "get");
+   return (words[row * nWords + col / 64] >> (col % 64)) & 1;
+}
+
+inline void BitGrid::set(int row, int col, bool value) {
+   checkCell(row, col, "set");
+   uint64_t bit = (uint64_t) 1 << (col % 64);
+   uint64_t & word = words[row * nWords + col / 64];
+   if (value) {
+      word |= bit;
+   } else {
+      word &= ~bit;
+   }
+}
+
+inline void BitGrid::fill(bool value) {
+   uint64_t pattern = value ? ~(uint64_t) 0 : 0;
+   for (int r = 0; r < nRows; r++) {
+      uint64_t *row = words + r * nWords;
+      for (int i = 0; i < nWords; i++) {
+         row[i] = pattern;
+      }
+      if (nWords > 0) row[nWords - 1] &= lastMask;
+   }
+}
+
+inline long BitGrid::count() const {
+   long total = 0;
+   int n = nRows * nWords;
+   for (int i = 0; i < n; i++) {
+      total += popcount(words[i]);
+   }
+   return total;
+}
+
+inline int BitGrid::countRow(int row) const {
+   checkRow(row, "countRow");
+   const uint64_t *rp = words + row * nWords;
+   int total = 0;
+   for (int i = 0; i < nWords; i++) {
+      total += popcount(rp[i]);
+   }
+   return total;
+}
+
+/*
+ * Implementation notes: shift
+ * ---------------------------
+ * The vertical part of the shift copies whole rows, working away from
+ * the direction of motion so that no row is overwritten before it has
+ * been moved.  Each row is then shifted horizontally by shiftRowBits.
+ */
+
+inline void BitGrid::shift(int dRows, int dCols) {
+   if (dRows <= -nRows || dRows >= nRows || dCols <= -nCols
+                                         || dCols >= nCols) {
+      fill(false);
+      return;
+   }
+   if (dRows > 0) {
+      for (int r = nRows - 1; r >= dRows; r--) {
+         uint64_t *dst = words + r * nWords;
+         const uint64_t *src = dst - dRows * nWords;
+         for (int i = 0; i < nWords; i++) dst[i] = src[i];
+      }
+      for (int i = 0; i < dRows * nWords; i++) words[i] = 0;
+   } else if (dRows < 0) {
+      int d = -dRows;
+      for (int r = 0; r < nRows - d; r++) {
+         uint64_t *dst = words + r * nWords;
+         const uint64_t *src = dst + d * nWords;
+         for (int i = 0; i < nWords; i++) dst[i] = src[i];
+      }
+      for (int i = (nRows - d) * nWords; i < nRows * nWords; i++) {
+         words[i] = 0;
+      }
+   }
+   if (dCols != 0) {
+      for (int r = 0; r < nRows; r++) {
+         shiftRowBits(words + r * nWords, dCols);
+      }
+   }
+}
+
+/*
+ * Implementation notes: shiftRowBits
+ * -----------------------------------
+ * Moving the cells of a row toward higher columns moves each bit to a
+ * higher position.  A shift by dCols is split into a shift of q whole
+ * words and b bits, and each word of the result is assembled from the
+ * two source words that overlap it.  The bits shifted past the last
+ * column are then cleared.
+ */
+
+inline void BitGrid::shiftRowBits(uint64_t *row, int dCols) {
+   int d = (dCols < 0) ? -dCols : dCols;
+   int q = d / 64;
+   int b = d % 64;
+   if (dCols > 0) {
+      for (int i = nWords - 1; i >= 0; i--) {
+         int src = i - q;
+         uint64_t value = 0;
+         if (src >= 0) value = row[src] << b;
+         if (b != 0 && src >= 1) value |= row[src - 1] >> (64 - b);
+         row[i] = value;
+      }
+   } else {
+      for (int i = 0; i < nWords; i++) {
+         int src = i + q;
+         uint64_t value = 0;
+         if (src < nWords) value = row[src] >> b;
+         if (b != 0 && src + 1 < nWords) value |= row[src + 1] << (64 - b);
+         row[i] = value;
+      }
+   }
+   row[nWords - 1] &= lastMask;
+}
+
+inline void BitGrid::andRow(int row, const BitGrid & src, int srcRow) {
+   checkRow(row, "andRow");
+   src.checkRow(srcRow, "andRow");
+   checkWidth(src, "andRow");
+   uint64_t *dp = words + row * nWords;
+   const uint64_t *sp = src.words + srcRow * nWords;
+   for (int i = 0; i < nWords; i++) {
+      dp[i] &= sp[i];
+   }
+}
+
+inline void BitGrid::orRow(int row, const BitGrid & src, int srcRow) {
+   checkRow(row, "orRow");
+   src.checkRow(srcRow, "orRow");
+   checkWidth(src, "orRow");
+   uint64_t *dp = words + row * nWords;
+   const uint64_t *sp = src.words + srcRow * nWords;
+   for (int i = 0; i < nWords; i++) {
+      dp[i] |= sp[i];
+   }
+}
+
+inline void BitGrid::xorRow(int row, const BitGrid & src, int srcRow) {
+   checkRow(row, "xorRow");
+   src.checkRow(srcRow, "xorRow");
+   checkWidth(src, "xorRow");
+   uint64_t *dp = words + row * nWords;
+   const uint64_t *sp = src.words + srcRow * nWords;
+   for (int i = 0; i < nWords; i++) {
+      dp[i] ^= sp[i];
+   }
+}
+
+inline BitGrid & BitGrid::operator&=(const BitGrid & src) {
+   if (src.nRows != nRows) error("BitGrid &=: grids differ in size");
+   checkWidth(src, "BitGrid &=");
+   for (int i = 0; i < nRows * nWords; i++) {
+      words[i] &= src.words[i];
+   }
+   return *this;
+}
+
+inline BitGrid & BitGrid::operator|=(const BitGrid & src) {
+   if (src.nRows != nRows) error("BitGrid |=: grids differ in size");
+   checkWidth(src, "BitGrid |=");
+   for (int i = 0; i < nRows * nWords; i++) {
+      words[i] |= src.words[i];
+   }
+   return *this;
+}
+
+inline BitGrid & BitGrid::operator^=(const BitGrid & src) {
+   if (src.nRows != nRows) error("BitGrid ^=: grids differ in size");
+   checkWidth(src, "BitGrid ^=");
+   for (int i = 0; i < nRows * nWords; i++) {
+      words[i] ^= src.words[i];
+   }
+   return *this;
+}
+
+inline uint64_t *BitGrid::rowWords(int row) {
+   checkRow(row, "rowWords");
+   return words + row * nWords;
+}
+
+inline const uint64_t *BitGrid::rowWords(int row) const {
+   checkRow(row, "rowWords");
+   return words + row * nWords;
+}
+
+inline int BitGrid::wordsPerRow() const {
+   return nWords;
+}
+
+inline void BitGrid::checkRow(int row, std::string caller) const {
+   if (row < 0 || row >= nRows) {
+      error(caller + ": row " + integerToString(row) + " out of range");
+   }
+}
+
+inline void BitGrid::checkCell(int row, int col, std::string caller) const {
+   if (!inBounds(row, col)) {
+      error(caller + ": BitGrid index values out of range");
+   }
+}
+
+inline void BitGrid::checkWidth(const BitGrid & src,
+                                std::string caller) const {
+   if (src.nCols != nCols) {
+      error(caller + ": grids differ in number of columns");
+   }
+}
+
+/*
+ * Implementation notes: popcount
+ * ------------------------------
+ * GCC and Clang provide a builtin that compiles to a single instruction
+ * on processors that have one.  Other compilers use the standard
+ * parallel bit-counting method, which adds adjacent fields of 1, 2, 4,
+ * and 8 bits and then sums the bytes with a multiplication.
+ */
+
+inline int BitGrid::popcount(uint64_t word) {
+#if defined(__GNUC__)
+   return __builtin_popcountll(word);
+#else
+   word = word - ((word >> 1) & 0x5555555555555555ULL);
+   word = (word & 0x3333333333333333ULL)
+        + ((word >> 2) & 0x3333333333333333ULL);
+   word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+   return (int) ((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+#endif
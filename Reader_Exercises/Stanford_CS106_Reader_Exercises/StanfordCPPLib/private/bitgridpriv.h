@@ -0,0 +1,75 @@
+/*
+ * File: bitgridpriv.h
+ * -------------------
+ * This file contains the private section of the bitgrid.h interface.
+ */
+
+/*
+ * Implementation notes: BitGrid data structure
+ * --------------------------------------------
+ * The cells are stored in a single array of 64-bit words in row-major
+ * order.  Each row begins on a word boundary, so rows can be combined
+ * word by word.  The unused bits at the end of each row are always
+ * zero, which lets count add up whole words without masking them.
+ */
+
+private:
+
+/* Instance variables */
+
+   uint64_t *words;      /* The packed cells, row by row              */
+   int nRows;            /* The number of rows in the grid            */
+   int nCols;            /* The number of columns in the grid         */
+   int nWords;           /* The number of words in each row           */
+   uint64_t lastMask;    /* Mask of the valid bits in the last word   */
+
+/* Private method prototypes */
+
+   void checkRow(int row, std::string caller) const;
+   void checkCell(int row, int col, std::string caller) const;
+   void checkWidth(const BitGrid & src, std::string caller) const;
+   void shiftRowBits(uint64_t *row, int dCols);
+   static int popcount(uint64_t word);
+
+/*
+ * Hidden features
+ * ---------------
+ * The remainder of this file consists of the code required to
+ * support deep copying.  Including these methods in the public
+ * interface would make that interface more difficult to understand
+ * for the average client.
+ */
+
+/*
+ * Deep copying support
+ * --------------------
+ * This copy constructor and operator= are defined to make a
+ * deep copy, making it possible to pass/return grids by value
+ * and assign from one grid to another.
+ */
+
+   void copyInternalData(const BitGrid & grid) {
+      nRows = grid.nRows;
+      nCols = grid.nCols;
+      nWords = grid.nWords;
+      lastMask = grid.lastMask;
+      int n = nRows * nWords;
+      words = new uint64_t[n];
+      for (int i = 0; i < n; i++) {
+         words[i] = grid.words[i];
+      }
+   }
+
+public:
+
+   BitGrid & operator=(const BitGrid & rhs) {
+      if (this != &rhs) {
+         delete[] words;
+         copyInternalData(rhs);
+      }
+      return *this;
+   }
+
+   BitGrid(const BitGrid & rhs) {
+      copyInternalData(rhs);
+   }
@@ -0,0 +1,210 @@
+/*
+ * File: bloomfilterimpl.cpp
+ * -------------------------
+ * This file contains the implementation of the bloomfilter.h interface.
+ * Because of the way C++ compiles templates, this code must be
+ * available to the compiler when it reads the header file.
+ */
+
+#ifdef _bloomfilter_h
+
+/*
+ * Implementation notes: BloomFilter constructor and destructor
+ * ------------------------------------------------------------
+ * The constructor checks its arguments and then lets allocateBlocks
+ * choose the size of the bit array and the number of bits per key.
+ */
+
+template <typename KeyType>
+BloomFilter<KeyType>::BloomFilter(int expectedSize, double falsePositiveRate,
+                                  int (*hashFn)(const KeyType &)) {
+   if (expectedSize < 0) {
+      error("BloomFilter: expected size must not be negative");
+   }
+   if (falsePositiveRate <= 0 || falsePositiveRate >= 1) {
+      error("BloomFilter: false-positive rate must be between 0 and 1");
+   }
+   this->falsePositiveRate = falsePositiveRate;
+   this->hashFn = hashFn;
+   allocateBlocks(expectedSize);
+   resetCounters();
+}
+
+template <typename KeyType>
+BloomFilter<KeyType>::~BloomFilter() {
+   delete[] storage;
+}
+
+template <typename KeyType>
+void BloomFilter<KeyType>::add(const KeyType & key) {
+   int block;
+   uint64_t mask[BLOCK_WORDS];
+   computeMask(key, block, mask);
+   uint64_t *words = blocks[block].words;
+   for (int i = 0; i < BLOCK_WORDS; i++) {
+      words[i] |= mask[i];
+   }
+   nKeys++;
+}
+
+template <typename KeyType>
+template <typename CollectionType>
+void BloomFilter<KeyType>::addAll(const CollectionType & collection) {
+   typename CollectionType::iterator end = collection.end();
+   for (typename CollectionType::iterator it = collection.begin();
+        it != end; ++it) {
+      add(*it);
+   }
+}
+
+/*
+ * Implementation notes: mightContain
+ * ----------------------------------
+ * The test accumulates the missing bits from all eight words rather
+ * than stopping at the first mismatch.  The loop therefore has no
+ * data-dependent branches and compiles to a few vector operations.
+ * The counters are updated atomically, so several threads may query
+ * the same filter at once.
+ */
+
+template <typename KeyType>
+bool BloomFilter<KeyType>::mightContain(const KeyType & key) const {
+   int block;
+   uint64_t mask[BLOCK_WORDS];
+   computeMask(key, block, mask);
+   const uint64_t *words = blocks[block].words;
+   uint64_t missing = 0;
+   for (int i = 0; i < BLOCK_WORDS; i++) {
+      missing |= mask[i] & ~words[i];
+   }
+   atomicFetchAndAdd(&nQueries, 1L);
+   if (missing != 0) {
+      atomicFetchAndAdd(&nRejects, 1L);
+      return false;
+   }
+   return true;
+}
+
+template <typename KeyType>
+void BloomFilter<KeyType>::clear() {
+   for (int i = 0; i < nBlocks; i++) {
+      for (int j = 0; j < BLOCK_WORDS; j++) {
+         blocks[i].words[j] = 0;
+      }
+   }
+   nKeys = 0;
+}
+
+template <typename KeyType>
+void BloomFilter<KeyType>::resize(int expectedSize) {
+   if (expectedSize < 0) {
+      error("resize: expected size must not be negative");
+   }
+   delete[] storage;
+   allocateBlocks(expectedSize);
+}
+
+template <typename KeyType>
+int BloomFilter<KeyType>::capacity() const {
+   return expectedSize;
+}
+
+template <typename KeyType>
+int BloomFilter<KeyType>::size() const {
+   return nKeys;
+}
+
+template <typename KeyType>
+double BloomFilter<KeyType>::getFalsePositiveRate() const {
+   return falsePositiveRate;
+}
+
+template <typename KeyType>
+long BloomFilter<KeyType>::queryCount() const {
+   return atomicLoad(&nQueries);
+}
+
+template <typename KeyType>
+long BloomFilter<KeyType>::rejectCount() const {
+   return atomicLoad(&nRejects);
+}
+
+template <typename KeyType>
+long BloomFilter<KeyType>::falsePositiveCount() const {
+   return atomicLoad(&nFalsePositives);
+}
+
+template <typename KeyType>
+void BloomFilter<KeyType>::recordFalsePositive() const {
+   atomicFetchAndAdd(&nFalsePositives, 1L);
+}
+
+template <typename KeyType>
+void BloomFilter<KeyType>::resetCounters() {
+   nQueries = 0;
+   nRejects = 0;
+   nFalsePositives = 0;
+}
+
+/*
+ * Implementation notes: allocateBlocks
+ * ------------------------------------
+ * The classical analysis of Bloom filters shows that a filter holding
+ * n keys with a false-positive rate p needs -n ln p / (ln 2)^2 bits and
+ * should set (bits / n) ln 2 bits per key.  This method rounds the bit
+ * count up to a whole number of blocks and allocates enough extra bytes
+ * to align the first block on a cache-line boundary.
+ */
+
+template <typename KeyType>
+void BloomFilter<KeyType>::allocateBlocks(int expectedSize) {
+   const double LN2 = 0.69314718055994530942;
+   this->expectedSize = expectedSize;
+   int n = (expectedSize < 1) ? 1 : expectedSize;
+   double bits = -n * log(falsePositiveRate) / (LN2 * LN2);
+   nBlocks = (int) ceil(bits / BLOCK_BITS);
+   if (nBlocks < 1) nBlocks = 1;
+   nHashes = (int) (bits / n * LN2 + 0.5);
+   if (nHashes < 1) nHashes = 1;
+   if (nHashes > MAX_HASHES) nHashes = MAX_HASHES;
+   storage = new char[nBlocks * sizeof(Block) + BLOCK_ALIGNMENT];
+   size_t offset = (size_t) storage % BLOCK_ALIGNMENT;
+   if (offset == 0) offset = BLOCK_ALIGNMENT;
+   blocks = (Block *) (storage + BLOCK_ALIGNMENT - offset);
+   clear();
+}
+
+/*
+ * Implementation notes: computeMask
+ * ---------------------------------
+ * The client's hash code is first spread over 64 bits using the
+ * finalizer from the SplitMix64 generator, since hash codes for
+ * similar keys often differ only in a few low-order bits.  The high
+ * half of the result selects the block.  The bit positions within the
+ * block are generated by double hashing from the two 16-bit fields of
+ * the low half, which are disjoint from each other and from the block
+ * index.  This gives nearly independent positions without recomputing
+ * the hash.  Because h2 is odd, the first 512 positions are distinct.
+ */
+
+template <typename KeyType>
+void BloomFilter<KeyType>::computeMask(const KeyType & key, int & block,
+                                       uint64_t mask[]) const {
+   uint64_t h = (uint32_t) hashFn(key);
+   h += 0x9E3779B97F4A7C15ULL;
+   h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+   h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+   h ^= h >> 31;
+   block = (int) (((h >> 32) * (uint64_t) nBlocks) >> 32);
+   uint32_t h1 = (uint32_t) h & 0xFFFF;
+   uint32_t h2 = ((uint32_t) h >> 16) | 1;
+   for (int i = 0; i < BLOCK_WORDS; i++) {
+      mask[i] = 0;
+   }
+   for (int i = 0; i < nHashes; i++) {
+      uint32_t bit = (h1 + i * h2) % BLOCK_BITS;
+      mask[bit / 64] |= (uint64_t) 1 << (bit % 64);
+   }
+}
+
+#endif
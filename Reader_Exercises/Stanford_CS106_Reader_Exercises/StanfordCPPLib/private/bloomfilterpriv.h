@@ -0,0 +1,93 @@
+/*
+ * File: bloomfilterpriv.h
+ * -----------------------
+ * This file contains the private section of the bloomfilter.h interface.
+ */
+
+/*
+ * Implementation notes: BloomFilter data structure
+ * ------------------------------------------------
+ * The filter is a <i>blocked</i> Bloom filter.  The bit array is divided
+ * into 512-bit blocks, each of which is the size of a typical cache line
+ * and is aligned on a 64-byte boundary.  A key selects exactly one block,
+ * and all of the bits for that key are set within that block, so that a
+ * query costs one memory access no matter how many hash functions are in
+ * use.  Each block is stored as eight 64-bit words; the query builds an
+ * eight-word mask and compares it against the block in a fixed-length
+ * loop that the compiler can turn into vector instructions.  The tuning
+ * counters are changed only through the atomic operations in atomic.h,
+ * so the const methods remain safe to call from several threads.
+ */
+
+private:
+
+/* Constants */
+
+   static const int BLOCK_WORDS = 8;        /* 64-bit words in a block    */
+   static const int BLOCK_BITS = 512;       /* Bits in a block            */
+   static const int BLOCK_ALIGNMENT = 64;   /* Bytes in a cache line      */
+   static const int MAX_HASHES = 16;        /* Upper bound on bits/key    */
+
+/* Type used for each block of the filter */
+
+   struct Block {
+      uint64_t words[BLOCK_WORDS];
+   };
+
+/* Instance variables */
+
+   char *storage;                       /* Unaligned allocation           */
+   Block *blocks;                       /* Aligned array of blocks        */
+   int nBlocks;                         /* Number of blocks in the array  */
+   int nHashes;                         /* Bits set for each key          */
+   int expectedSize;                    /* Keys the filter was sized for  */
+   int nKeys;                           /* Keys added since last clear    */
+   double falsePositiveRate;            /* Rate requested by the client   */
+   int (*hashFn)(const KeyType &);      /* Function used to hash keys     */
+   mutable long nQueries;               /* Calls to mightContain          */
+   mutable long nRejects;               /* Queries answered false         */
+   mutable long nFalsePositives;        /* Misses reported by the client  */
+
+/* Private methods */
+
+   void allocateBlocks(int expectedSize);
+   void computeMask(const KeyType & key, int & block, uint64_t mask[]) const;
+
+   static int bloomHashCode(const KeyType & key) {
+      return hashCode(key);
+   }
+
+/*
+ * Deep copying support
+ * --------------------
+ * This copy constructor and operator= are defined to make a
+ * deep copy, making it possible to pass/return filters by value
+ * and assign from one filter to another.
+ */
+
+   void copyInternalData(const BloomFilter & other) {
+      falsePositiveRate = other.falsePositiveRate;
+      hashFn = other.hashFn;
+      allocateBlocks(other.expectedSize);
+      for (int i = 0; i < nBlocks; i++) {
+         blocks[i] = other.blocks[i];
+      }
+      nKeys = other.nKeys;
+      nQueries = other.nQueries;
+      nRejects = other.nRejects;
+      nFalsePositives = other.nFalsePositives;
+   }
+
+public:
+
+   BloomFilter & operator=(const BloomFilter & rhs) {
+      if (this != &rhs) {
+         delete[] storage;
+         copyInternalData(rhs);
+      }
+      return *this;
+   }
+
+   BloomFilter(const BloomFilter & rhs) {
+      copyInternalData(rhs);
+   }
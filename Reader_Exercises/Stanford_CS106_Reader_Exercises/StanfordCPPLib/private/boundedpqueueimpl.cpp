@@ -0,0 +1,161 @@
+/*
+ * File: boundedpqueueimpl.cpp
+ * ---------------------------
+ * This file contains the implementation of the boundedpqueue.h
+ * interface.  Because of the way C++ compiles templates, this code
+ * must be available to the compiler when it reads the header file.
+ */
+
+#ifdef _boundedpqueue_h
+
+template <typename ValueType,typename PriorityType,typename Compare>
+BoundedPriorityQueue<ValueType,PriorityType,Compare>::BoundedPriorityQueue(
+        int bound) {
+   if (bound <= 0) {
+      error("BoundedPriorityQueue: bound must be positive");
+   }
+   this->bound = bound;
+   heap = new HeapEntry[bound];
+   values = new ValueType[bound];
+   enqueueCount = 0;
+   count = 0;
+}
+
+template <typename ValueType,typename PriorityType,typename Compare>
+BoundedPriorityQueue<ValueType,PriorityType,Compare>::~BoundedPriorityQueue() {
+   deleteInternalData();
+}
+
+template <typename ValueType,typename PriorityType,typename Compare>
+int BoundedPriorityQueue<ValueType,PriorityType,Compare>::size() const {
+   return count;
+}
+
+template <typename ValueType,typename PriorityType,typename Compare>
+bool BoundedPriorityQueue<ValueType,PriorityType,Compare>::isEmpty() const {
+   return count == 0;
+}
+
+template <typename ValueType,typename PriorityType,typename Compare>
+bool BoundedPriorityQueue<ValueType,PriorityType,Compare>::isFull() const {
+   return count == bound;
+}
+
+template <typename ValueType,typename PriorityType,typename Compare>
+int BoundedPriorityQueue<ValueType,PriorityType,Compare>::getBound() const {
+   return bound;
+}
+
+template <typename ValueType,typename PriorityType,typename Compare>
+void BoundedPriorityQueue<ValueType,PriorityType,Compare>::clear() {
+   count = 0;
+}
+
+/*
+ * Implementation notes: enqueue
+ * -----------------------------
+ * Until the queue is full, slots are handed out in order and each new
+ * entry is sifted up.  After that, a new entry is compared against the
+ * root.  Because the new entry has the largest sequence number so far,
+ * it must rank strictly ahead of the root's priority to be accepted,
+ * in which case it reuses the root's slot and is sifted down.
+ */
+
+template <typename ValueType,typename PriorityType,typename Compare>
+bool
+BoundedPriorityQueue<ValueType,PriorityType,Compare>::enqueue(ValueType value,
+        const PriorityType & priority) {
+   HeapEntry entry;
+   entry.priority = priority;
+   entry.sequence = enqueueCount;
+   if (count < bound) {
+      entry.slot = count;
+      values[entry.slot] = value;
+      siftUp(count++, entry);
+   } else {
+      if (!cmp(priority, heap[0].priority)) return false;
+      entry.slot = heap[0].slot;
+      values[entry.slot] = value;
+      siftDown(0, entry);
+   }
+   enqueueCount++;
+   return true;
+}
+
+template <typename ValueType,typename PriorityType,typename Compare>
+ValueType
+BoundedPriorityQueue<ValueType,PriorityType,Compare>::peekWorst() const {
+   if (count == 0) error("peekWorst: Attempting to peek at an empty queue");
+   return values[heap[0].slot];
+}
+
+template <typename ValueType,typename PriorityType,typename Compare>
+PriorityType
+BoundedPriorityQueue<ValueType,PriorityType,Compare>::worstPriority() const {
+   if (count == 0) {
+      error("worstPriority: Attempting to peek at an empty queue");
+   }
+   return heap[0].priority;
+}
+
+/*
+ * Implementation notes: drainSorted
+ * ---------------------------------
+ * The root of the inverted heap is always the worst remaining entry,
+ * so removing the root repeatedly yields the entries in reverse order.
+ * The result is filled from the back to put the best value first.
+ */
+
+template <typename ValueType,typename PriorityType,typename Compare>
+Vector<ValueType>
+BoundedPriorityQueue<ValueType,PriorityType,Compare>::drainSorted() {
+   Vector<ValueType> result(count);
+   while (count > 0) {
+      result[count - 1] = values[heap[0].slot];
+      count--;
+      if (count > 0) siftDown(0, heap[count]);
+   }
+   return result;
+}
+
+/*
+ * Implementation notes: siftUp, siftDown
+ * --------------------------------------
+ * These methods are the same as the ones in PriorityQueue, except that
+ * entries that rank lower move toward the root.
+ */
+
+template <typename ValueType,typename PriorityType,typename Compare>
+void
+BoundedPriorityQueue<ValueType,PriorityType,Compare>::siftUp(int index,
+        HeapEntry entry) {
+   while (index > 0) {
+      int parent = (index - 1) / HEAP_ARITY;
+      if (!ranksBelow(entry, heap[parent])) break;
+      heap[index] = heap[parent];
+      index = parent;
+   }
+   heap[index] = entry;
+}
+
+template <typename ValueType,typename PriorityType,typename Compare>
+void
+BoundedPriorityQueue<ValueType,PriorityType,Compare>::siftDown(int index,
+        HeapEntry entry) {
+   while (true) {
+      int first = HEAP_ARITY * index + 1;
+      if (first >= count) break;
+      int last = first + HEAP_ARITY;
+      if (last > count) last = count;
+      int worst = first;
+      for (int child = first + 1; child < last; child++) {
+         if (ranksBelow(heap[child], heap[worst])) worst = child;
+      }
+      if (!ranksBelow(heap[worst], entry)) break;
+      heap[index] = heap[worst];
+      index = worst;
+   }
+   heap[index] = entry;
+}
+
+#endif
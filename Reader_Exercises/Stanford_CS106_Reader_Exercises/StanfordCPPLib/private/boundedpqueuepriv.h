@@ -0,0 +1,110 @@
+/*
+ * File: boundedpqueuepriv.h
+ * -------------------------
+ * This file contains the private section of the boundedpqueue.h
+ * interface.
+ */
+
+/*
+ * Implementation notes: BoundedPriorityQueue data structure
+ * ---------------------------------------------------------
+ * The queue is a 4-ary heap organized like the one in PriorityQueue,
+ * except that the heap is inverted so that its root holds the worst
+ * entry rather than the best.  That entry is the only one a new value
+ * needs to beat, so rejecting a value requires a single comparison,
+ * and accepting one replaces the root and sifts it down.  Each value
+ * lives in a fixed slot; a value that displaces the root simply takes
+ * over the root's slot, so the arrays never change size.
+ */
+
+private:
+
+/* Constants */
+
+   static const int HEAP_ARITY = 4;
+
+/* Type used for each heap entry */
+
+   struct HeapEntry {
+      PriorityType priority;
+      long sequence;
+      int slot;
+   };
+
+/* Instance variables */
+
+   Compare cmp;              /* Ordering applied to the priorities       */
+   HeapEntry *heap;          /* The inverted heap, worst entry first     */
+   ValueType *values;        /* The values, indexed by slot              */
+   long enqueueCount;        /* Sequence number for the next enqueue     */
+   int count;                /* Number of entries in the heap            */
+   int bound;                /* Maximum number of entries                */
+
+/* Private function prototypes */
+
+   void siftUp(int index, HeapEntry entry);
+   void siftDown(int index, HeapEntry entry);
+
+/*
+ * Private method: ranksBelow
+ * Usage: if (ranksBelow(e1, e2)) . . .
+ * ------------------------------------
+ * Returns true if entry e1 would be dequeued after entry e2 by a
+ * PriorityQueue, which means that e1 belongs nearer the root of the
+ * inverted heap.
+ */
+
+   bool ranksBelow(const HeapEntry & e1, const HeapEntry & e2) const {
+      if (cmp(e2.priority, e1.priority)) return true;
+      if (cmp(e1.priority, e2.priority)) return false;
+      return e2.sequence < e1.sequence;
+   }
+
+/*
+ * Hidden features
+ * ---------------
+ * The remainder of this file consists of the code required to
+ * support deep copying.  Including these methods in the public
+ * interface would make that interface more difficult to understand
+ * for the average client.
+ */
+
+/*
+ * Deep copying support
+ * --------------------
+ * This copy constructor and operator= are defined to make a
+ * deep copy, making it possible to pass/return priority queues
+ * by value and assign from one priority queue to another.
+ */
+
+   void copyInternalData(const BoundedPriorityQueue & pq) {
+      cmp = pq.cmp;
+      bound = pq.bound;
+      count = pq.count;
+      enqueueCount = pq.enqueueCount;
+      heap = new HeapEntry[bound];
+      values = new ValueType[bound];
+      for (int i = 0; i < count; i++) {
+         heap[i] = pq.heap[i];
+         values[i] = pq.values[i];
+      }
+   }
+
+   void deleteInternalData() {
+      delete[] heap;
+      delete[] values;
+   }
+
+public:
+
+   BoundedPriorityQueue & operator=(const BoundedPriorityQueue & rhs) {
+      if (this != &rhs) {
+         deleteInternalData();
+         copyInternalData(rhs);
+      }
+      return *this;
+   }
+
+   BoundedPriorityQueue(const BoundedPriorityQueue & rhs) {
+      copyInternalData(rhs);
+   }
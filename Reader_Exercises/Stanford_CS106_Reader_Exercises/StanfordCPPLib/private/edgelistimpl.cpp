@@ -0,0 +1,551 @@
+/*
+ * File: edgelistimpl.cpp
+ * ----------------------
+ * This file contains the implementation of the edgelist.h interface.
+ * The methods are declared inline so that the file can be included by
+ * more than one source file, and the template methods must in any case
+ * be available to the compiler when it reads the header file.
+ */
+
+#ifdef _edgelist_h
+
+#include <cstdlib>
+#include <cstring>
+
+inline EdgeList::EdgeList() {
+   starts = NULL;
+   finishes = NULL;
+   weights = NULL;
+   count = 0;
+}
+
+inline EdgeList::~EdgeList() {
+   clear();
+}
+
+inline void EdgeList::clear() {
+   names.clear();
+   delete[] starts;
+   delete[] finishes;
+   delete[] weights;
+   starts = NULL;
+   finishes = NULL;
+   weights = NULL;
+   count = 0;
+}
+
+inline int EdgeList::size() const {
+   return count;
+}
+
+inline int EdgeList::getNodeCount() const {
+   return names.size();
+}
+
+inline const SymbolTable & EdgeList::getNames() const {
+   return names;
+}
+
+inline int EdgeList::getStart(int i) const {
+   checkArc(i, "getStart");
+   return starts[i];
+}
+
+inline int EdgeList::getFinish(int i) const {
+   checkArc(i, "getFinish");
+   return finishes[i];
+}
+
+inline double EdgeList::getWeight(int i) const {
+   checkArc(i, "getWeight");
+   return (weights == NULL) ? 1.0 : weights[i];
+}
+
+inline bool EdgeList::hasWeights() const {
+   return weights != NULL;
+}
+
+inline void EdgeList::read(const std::string & filename) {
+   FILE *file = fopen(filename.c_str(), "rb");
+   if (file == NULL) error("read: Can't open " + filename);
+   int32_t magic = 0;
+   bool binary = fread(&magic, sizeof magic, 1, file) == 1
+              && magic == MAGIC_NUMBER;
+   fclose(file);
+   if (binary) {
+      readBinary(filename);
+   } else {
+      readText(filename);
+   }
+}
+
+inline void EdgeList::readText(const std::string & filename) {
+   readText(filename, getDefaultThreadPool());
+}
+
+/*
+ * Implementation notes: readText
+ * ------------------------------
+ * The file is read BLOCK_SIZE bytes at a time, or all at once if it
+ * is smaller than that, so that reading a short file does not allocate
+ * the full block.  Each block is cut after its last newline, and the
+ * partial line that follows is moved to the front of the buffer to
+ * begin the next block.  The complete lines are divided into segments
+ * at newlines and parsed in parallel.  Each segment records its first
+ * error instead of signaling it, and the segments are checked in file
+ * order once the threads finish so that the error reported is the
+ * first one in the file.  Every error found while reading is kept in
+ * msg and signaled only after the buffers and parse states are freed.
+ */
+
+inline void EdgeList::readText(const std::string & filename,
+                               ThreadPool & pool) {
+   FILE *file = fopen(filename.c_str(), "rb");
+   if (file == NULL) error("readText: Can't open " + filename);
+   clear();
+   int nThreads = pool.getThreadCount();
+   ParseState *states = new ParseState[nThreads];
+   for (int i = 0; i < nThreads; i++) {
+      initState(states[i]);
+   }
+   Vector<Segment> all;
+   int blockSize = BLOCK_SIZE;
+   if (fseek(file, 0, SEEK_END) == 0) {
+      long size = ftell(file);
+      if (size >= 0 && size < BLOCK_SIZE) blockSize = int(size) + 1;
+      rewind(file);
+   }
+   char *buffer = new char[blockSize + 1];
+   std::string msg = "";
+   int carry = 0;
+   int lineNumber = 1;
+   bool done = false;
+   while (!done && msg == "") {
+      int nRead = int(fread(buffer + carry, 1, blockSize - carry, file));
+      int total = carry + nRead;
+      done = total < blockSize;
+      buffer[total] = '\0';
+      int end = total;
+      if (!done) {
+         while (end > 0 && buffer[end - 1] != '\n') {
+            end--;
+         }
+         if (end == 0) {
+            msg = "Line is too long on line " + integerToString(lineNumber);
+            break;
+         }
+      }
+      int nSegments = end / MIN_SEGMENT;
+      if (nSegments < 1) nSegments = 1;
+      if (nSegments > nThreads) nSegments = nThreads;
+      Vector<Segment> block;
+      const char *cp = buffer;
+      for (int i = 0; i < nSegments; i++) {
+         const char *limit = buffer + end;
+         if (i < nSegments - 1) {
+            limit = buffer + (long long) end * (i + 1) / nSegments;
+            if (limit < cp) limit = cp;
+            while (limit < buffer + end && limit[-1] != '\n') {
+               limit++;
+            }
+         }
+         Segment seg;
+         seg.thread = i;
+         seg.start = cp;
+         seg.end = limit;
+         block.add(seg);
+         cp = limit;
+      }
+      ParseTask task;
+      task.states = states;
+      task.segments = &block;
+      task.list = this;
+      if (nSegments > 1) {
+         pool.runParallel(parseSegments, task, nSegments);
+      } else {
+         parseSegments(task, 0);
+      }
+      for (int i = 0; i < nSegments; i++) {
+         Segment & seg = block[i];
+         if (seg.errorLine >= 0) {
+            msg = std::string(seg.errorMessage) + " on line "
+                + integerToString(lineNumber + seg.errorLine);
+            break;
+         }
+         lineNumber += seg.nLines;
+         all.add(seg);
+      }
+      carry = total - end;
+      memmove(buffer, buffer + end, carry);
+   }
+   if (msg == "" && ferror(file)) msg = "Error reading " + filename;
+   fclose(file);
+   delete[] buffer;
+   bool anyWeights = false;
+   for (int i = 0; i < nThreads; i++) {
+      if (states[i].anyWeights) anyWeights = true;
+   }
+   if (msg == "") msg = mergeStates(states, nThreads, all, anyWeights, pool);
+   for (int i = 0; i < nThreads; i++) {
+      freeState(states[i]);
+   }
+   delete[] states;
+   if (msg != "") {
+      clear();
+      error("readText: " + msg);
+   }
+}
+
+inline void EdgeList::readBinary(const std::string & filename) {
+   FILE *file = fopen(filename.c_str(), "rb");
+   if (file == NULL) error("readBinary: Can't open " + filename);
+   clear();
+   int32_t header[5];
+   readBytes(file, header, sizeof header);
+   if (header[0] != MAGIC_NUMBER) {
+      failRead(file, "readBinary: " + filename + " is not an edge list");
+   }
+   if (header[1] != VERSION) {
+      failRead(file, "readBinary: Unsupported version in " + filename);
+   }
+   int nNames = header[3];
+   int nArcs = header[4];
+   if (nNames < 0 || nArcs < 0) {
+      failRead(file, "readBinary: Illegal header in " + filename);
+   }
+   std::string name;
+   for (int id = 0; id < nNames; id++) {
+      int32_t length;
+      readBytes(file, &length, sizeof length);
+      if (length < 0) failRead(file, "readBinary: Illegal name length");
+      name.resize(length);
+      if (length > 0) readBytes(file, &name[0], length);
+      if (names.intern(name) != id) {
+         failRead(file, "readBinary: Duplicate name " + name);
+      }
+   }
+   count = nArcs;
+   starts = new int[nArcs];
+   finishes = new int[nArcs];
+   readBytes(file, starts, nArcs * sizeof(int));
+   readBytes(file, finishes, nArcs * sizeof(int));
+   if (header[2] & 1) {
+      weights = new double[nArcs];
+      readBytes(file, weights, nArcs * sizeof(double));
+   }
+   fclose(file);
+   for (int i = 0; i < nArcs; i++) {
+      if (starts[i] < 0 || starts[i] >= nNames
+          || finishes[i] < 0 || finishes[i] >= nNames) {
+         clear();
+         error("readBinary: Illegal node id in " + filename);
+      }
+   }
+}
+
+inline void EdgeList::writeBinary(const std::string & filename) const {
+   FILE *file = fopen(filename.c_str(), "wb");
+   if (file == NULL) error("writeBinary: Can't open " + filename);
+   int32_t header[5];
+   header[0] = MAGIC_NUMBER;
+   header[1] = VERSION;
+   header[2] = (weights == NULL) ? 0 : 1;
+   header[3] = names.size();
+   header[4] = count;
+   writeBytes(file, header, sizeof header);
+   for (int id = 0; id < names.size(); id++) {
+      const std::string & name = names.getName(id);
+      int32_t length = int32_t(name.length());
+      writeBytes(file, &length, sizeof length);
+      writeBytes(file, name.data(), length);
+   }
+   writeBytes(file, starts, count * sizeof(int));
+   writeBytes(file, finishes, count * sizeof(int));
+   if (weights != NULL) writeBytes(file, weights, count * sizeof(double));
+   if (fclose(file) != 0) error("writeBinary: Error writing " + filename);
+}
+
+/*
+ * Implementation notes: addToGraph
+ * --------------------------------
+ * Each name is looked up once to find or create its node.  If every
+ * node has the same id in the graph as in the list, which is always
+ * true when the graph starts out empty, the id arrays of the list are
+ * passed to addArcs directly; otherwise they are first translated into
+ * the ids of the graph.  The arc pointers are collected only if there
+ * is a weight setter to call.
+ */
+
+template <typename NodeType,typename ArcType>
+void EdgeList::addToGraph(Graph<NodeType,ArcType> & g) const {
+   addArcsToGraph(g, (ArcType **) NULL);
+}
+
+template <typename NodeType,typename ArcType,typename WeightSetter>
+void EdgeList::addToGraph(Graph<NodeType,ArcType> & g,
+                          WeightSetter setWeight) const {
+   ArcType **arcs = new ArcType *[count];
+   addArcsToGraph(g, arcs);
+   for (int i = 0; i < count; i++) {
+      setWeight(arcs[i], (weights == NULL) ? 1.0 : weights[i]);
+   }
+   delete[] arcs;
+}
+
+template <typename NodeType,typename ArcType>
+void EdgeList::addArcsToGraph(Graph<NodeType,ArcType> & g,
+                              ArcType **arcs) const {
+   int nNodes = names.size();
+   int *idOf = new int[nNodes];
+   bool sameIds = true;
+   for (int id = 0; id < nNodes; id++) {
+      const std::string & name = names.getName(id);
+      if (!g.nodeExists(name)) g.addNode(name);
+      idOf[id] = g.getNodeId(name);
+      if (idOf[id] != id) sameIds = false;
+   }
+   if (sameIds) {
+      g.addArcs(starts, finishes, count, arcs);
+   } else {
+      int *ids1 = new int[count];
+      int *ids2 = new int[count];
+      for (int i = 0; i < count; i++) {
+         ids1[i] = idOf[starts[i]];
+         ids2[i] = idOf[finishes[i]];
+      }
+      g.addArcs(ids1, ids2, count, arcs);
+      delete[] ids1;
+      delete[] ids2;
+   }
+   delete[] idOf;
+}
+
+inline void EdgeList::checkArc(int i, std::string caller) const {
+   if (i < 0 || i >= count) {
+      error(caller + ": Arc index " + integerToString(i) + " out of range");
+   }
+}
+
+/*
+ * Implementation notes: mergeStates
+ * ---------------------------------
+ * Going through the segments in file order, each local name that first
+ * appears in a segment is entered in the global table, which gives it
+ * the same id it would have had if one thread had read the whole file.
+ * The number of arcs in each segment then determines where its arcs
+ * belong in the final arrays, and each thread copies the arcs from its
+ * own segments, translating their ids as it goes.  Errors are returned
+ * as a message rather than signaled here, so that readText can free the
+ * parse states before it reports them.
+ */
+
+inline std::string EdgeList::mergeStates(ParseState *states, int nThreads,
+                                         Vector<Segment> & all,
+                                         bool anyWeights, ThreadPool & pool) {
+   for (int t = 0; t < nThreads; t++) {
+      states[t].globalIds = new int[states[t].names.size() + 1];
+   }
+   long long total = 0;
+   for (int i = 0; i < all.size(); i++) {
+      Segment & seg = all[i];
+      ParseState & state = states[seg.thread];
+      for (int id = seg.firstName; id < seg.endName; id++) {
+         state.globalIds[id] = names.intern(state.names.getName(id));
+      }
+      seg.offset = int(total);
+      total += seg.endArc - seg.firstArc;
+      if (total > INT_MAX) return "Too many arcs";
+   }
+   count = int(total);
+   starts = new int[count];
+   finishes = new int[count];
+   if (anyWeights) weights = new double[count];
+   ParseTask task;
+   task.states = states;
+   task.segments = &all;
+   task.list = this;
+   if (nThreads > 1) {
+      pool.runParallel(copySegments, task, nThreads);
+   } else {
+      copySegments(task, 0);
+   }
+   return "";
+}
+
+inline void EdgeList::parseSegments(ParseTask & task, int index) {
+   if (index < task.segments->size()) {
+      Segment & seg = (*task.segments)[index];
+      parseSegment(task.states[seg.thread], seg);
+   }
+}
+
+inline void EdgeList::copySegments(ParseTask & task, int index) {
+   EdgeList *list = task.list;
+   for (int i = 0; i < task.segments->size(); i++) {
+      Segment & seg = (*task.segments)[i];
+      if (seg.thread != index) continue;
+      ParseState & state = task.states[index];
+      int dst = seg.offset;
+      for (int j = seg.firstArc; j < seg.endArc; j++) {
+         list->starts[dst] = state.globalIds[state.starts[j]];
+         list->finishes[dst] = state.globalIds[state.finishes[j]];
+         if (list->weights != NULL) list->weights[dst] = state.weights[j];
+         dst++;
+      }
+   }
+}
+
+/*
+ * Implementation notes: parseSegment
+ * ----------------------------------
+ * The parser works directly on the characters in the buffer and
+ * interns each name from its position and length, so no string is
+ * created for a name that the thread has seen before.  The weight is
+ * converted by strtod, which cannot run past the end of the segment
+ * because every segment ends with a newline or with the null
+ * character that follows the last block.
+ */
+
+inline void EdgeList::parseSegment(ParseState & state, Segment & seg) {
+   seg.firstName = state.names.size();
+   seg.firstArc = state.count;
+   seg.nLines = 0;
+   seg.errorLine = -1;
+   seg.errorMessage = NULL;
+   const char *cp = seg.start;
+   const char *end = seg.end;
+   while (cp < end) {
+      while (cp < end && isBlank(*cp)) {
+         cp++;
+      }
+      if (cp < end && *cp != '\n' && *cp != '#') {
+         const char *s1 = cp;
+         while (cp < end && !isBlank(*cp) && *cp != '\n') {
+            cp++;
+         }
+         int n1 = int(cp - s1);
+         while (cp < end && isBlank(*cp)) {
+            cp++;
+         }
+         if (cp == end || *cp == '\n') {
+            seg.errorMessage = "Missing finish node";
+            break;
+         }
+         const char *s2 = cp;
+         while (cp < end && !isBlank(*cp) && *cp != '\n') {
+            cp++;
+         }
+         int n2 = int(cp - s2);
+         while (cp < end && isBlank(*cp)) {
+            cp++;
+         }
+         double weight = 1.0;
+         if (cp < end && *cp != '\n') {
+            char *next;
+            weight = strtod(cp, &next);
+            if (next == cp || (next < end && !isBlank(*next)
+                                          && *next != '\n')) {
+               seg.errorMessage = "Illegal weight";
+               break;
+            }
+            cp = next;
+            while (cp < end && isBlank(*cp)) {
+               cp++;
+            }
+            if (cp < end && *cp != '\n') {
+               seg.errorMessage = "Too many fields";
+               break;
+            }
+            state.anyWeights = true;
+         }
+         int start = state.names.intern(s1, n1);
+         int finish = state.names.intern(s2, n2);
+         addArc(state, start, finish, weight);
+      }
+      while (cp < end && *cp != '\n') {
+         cp++;
+      }
+      if (cp < end) cp++;
+      seg.nLines++;
+   }
+   if (seg.errorMessage != NULL) seg.errorLine = seg.nLines;
+   seg.endName = state.names.size();
+   seg.endArc = state.count;
+}
+
+inline void EdgeList::addArc(ParseState & state, int start, int finish,
+                             double weight) {
+   if (state.count == state.capacity) {
+      int capacity = (state.capacity == 0) ? 1024 : 2 * state.capacity;
+      int *newStarts = new int[capacity];
+      int *newFinishes = new int[capacity];
+      double *newWeights = new double[capacity];
+      if (state.count > 0) {
+         memcpy(newStarts, state.starts, state.count * sizeof(int));
+         memcpy(newFinishes, state.finishes, state.count * sizeof(int));
+         memcpy(newWeights, state.weights, state.count * sizeof(double));
+      }
+      delete[] state.starts;
+      delete[] state.finishes;
+      delete[] state.weights;
+      state.starts = newStarts;
+      state.finishes = newFinishes;
+      state.weights = newWeights;
+      state.capacity = capacity;
+   }
+   state.starts[state.count] = start;
+   state.finishes[state.count] = finish;
+   state.weights[state.count] = weight;
+   state.count++;
+}
+
+inline bool EdgeList::isBlank(char ch) {
+   return ch == ' ' || ch == '\t' || ch == '\r';
+}
+
+inline void EdgeList::initState(ParseState & state) {
+   state.starts = NULL;
+   state.finishes = NULL;
+   state.weights = NULL;
+   state.count = 0;
+   state.capacity = 0;
+   state.anyWeights = false;
+   state.globalIds = NULL;
+}
+
+inline void EdgeList::freeState(ParseState & state) {
+   delete[] state.starts;
+   delete[] state.finishes;
+   delete[] state.weights;
+   delete[] state.globalIds;
+   initState(state);
+}
+
+inline void EdgeList::readBytes(FILE *file, void *dst, size_t n) {
+   if (fread(dst, 1, n, file) != n) {
+      failRead(file, "readBinary: File is truncated");
+   }
+}
+
+inline void EdgeList::writeBytes(FILE *file, const void *src, size_t n) {
+   if (fwrite(src, 1, n, file) != n) {
+      fclose(file);
+      error("writeBinary: Error writing file");
+   }
+}
+
+/*
+ * Implementation notes: failRead
+ * ------------------------------
+ * This method closes the file and empties the list before signaling
+ * the error, so that a client that catches the error is left with an
+ * empty list rather than a partial one.
+ */
+
+inline void EdgeList::failRead(FILE *file, std::string msg) {
+   fclose(file);
+   clear();
+   error(msg);
+}
+
+#endif
@@ -0,0 +1,103 @@
+/*
+ * File: edgelistpriv.h
+ * --------------------
+ * This file contains the private section of the edgelist.h interface.
+ */
+
+/*
+ * Implementation notes: EdgeList data structure
+ * ---------------------------------------------
+ * The finished list consists of the symbol table and three arrays,
+ * each allocated once at its final size.  While a text file is being
+ * read, each thread keeps a ParseState with a symbol table of its own
+ * and growing arrays of arcs that use that table's ids.  Each block of
+ * the file is split into one Segment per thread, and the segments,
+ * kept in file order, record which of the thread's local ids and arcs
+ * came from that part of the file.  Merging the segments in order
+ * gives every name its global id in order of first appearance.
+ */
+
+private:
+
+/* Constants */
+
+   static const int BLOCK_SIZE = 1 << 25;   /* Bytes read at a time      */
+   static const int MIN_SEGMENT = 1 << 16;  /* Bytes worth a new thread  */
+   static const int MAGIC_NUMBER = 0x4c474445; /* "EDGL" in a binary file */
+   static const int VERSION = 1;            /* Binary format version     */
+
+/* Type used for the arcs found by one thread */
+
+   struct ParseState {
+      SymbolTable names;          /* Names with thread-local ids          */
+      int *starts;                /* Local id of the start of each arc    */
+      int *finishes;              /* Local id of the finish of each arc   */
+      double *weights;            /* Weight of each arc                   */
+      int count;                  /* Number of arcs                       */
+      int capacity;               /* Allocated size of the arrays         */
+      bool anyWeights;            /* True if any line gave a weight       */
+      int *globalIds;             /* Global id for each local id          */
+   };
+
+/* Type used for the part of a block parsed by one thread */
+
+   struct Segment {
+      int thread;                 /* Index of the thread that parses it   */
+      const char *start;          /* First character of the segment       */
+      const char *end;            /* Character after the segment          */
+      int firstName;              /* Local names before the segment       */
+      int endName;                /* Local names after the segment        */
+      int firstArc;               /* Local arcs before the segment        */
+      int endArc;                 /* Local arcs after the segment         */
+      int nLines;                 /* Lines in the segment                 */
+      int errorLine;              /* Line of the first error, or -1       */
+      const char *errorMessage;   /* Description of that error            */
+      int offset;                 /* Position of the first arc in result  */
+   };
+
+/* Type used to pass a block to the threads */
+
+   struct ParseTask {
+      ParseState *states;         /* The state of each thread             */
+      Vector<Segment> *segments;  /* The segments to process              */
+      EdgeList *list;             /* The list being built                 */
+   };
+
+/* Instance variables */
+
+   SymbolTable names;             /* The node names                       */
+   int *starts;                   /* Node id at the start of each arc     */
+   int *finishes;                 /* Node id at the finish of each arc    */
+   double *weights;               /* Weight of each arc, or NULL          */
+   int count;                     /* Number of arcs                       */
+
+/* Private method prototypes */
+
+   void checkArc(int i, std::string caller) const;
+   template <typename NodeType,typename ArcType>
+   void addArcsToGraph(Graph<NodeType,ArcType> & g, ArcType **arcs) const;
+   std::string mergeStates(ParseState *states, int nThreads,
+                           Vector<Segment> & all, bool anyWeights,
+                           ThreadPool & pool);
+   static void parseSegments(ParseTask & task, int index);
+   static void copySegments(ParseTask & task, int index);
+   static void parseSegment(ParseState & state, Segment & seg);
+   static void addArc(ParseState & state, int start, int finish,
+                      double weight);
+   static bool isBlank(char ch);
+   static void initState(ParseState & state);
+   static void freeState(ParseState & state);
+   void readBytes(FILE *file, void *dst, size_t n);
+   void failRead(FILE *file, std::string msg);
+   static void writeBytes(FILE *file, const void *src, size_t n);
+
+/*
+ * Hidden features
+ * ---------------
+ * An edge list may hold hundreds of millions of arcs, so the copy
+ * constructor and assignment operator are declared private and are
+ * never defined.
+ */
+
+   EdgeList(const EdgeList & src);
+   EdgeList & operator=(const EdgeList & src);
@@ -0,0 +1,313 @@
+/*
+ * File: frozengraphimpl.cpp
+ * -------------------------
+ * This file contains the implementation of the frozengraph.h interface.
+ * Because of the way C++ compiles templates, this code must be
+ * available to the compiler when it reads the header file.
+ */
+
+#ifdef _frozengraph_h
+
+template <typename NodeType,typename ArcType>
+FrozenGraph<NodeType,ArcType>::FrozenGraph() {
+   initEmpty();
+}
+
+template <typename NodeType,typename ArcType>
+FrozenGraph<NodeType,ArcType>::FrozenGraph(Graph<NodeType,ArcType> & g) {
+   build(g);
+}
+
+template <typename NodeType,typename ArcType>
+template <typename WeightFunction>
+FrozenGraph<NodeType,ArcType>::FrozenGraph(Graph<NodeType,ArcType> & g,
+                                           WeightFunction weightFn) {
+   build(g);
+   outWeights = new double[nArcs];
+   for (int i = 0; i < nArcs; i++) {
+      outWeights[i] = weightFn(arcs[i]);
+   }
+}
+
+template <typename NodeType,typename ArcType>
+FrozenGraph<NodeType,ArcType>::~FrozenGraph() {
+   freeArrays();
+}
+
+template <typename NodeType,typename ArcType>
+int FrozenGraph<NodeType,ArcType>::size() const {
+   return nNodes;
+}
+
+template <typename NodeType,typename ArcType>
+int FrozenGraph<NodeType,ArcType>::getArcCount() const {
+   return nArcs;
+}
+
+template <typename NodeType,typename ArcType>
+NodeType *FrozenGraph<NodeType,ArcType>::getNode(int id) const {
+   checkId(id, "getNode");
+   return nodes[id];
+}
+
+template <typename NodeType,typename ArcType>
+int FrozenGraph<NodeType,ArcType>::getId(NodeType *node) const {
+   int slot = findSlot(node);
+   if (hashKeys[slot] == NULL) error("getId: Node is not in the graph");
+   return hashIds[slot];
+}
+
+template <typename NodeType,typename ArcType>
+bool FrozenGraph<NodeType,ArcType>::containsNode(NodeType *node) const {
+   return node != NULL && hashKeys[findSlot(node)] != NULL;
+}
+
+template <typename NodeType,typename ArcType>
+int FrozenGraph<NodeType,ArcType>::getOutDegree(int id) const {
+   checkId(id, "getOutDegree");
+   return outOffsets[id + 1] - outOffsets[id];
+}
+
+template <typename NodeType,typename ArcType>
+int FrozenGraph<NodeType,ArcType>::getInDegree(int id) const {
+   checkId(id, "getInDegree");
+   return inOffsets[id + 1] - inOffsets[id];
+}
+
+template <typename NodeType,typename ArcType>
+const int *FrozenGraph<NodeType,ArcType>::getOutOffsets() const {
+   return outOffsets;
+}
+
+template <typename NodeType,typename ArcType>
+const int *FrozenGraph<NodeType,ArcType>::getOutTargets() const {
+   return outTargets;
+}
+
+template <typename NodeType,typename ArcType>
+const double *FrozenGraph<NodeType,ArcType>::getOutWeights() const {
+   return outWeights;
+}
+
+template <typename NodeType,typename ArcType>
+const int *FrozenGraph<NodeType,ArcType>::getInOffsets() const {
+   return inOffsets;
+}
+
+template <typename NodeType,typename ArcType>
+const int *FrozenGraph<NodeType,ArcType>::getInSources() const {
+   return inSources;
+}
+
+template <typename NodeType,typename ArcType>
+const int *FrozenGraph<NodeType,ArcType>::getInArcs() const {
+   return inArcs;
+}
+
+template <typename NodeType,typename ArcType>
+ArcType *FrozenGraph<NodeType,ArcType>::getArc(int i) const {
+   checkArc(i, "getArc");
+   return arcs[i];
+}
+
+/*
+ * Implementation notes: getStart
+ * ------------------------------
+ * The start node of arc i is the last node whose first outgoing arc is
+ * at or before i.  Nodes with no arcs share their offset with the next
+ * node, so the search looks for the last matching offset rather than
+ * the first.
+ */
+
+template <typename NodeType,typename ArcType>
+int FrozenGraph<NodeType,ArcType>::getStart(int i) const {
+   checkArc(i, "getStart");
+   int lh = 0;
+   int rh = nNodes - 1;
+   while (lh < rh) {
+      int mid = lh + (rh - lh + 1) / 2;
+      if (outOffsets[mid] <= i) {
+         lh = mid;
+      } else {
+         rh = mid - 1;
+      }
+   }
+   return lh;
+}
+
+template <typename NodeType,typename ArcType>
+int FrozenGraph<NodeType,ArcType>::getTarget(int i) const {
+   checkArc(i, "getTarget");
+   return outTargets[i];
+}
+
+template <typename NodeType,typename ArcType>
+double FrozenGraph<NodeType,ArcType>::getWeight(int i) const {
+   checkArc(i, "getWeight");
+   return (outWeights == NULL) ? 1.0 : outWeights[i];
+}
+
+template <typename NodeType,typename ArcType>
+void FrozenGraph<NodeType,ArcType>::initEmpty() {
+   nNodes = 0;
+   nArcs = 0;
+   nodes = NULL;
+   arcs = NULL;
+   outOffsets = new int[1];
+   outOffsets[0] = 0;
+   outTargets = NULL;
+   outWeights = NULL;
+   inOffsets = new int[1];
+   inOffsets[0] = 0;
+   inSources = NULL;
+   inArcs = NULL;
+   hashMask = 0;
+   hashKeys = new NodeType *[1];
+   hashKeys[0] = NULL;
+   hashIds = new int[1];
+}
+
+/*
+ * Implementation notes: build
+ * ---------------------------
+ * The outgoing index is built in two passes over the nodes: the first
+ * computes the offsets from the size of each arc set, and the second
+ * fills in the arcs in the order of that set.  The incoming index is
+ * then built from the outgoing one by a counting sort on the target,
+ * which processes the arcs in order of their start node and therefore
+ * leaves each node's incoming arcs sorted by source.
+ */
+
+template <typename NodeType,typename ArcType>
+void FrozenGraph<NodeType,ArcType>::build(Graph<NodeType,ArcType> & g) {
+   Set<NodeType *> & nodeSet = g.getNodeSet();
+   nNodes = nodeSet.size();
+   nodes = new NodeType *[nNodes];
+   outOffsets = new int[nNodes + 1];
+   outWeights = NULL;
+   int id = 0;
+   long total = 0;
+   typename Set<NodeType *>::iterator end = nodeSet.end();
+   for (typename Set<NodeType *>::iterator it = nodeSet.begin();
+        it != end; ++it) {
+      NodeType *node = *it;
+      nodes[id] = node;
+      outOffsets[id++] = int(total);
+      total += node->arcs.size();
+      if (total > 0x7FFFFFFF) error("freeze: Graph has too many arcs");
+   }
+   nArcs = int(total);
+   outOffsets[nNodes] = nArcs;
+   buildHashTable();
+   arcs = new ArcType *[nArcs];
+   outTargets = new int[nArcs];
+   for (int v = 0; v < nNodes; v++) {
+      int i = outOffsets[v];
+      Set<ArcType *> & arcSet = nodes[v]->arcs;
+      typename Set<ArcType *>::iterator arcEnd = arcSet.end();
+      for (typename Set<ArcType *>::iterator it = arcSet.begin();
+           it != arcEnd; ++it) {
+         ArcType *arc = *it;
+         int slot = findSlot(arc->finish);
+         if (hashKeys[slot] == NULL) {
+            error("freeze: Arc ends at a node that is not in the graph");
+         }
+         arcs[i] = arc;
+         outTargets[i++] = hashIds[slot];
+      }
+   }
+   inOffsets = new int[nNodes + 1];
+   inSources = new int[nArcs];
+   inArcs = new int[nArcs];
+   for (int v = 0; v <= nNodes; v++) {
+      inOffsets[v] = 0;
+   }
+   for (int i = 0; i < nArcs; i++) {
+      inOffsets[outTargets[i] + 1]++;
+   }
+   for (int v = 0; v < nNodes; v++) {
+      inOffsets[v + 1] += inOffsets[v];
+   }
+   int *next = new int[nNodes];
+   for (int v = 0; v < nNodes; v++) {
+      next[v] = inOffsets[v];
+   }
+   for (int v = 0; v < nNodes; v++) {
+      for (int i = outOffsets[v]; i < outOffsets[v + 1]; i++) {
+         int pos = next[outTargets[i]]++;
+         inSources[pos] = v;
+         inArcs[pos] = i;
+      }
+   }
+   delete[] next;
+}
+
+template <typename NodeType,typename ArcType>
+void FrozenGraph<NodeType,ArcType>::buildHashTable() {
+   int capacity = 2;
+   while (capacity < 2 * nNodes) {
+      capacity *= 2;
+   }
+   hashMask = capacity - 1;
+   hashKeys = new NodeType *[capacity];
+   hashIds = new int[capacity];
+   for (int i = 0; i < capacity; i++) {
+      hashKeys[i] = NULL;
+   }
+   for (int id = 0; id < nNodes; id++) {
+      int slot = findSlot(nodes[id]);
+      hashKeys[slot] = nodes[id];
+      hashIds[slot] = id;
+   }
+}
+
+/*
+ * Implementation notes: findSlot
+ * ------------------------------
+ * This method returns the slot that holds the node or, if the node is
+ * not in the table, the empty slot at which the search stopped.  The
+ * pointer is scrambled by multiplying it by a large odd constant, so
+ * that the alignment of heap blocks does not leave most slots unused.
+ */
+
+template <typename NodeType,typename ArcType>
+int FrozenGraph<NodeType,ArcType>::findSlot(NodeType *node) const {
+   uint64_t h = uint64_t(uintptr_t(node)) * 0x9E3779B97F4A7C15ULL;
+   int slot = int(h >> 32) & hashMask;
+   while (hashKeys[slot] != NULL && hashKeys[slot] != node) {
+      slot = (slot + 1) & hashMask;
+   }
+   return slot;
+}
+
+template <typename NodeType,typename ArcType>
+void FrozenGraph<NodeType,ArcType>::checkId(int id,
+                                            std::string caller) const {
+   if (id < 0 || id >= nNodes) {
+      error(caller + ": Node id is out of range");
+   }
+}
+
+template <typename NodeType,typename ArcType>
+void FrozenGraph<NodeType,ArcType>::checkArc(int i,
+                                             std::string caller) const {
+   if (i < 0 || i >= nArcs) {
+      error(caller + ": Arc number is out of range");
+   }
+}
+
+template <typename NodeType,typename ArcType>
+void FrozenGraph<NodeType,ArcType>::freeArrays() {
+   delete[] nodes;
+   delete[] arcs;
+   delete[] outOffsets;
+   delete[] outTargets;
+   delete[] outWeights;
+   delete[] inOffsets;
+   delete[] inSources;
+   delete[] inArcs;
+   delete[] hashKeys;
+   delete[] hashIds;
+}
+
+#endif
@@ -0,0 +1,102 @@
+/*
+ * File: frozengraphpriv.h
+ * -----------------------
+ * This file contains the private section of the frozengraph.h
+ * interface.
+ */
+
+/*
+ * Implementation notes: FrozenGraph data structure
+ * ------------------------------------------------
+ * The outgoing and incoming indices are each an array of offsets and
+ * one or more parallel arrays with one entry per arc.  The table that
+ * maps node pointers to ids uses open addressing with linear probing
+ * in two parallel arrays whose size is a power of two at least twice
+ * the number of nodes, so that a lookup rarely examines more than one
+ * or two slots.
+ */
+
+private:
+
+/* Instance variables */
+
+   int nNodes;                 /* The number of nodes                    */
+   int nArcs;                  /* The number of arcs                     */
+   NodeType **nodes;           /* The node with each id                  */
+   ArcType **arcs;             /* The arc with each number               */
+   int *outOffsets;            /* First outgoing arc of each node        */
+   int *outTargets;            /* The node at the end of each arc        */
+   double *outWeights;         /* The weight of each arc, or NULL        */
+   int *inOffsets;             /* First incoming entry of each node      */
+   int *inSources;             /* The start node of each incoming entry  */
+   int *inArcs;                /* The arc number of each incoming entry  */
+   NodeType **hashKeys;        /* Hash table slots, NULL if empty        */
+   int *hashIds;               /* The id stored with each key            */
+   int hashMask;               /* The number of slots minus one          */
+
+/* Private method prototypes */
+
+   void initEmpty();
+   void build(Graph<NodeType,ArcType> & g);
+   void buildHashTable();
+   int findSlot(NodeType *node) const;
+   void checkId(int id, std::string caller) const;
+   void checkArc(int i, std::string caller) const;
+   void freeArrays();
+
+/*
+ * Hidden features
+ * ---------------
+ * The remainder of this file consists of the code required to
+ * support deep copying.  Including these methods in the public
+ * interface would make that interface more difficult to understand
+ * for the average client.
+ */
+
+/*
+ * Deep copying support
+ * --------------------
+ * This copy constructor and operator= are defined to make a deep copy
+ * of the arrays, making it possible to pass and return snapshots by
+ * value.  The copy refers to the same nodes and arcs as the original.
+ */
+
+   template <typename ElementType>
+   static ElementType *copyArray(const ElementType *src, int n) {
+      if (src == NULL) return NULL;
+      ElementType *dst = new ElementType[n];
+      for (int i = 0; i < n; i++) {
+         dst[i] = src[i];
+      }
+      return dst;
+   }
+
+   void copyInternalData(const FrozenGraph & fg) {
+      nNodes = fg.nNodes;
+      nArcs = fg.nArcs;
+      hashMask = fg.hashMask;
+      nodes = copyArray(fg.nodes, nNodes);
+      arcs = copyArray(fg.arcs, nArcs);
+      outOffsets = copyArray(fg.outOffsets, nNodes + 1);
+      outTargets = copyArray(fg.outTargets, nArcs);
+      outWeights = copyArray(fg.outWeights, nArcs);
+      inOffsets = copyArray(fg.inOffsets, nNodes + 1);
+      inSources = copyArray(fg.inSources, nArcs);
+      inArcs = copyArray(fg.inArcs, nArcs);
+      hashKeys = copyArray(fg.hashKeys, hashMask + 1);
+      hashIds = copyArray(fg.hashIds, hashMask + 1);
+   }
+
+public:
+
+   FrozenGraph & operator=(const FrozenGraph & rhs) {
+      if (this != &rhs) {
+         freeArrays();
+         copyInternalData(rhs);
+      }
+      return *this;
+   }
+
+   FrozenGraph(const FrozenGraph & rhs) {
+      copyInternalData(rhs);
+   }
@@ -51,29 +51,30 @@ int arcCompare(ArcType *a1, ArcType *a2) {
 /*
  * Implementation notes: Graph constructor
  * ---------------------------------------
- * Even though the body of the Graph constructor is empty, important
- * work is done by the initializers, which ensure that the nodes and
- * arcs set are given the correct comparison functions.
+ * Most of the important work is done by the GraphData constructor,
+ * which ensures that the nodes and arcs set are given the correct
+ * comparison functions.  The adjacency index, arena allocation, and
+ * copy-on-write sharing are initially turned off.
  */
 
 template <typename NodeType,typename ArcType>
-Graph<NodeType,ArcType>::Graph() : nodes(nodeCompare<NodeType>),
-                                   arcs(arcCompare<NodeType,ArcType>) {
-   /* Empty */
+Graph<NodeType,ArcType>::Graph() {
+   data = new GraphData();
+   arenaMode = false;
+   copyOnWrite = false;
 }
 
 /*
  * Implementation notes: Graph destructor
  * --------------------------------------
  * The destructor must free all heap storage used by this graph to
- * represent the nodes and arcs.  The clear metho must also reclaim
- * this memory, which means that the destructor can simply call
- * clear to do the work.
+ * represent the nodes and arcs, unless another graph still shares
+ * that storage.  The releaseData method makes that decision.
  */
 
 template <typename NodeType,typename ArcType>
 Graph<NodeType,ArcType>::~Graph() {
-   clear();
+   releaseData(data);
 }
 
 /*
@@ -86,33 +87,29 @@ Graph<NodeType,ArcType>::~Graph() {
 
 template <typename NodeType,typename ArcType>
 int Graph<NodeType,ArcType>::size() {
-   return nodes.size();
+   return data->nodes.size();
 }
 
 template <typename NodeType,typename ArcType>
 bool Graph<NodeType,ArcType>::isEmpty() {
-   return nodes.isEmpty();
+   return data->nodes.isEmpty();
 }
 
 /*
  * Implementation notes: clear
  * ---------------------------
- * The implementation of clear first frees the nodes and arcs in
- * their respective sets and then uses the Set class clear method
- * to ensure that these sets are empty.
+ * The implementation of clear gives up this graph's claim on its data
+ * and starts over with a new empty GraphData structure, turning the
+ * adjacency index back on if it was on before.  If no other graph
+ * shares the old data, releaseData frees it.
  */
 
 template <typename NodeType,typename ArcType>
 void Graph<NodeType,ArcType>::clear() {
-   foreach (NodeType *node in nodes) {
-      delete node;
-   }
-   foreach (ArcType *arc in arcs) {
-      delete arc;
-   }
-   arcs.clear();
-   nodes.clear();
-   nodeMap.clear();
+   bool indexed = data->adjTable != NULL;
+   releaseData(data);
+   data = new GraphData();
+   if (indexed) setAdjacencyIndex(true);
 }
 
 /*
@@ -121,13 +118,17 @@ void Graph<NodeType,ArcType>::clear() {
  * The addNode method appears in two forms: one that creates a node
  * from its name and one that assumes that the client has created
  * the new node.  In each case, the implementation must add the node
- * the set of nodes for the graph and add the name-to-node association
- * to the node map.
+ * to the set of nodes for the graph and record the node under the id
+ * of its name.  Interning the name assigns the id if the name is new.
+ * The first form checks for an existing node before creating one so
+ * that a failed call does not leave an orphaned node in the arena.
  */
 
 template <typename NodeType,typename ArcType>
-NodeType *Graph<NodeType,ArcType>::addNode(string name) {
-   NodeType *node = new NodeType();
+NodeType *Graph<NodeType,ArcType>::addNode(const string & name) {
+   if (nodeExists(name)) error("addNode: node " + name + " already exists");
+   detachData(NULL, NULL, NULL);
+   NodeType *node = allocateNode();
    node->arcs = Set<ArcType *>(arcCompare<NodeType,ArcType>);
    node->name = name;
    return addNode(node);
@@ -135,11 +136,18 @@ NodeType *Graph<NodeType,ArcType>::addNode(string name) {
 
 template <typename NodeType,typename ArcType>
 NodeType *Graph<NodeType,ArcType>::addNode(NodeType *node) {
-   if (nodeMap.containsKey(node->name)) {
+   detachData(NULL, NULL, NULL);
+   int id = data->symbols.intern(node->name);
+   while (data->nodeIds.size() <= id) {
+      ArcList empty = { NULL, 0, 0 };
+      data->nodeIds.add(NULL);
+      data->incoming.add(empty);
+   }
+   if (data->nodeIds[id] != NULL) {
       error("addNode: node " + node->name + " already exists");
    }
-   nodes.add(node);
-   nodeMap[node->name] = node;
+   data->nodes.add(node);
+   data->nodeIds[id] = node;
    return node;
 }
 
@@ -147,63 +155,135 @@ NodeType *Graph<NodeType,ArcType>::addNode(NodeType *node) {
  * Implementation notes: removeNode
  * --------------------------------
  * The removeNode method must remove the specified node but must
- * also remove any arcs in the graph containing the node.  To avoid
- * changing the node set during iteration, this implementation creates
- * a vector of arcs that require deletion.
+ * also remove any arcs in the graph containing the node.  Those arcs
+ * are the ones in the arc set of the node and the ones in its list of
+ * incoming arcs, so there is no need to look at any other arcs.  An
+ * arc from the node to itself appears in both places and is handled
+ * only as part of the arc set.  The arc set and the incoming list of
+ * the node are discarded as a whole rather than one arc at a time, so
+ * each arc costs only its removal from the arc set of the graph and
+ * from one other list.  The name of the node stays in the symbol
+ * table, so adding a node with the same name later gives it the same
+ * id.
  */
 
 template <typename NodeType,typename ArcType>
-void Graph<NodeType,ArcType>::removeNode(string name) {
+void Graph<NodeType,ArcType>::removeNode(const string & name) {
    removeNode(getNode(name));
 }
 
 template <typename NodeType,typename ArcType>
 void Graph<NodeType,ArcType>::removeNode(NodeType *node) {
-   Vector<ArcType *> toRemove;
-   foreach (ArcType *arc in arcs) {
-      if (arc->start == node || arc->finish == node) {
-         toRemove.add(arc);
+   detachData(&node, NULL, NULL);
+   int id = findNodeId(node, "removeNode");
+   ArcList & list = data->incoming[id];
+   for (int i = 0; i < list.count; i++) {
+      ArcType *arc = list.arcs[i];
+      data->posTable[findArcPosition(arc)].index = -1;
+      if (arc->start != node) {
+         arc->start->arcs.remove(arc);
+         discardArc(arc);
       }
    }
-   foreach (ArcType *arc in toRemove) {
-      removeArc(arc);
+   typename Set<ArcType *>::iterator end = node->arcs.end();
+   for (typename Set<ArcType *>::iterator it = node->arcs.begin();
+        it != end; ++it) {
+      ArcType *arc = *it;
+      if (arc->finish != node) {
+         removeIncomingArc(findNodeId(arc->finish, "removeNode"), arc);
+      }
+      discardArc(arc);
    }
-   nodes.remove(node);
+   node->arcs.clear();
+   delete[] list.arcs;
+   list.arcs = NULL;
+   list.count = 0;
+   list.capacity = 0;
+   data->nodes.remove(node);
+   data->nodeIds[id] = NULL;
+   releaseNode(node);
 }
 
 /*
- * Implementation notes: getNode, nodeExists
- * -----------------------------------------
- * These methods provide access to the node map in the graph.
+ * Implementation notes: getNode, nodeExists, getNodeId
+ * ----------------------------------------------------
+ * These methods provide access to the name table in the graph, which
+ * consists of a symbol table that maps each name to its id and a
+ * vector that maps each id to its node.  An id whose node has not yet
+ * been added to the graph maps to NULL.
  */
 
 template <typename NodeType,typename ArcType>
-NodeType *Graph<NodeType,ArcType>::getNode(string name) {
-   if (!nodeMap.containsKey(name)) error("No node named " + name);
-   return nodeMap[name];
+NodeType *Graph<NodeType,ArcType>::getNode(const string & name) {
+   int id = data->symbols.find(name);
+   if (id < 0 || data->nodeIds[id] == NULL) error("No node named " + name);
+   return data->nodeIds[id];
+}
+
+template <typename NodeType,typename ArcType>
+NodeType *Graph<NodeType,ArcType>::getNode(int id) {
+   checkNodeId(id, "getNode");
+   return data->nodeIds[id];
+}
+
+template <typename NodeType,typename ArcType>
+bool Graph<NodeType,ArcType>::nodeExists(const string & name) {
+   int id = data->symbols.find(name);
+   return id >= 0 && data->nodeIds[id] != NULL;
+}
+
+template <typename NodeType,typename ArcType>
+int Graph<NodeType,ArcType>::getNodeId(const string & name) {
+   int id = data->symbols.find(name);
+   if (id < 0 || data->nodeIds[id] == NULL) error("No node named " + name);
+   return id;
+}
+
+template <typename NodeType,typename ArcType>
+int Graph<NodeType,ArcType>::getNodeId(NodeType *node) {
+   return findNodeId(node, "getNodeId");
+}
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::checkNodeId(int id, string caller) {
+   if (id < 0 || id >= data->nodeIds.size() || data->nodeIds[id] == NULL) {
+      error(caller + ": No node with id " + integerToString(id));
+   }
 }
 
 template <typename NodeType,typename ArcType>
-bool Graph<NodeType,ArcType>::nodeExists(string name) {
-   return nodeMap.containsKey(name);
+int Graph<NodeType,ArcType>::findNodeId(NodeType *node, string caller) {
+   int id = data->symbols.find(node->name);
+   if (id < 0 || data->nodeIds[id] != node) {
+      error(caller + ": Node is not in the graph");
+   }
+   return id;
 }
 
 /*
  * Implementation notes: addArc
  * ----------------------------
- * The addArc method appears in three forms, as described in the
+ * The addArc method appears in four forms, as described in the
  * interface.  The code for each form of the method, however, is
- * quite straightforward.
+ * quite straightforward.  Each arc is also recorded in the list of
+ * incoming arcs for its finish node, which is found by id.
  */
 
 template <typename NodeType,typename ArcType>
-ArcType *Graph<NodeType,ArcType>::addArc(string s1, string s2) {
+ArcType *Graph<NodeType,ArcType>::addArc(const string & s1,
+                                         const string & s2) {
    return addArc(getNode(s1), getNode(s2));
 }
 
+template <typename NodeType,typename ArcType>
+ArcType *Graph<NodeType,ArcType>::addArc(int id1, int id2) {
+   return addArc(getNode(id1), getNode(id2));
+}
+
 template <typename NodeType,typename ArcType>
 ArcType *Graph<NodeType,ArcType>::addArc(NodeType *n1, NodeType *n2) {
-   ArcType *arc = new ArcType();
+   detachData(&n1, &n2, NULL);
+   ArcType *arc = allocateArc();
    arc->start = n1;
    arc->finish = n2;
    return addArc(arc);
@@ -211,11 +291,96 @@ ArcType *Graph<NodeType,ArcType>::addArc(NodeType *n1, NodeType *n2) {
 
 template <typename NodeType,typename ArcType>
 ArcType *Graph<NodeType,ArcType>::addArc(ArcType *arc) {
+   detachData(&arc->start, &arc->finish, NULL);
+   int id = findNodeId(arc->finish, "addArc");
    arc->start->arcs.add(arc);
-   arcs.add(arc);
+   data->arcs.add(arc);
+   addIncomingArc(id, arc);
+   if (data->adjTable != NULL) addToAdjacencyIndex(arc);
    return arc;
 }
 
+/*
+ * Implementation notes: addArcs
+ * -----------------------------
+ * The arc sets are ordered by arcCompare, which compares the names of
+ * the start nodes and then those of the finish nodes.  The node set is
+ * in the same order as the names, so numbering the nodes in the order
+ * of that set gives each node a rank, and sorting the new arcs by the
+ * ranks of their endpoints, with ties broken by address as arcCompare
+ * does, puts them in the order of the arc sets while comparing only
+ * integers.  The arcs that start at the same node are then adjacent,
+ * so each run is merged into the arc set of its start node by a single
+ * call to addSorted, and the whole array is merged into the arc set of
+ * the graph.  The rank array first serves to count the new arcs that
+ * end at each node, so that each list of incoming arcs and the table
+ * of their positions are enlarged once rather than each time they fill.
+ */
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::addArcs(const int *ids1, const int *ids2,
+                                      int n, ArcType **arcs) {
+   int nIds = data->nodeIds.size();
+   for (int i = 0; i < n; i++) {
+      if (ids1[i] < 0 || ids1[i] >= nIds || data->nodeIds[ids1[i]] == NULL) {
+         checkNodeId(ids1[i], "addArcs");
+      }
+      if (ids2[i] < 0 || ids2[i] >= nIds || data->nodeIds[ids2[i]] == NULL) {
+         checkNodeId(ids2[i], "addArcs");
+      }
+   }
+   if (n == 0) return;
+   detachData(NULL, NULL, NULL);
+   int *rank = new int[nIds];
+   for (int id = 0; id < nIds; id++) {
+      rank[id] = 0;
+   }
+   for (int i = 0; i < n; i++) {
+      rank[ids2[i]]++;
+   }
+   for (int id = 0; id < nIds; id++) {
+      if (rank[id] > 0) reserveIncomingArcs(id, rank[id]);
+   }
+   int nRanked = 0;
+   typename Set<NodeType *>::iterator end = data->nodes.end();
+   for (typename Set<NodeType *>::iterator it = data->nodes.begin();
+        it != end; ++it) {
+      rank[findNodeId(*it, "addArcs")] = nRanked++;
+   }
+   if (4 * (data->posUsed + n) > 3 * data->posCapacity) {
+      rebuildPositionTable(data->posUsed + n);
+   }
+   SortedArc *sorted = new SortedArc[n];
+   for (int i = 0; i < n; i++) {
+      ArcType *arc = allocateArc();
+      arc->start = data->nodeIds[ids1[i]];
+      arc->finish = data->nodeIds[ids2[i]];
+      addIncomingArc(ids2[i], arc);
+      if (data->adjTable != NULL) addToAdjacencyIndex(arc);
+      sorted[i].start = rank[ids1[i]];
+      sorted[i].finish = rank[ids2[i]];
+      sorted[i].arc = arc;
+      if (arcs != NULL) arcs[i] = arc;
+   }
+   delete[] rank;
+   std::sort(sorted, sorted + n, SortedArcLess());
+   ArcType **run = new ArcType *[n];
+   for (int i = 0; i < n; i++) {
+      run[i] = sorted[i].arc;
+   }
+   for (int i = 0; i < n; ) {
+      int j = i + 1;
+      while (j < n && sorted[j].start == sorted[i].start) {
+         j++;
+      }
+      run[i]->start->arcs.addSorted(run + i, j - i);
+      i = j;
+   }
+   data->arcs.addSorted(run, n);
+   delete[] sorted;
+   delete[] run;
+}
+
 /*
  * Implementation notes: removeArc
  * -------------------------------
@@ -224,54 +389,334 @@ ArcType *Graph<NodeType,ArcType>::addArc(ArcType *arc) {
  * graph as a whole and the set of arcs in the starting node.  The
  * methods that remove an arc specified by its endpoints, however,
  * must take account of the fact that there might be more than one
- * such arc and delete all of them.
+ * such arc and delete all of them.  All such arcs are in the arc set
+ * of the start node, so only that set needs to be searched.  An arc
+ * that is not in the graph is left alone.  The discardArc method does
+ * the part of the work that removeNode shares, which is everything
+ * except removing the arc from the lists at its two ends.
  */
 
 template <typename NodeType,typename ArcType>
-void Graph<NodeType,ArcType>::removeArc(string s1, string s2) {
+void Graph<NodeType,ArcType>::removeArc(const string & s1,
+                                        const string & s2) {
    removeArc(getNode(s1), getNode(s2));
 }
 
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::removeArc(int id1, int id2) {
+   removeArc(getNode(id1), getNode(id2));
+}
+
 template <typename NodeType,typename ArcType>
 void Graph<NodeType,ArcType>::removeArc(NodeType *n1, NodeType *n2) {
+   detachData(&n1, &n2, NULL);
    Vector<ArcType *> toRemove;
-   foreach (ArcType *arc in arcs) {
-      if (arc->start == n1 && arc->finish == n2) {
-         toRemove.add(arc);
-      }
+   typename Set<ArcType *>::iterator end = n1->arcs.end();
+   for (typename Set<ArcType *>::iterator it = n1->arcs.begin();
+        it != end; ++it) {
+      if ((*it)->finish == n2) toRemove.add(*it);
    }
-   foreach (ArcType *arc in toRemove) {
-      removeArc(arc);
+   for (int i = 0; i < toRemove.size(); i++) {
+      removeArc(toRemove[i]);
    }
 }
 
 template <typename NodeType,typename ArcType>
 void Graph<NodeType,ArcType>::removeArc(ArcType *arc) {
+   if (!data->arcs.contains(arc)) return;
+   detachData(NULL, NULL, &arc);
+   removeIncomingArc(findNodeId(arc->finish, "removeArc"), arc);
    arc->start->arcs.remove(arc);
-   arcs.remove(arc);
+   discardArc(arc);
+}
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::discardArc(ArcType *arc) {
+   if (data->adjTable != NULL) removeFromAdjacencyIndex(arc);
+   data->arcs.remove(arc);
+   releaseArc(arc);
+}
+
+/*
+ * Implementation notes: addIncomingArc, removeIncomingArc
+ * -------------------------------------------------------
+ * The incoming arcs of each node are kept in an unordered array that
+ * doubles in size when it fills, or grows to the size requested by
+ * reserveIncomingArcs if that is larger.  Removing an arc moves the
+ * last arc in the array into its place.  To make removal take constant
+ * time, the graph records the index of every arc in the list of its
+ * finish node in posTable, an open-addressing hash table keyed by the
+ * arc pointer and managed in the same way as the adjacency index.  When
+ * an arc leaves its list, its slot keeps the key and its index becomes
+ * -1; such slots are discarded when the table is rebuilt.  The table
+ * is rebuilt whenever more than three quarters of its slots hold a
+ * key, and its new size is at least twice the number of arcs, which
+ * keeps its memory small compared to that of the arcs themselves.
+ */
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::addIncomingArc(int id, ArcType *arc) {
+   ArcList & list = data->incoming[id];
+   if (list.count == list.capacity) reserveIncomingArcs(id, 1);
+   if (4 * (data->posUsed + 1) > 3 * data->posCapacity) {
+      rebuildPositionTable(data->posUsed + 1);
+   }
+   ArcPosition & pos = data->posTable[findArcPosition(arc)];
+   if (pos.arc == NULL) {
+      pos.arc = arc;
+      data->posUsed++;
+   }
+   pos.index = list.count;
+   list.arcs[list.count++] = arc;
+}
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::reserveIncomingArcs(int id, int n) {
+   ArcList & list = data->incoming[id];
+   if (list.count + n <= list.capacity) return;
+   int capacity = (list.capacity == 0) ? 4 : 2 * list.capacity;
+   if (capacity < list.count + n) capacity = list.count + n;
+   ArcType **array = new ArcType *[capacity];
+   for (int i = 0; i < list.count; i++) {
+      array[i] = list.arcs[i];
+   }
+   delete[] list.arcs;
+   list.arcs = array;
+   list.capacity = capacity;
+}
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::removeIncomingArc(int id, ArcType *arc) {
+   ArcList & list = data->incoming[id];
+   ArcPosition & pos = data->posTable[findArcPosition(arc)];
+   int index = pos.index;
+   pos.index = -1;
+   ArcType *last = list.arcs[--list.count];
+   if (index != list.count) {
+      list.arcs[index] = last;
+      data->posTable[findArcPosition(last)].index = index;
+   }
+}
+
+template <typename NodeType,typename ArcType>
+int Graph<NodeType,ArcType>::findArcPosition(ArcType *arc) {
+   uint64_t h = uint64_t(uintptr_t(arc)) * 0x9E3779B97F4A7C15ULL;
+   ArcPosition *table = data->posTable;
+   int mask = data->posCapacity - 1;
+   int slot = int(h >> 32) & mask;
+   while (table[slot].arc != NULL && table[slot].arc != arc) {
+      slot = (slot + 1) & mask;
+   }
+   return slot;
+}
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::rebuildPositionTable(int nArcs) {
+   ArcPosition *oldTable = data->posTable;
+   int oldCapacity = data->posCapacity;
+   int nLive = 0;
+   for (int i = 0; i < oldCapacity; i++) {
+      if (oldTable[i].arc != NULL && oldTable[i].index >= 0) nLive++;
+   }
+   if (nLive > nArcs) nArcs = nLive;
+   data->posCapacity = 16;
+   while (data->posCapacity < 2 * nArcs) {
+      data->posCapacity *= 2;
+   }
+   data->posTable = new ArcPosition[data->posCapacity];
+   for (int i = 0; i < data->posCapacity; i++) {
+      data->posTable[i].arc = NULL;
+   }
+   data->posUsed = 0;
+   for (int i = 0; i < oldCapacity; i++) {
+      if (oldTable[i].arc != NULL && oldTable[i].index >= 0) {
+         data->posTable[findArcPosition(oldTable[i].arc)] = oldTable[i];
+         data->posUsed++;
+      }
+   }
+   delete[] oldTable;
 }
 
 /*
  * Implementation notes: isConnected
  * ---------------------------------
  * Node n1 is connected to n2 if any of the arcs leaving n1 finish at n2.
- * The two versions of this method allow nodes to be specified either as
- * node pointers or by name.
+ * If the adjacency index is enabled, the answer comes from looking up
+ * the pair in the index.  Otherwise, the method scans the arcs of n1
+ * using an explicit iterator, which avoids the copy of the arc set
+ * that foreach would make.  The other versions of this method allow
+ * nodes to be specified by name or by id.
  */
 
 template <typename NodeType,typename ArcType>
 bool Graph<NodeType,ArcType>::isConnected(NodeType *n1, NodeType *n2) {
-   foreach (ArcType *arc in n1->arcs) {
-      if (arc->finish == n2) return true;
+   if (data->adjTable != NULL) {
+      AdjacencyEntry & entry = data->adjTable[findAdjacencySlot(n1, n2)];
+      return entry.start != NULL && entry.count > 0;
+   }
+   typename Set<ArcType *>::iterator end = n1->arcs.end();
+   for (typename Set<ArcType *>::iterator it = n1->arcs.begin();
+        it != end; ++it) {
+      if ((*it)->finish == n2) return true;
    }
    return false;
 }
 
 template <typename NodeType,typename ArcType>
-bool Graph<NodeType,ArcType>::isConnected(string s1, string s2) {
+bool Graph<NodeType,ArcType>::isConnected(const string & s1,
+                                          const string & s2) {
    return isConnected(getNode(s1), getNode(s2));
 }
 
+template <typename NodeType,typename ArcType>
+bool Graph<NodeType,ArcType>::isConnected(int id1, int id2) {
+   return isConnected(getNode(id1), getNode(id2));
+}
+
+/*
+ * Implementation notes: setAdjacencyIndex, hasAdjacencyIndex
+ * ----------------------------------------------------------
+ * The adjacency index is an open-addressing hash table keyed by the
+ * pair of node pointers at the ends of an arc.  Each slot counts the
+ * arcs between its pair of nodes, so that removing one of several
+ * parallel arcs leaves the pair connected.  A slot whose count falls
+ * to zero keeps its key, which keeps the probe sequences of other
+ * pairs intact; such slots are discarded when the table is rebuilt.
+ * The table is rebuilt whenever more than half of its slots hold a
+ * key, and its new size is at least four times the number of pairs
+ * with a nonzero count.
+ */
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::setAdjacencyIndex(bool flag) {
+   if (flag != (data->adjTable != NULL)) detachData(NULL, NULL, NULL);
+   if (flag && data->adjTable == NULL) {
+      rebuildAdjacencyIndex(data->arcs.size());
+      typename Set<ArcType *>::iterator end = data->arcs.end();
+      for (typename Set<ArcType *>::iterator it = data->arcs.begin();
+           it != end; ++it) {
+         addToAdjacencyIndex(*it);
+      }
+   } else if (!flag && data->adjTable != NULL) {
+      delete[] data->adjTable;
+      data->adjTable = NULL;
+      data->adjCapacity = 0;
+      data->adjUsed = 0;
+   }
+}
+
+template <typename NodeType,typename ArcType>
+bool Graph<NodeType,ArcType>::hasAdjacencyIndex() {
+   return data->adjTable != NULL;
+}
+
+/*
+ * Implementation notes: arena allocation
+ * --------------------------------------
+ * The flag determines only where new nodes and arcs come from.  When
+ * an object is removed from the graph, the arena is asked whether the
+ * object belongs to it, which allows objects from both sources to
+ * coexist in the same graph after the mode changes.  Objects from an
+ * arena go back to it; all other objects are left to the client, as
+ * they have always been.
+ */
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::setArenaAllocation(bool flag) {
+   arenaMode = flag;
+}
+
+template <typename NodeType,typename ArcType>
+bool Graph<NodeType,ArcType>::hasArenaAllocation() {
+   return arenaMode;
+}
+
+template <typename NodeType,typename ArcType>
+NodeType *Graph<NodeType,ArcType>::allocateNode() {
+   return (arenaMode) ? data->nodeArena.create() : new NodeType();
+}
+
+template <typename NodeType,typename ArcType>
+ArcType *Graph<NodeType,ArcType>::allocateArc() {
+   return (arenaMode) ? data->arcArena.create() : new ArcType();
+}
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::releaseNode(NodeType *node) {
+   if (data->nodeArena.contains(node)) data->nodeArena.destroy(node);
+}
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::releaseArc(ArcType *arc) {
+   if (data->arcArena.contains(arc)) data->arcArena.destroy(arc);
+}
+
+template <typename NodeType,typename ArcType>
+int Graph<NodeType,ArcType>::findAdjacencySlot(NodeType *n1,
+                                                NodeType *n2) {
+   uint64_t h = uint64_t(uintptr_t(n1)) * 0x9E3779B97F4A7C15ULL;
+   h = (h ^ uint64_t(uintptr_t(n2))) * 0xC2B2AE3D27D4EB4FULL;
+   AdjacencyEntry *table = data->adjTable;
+   int mask = data->adjCapacity - 1;
+   int slot = int(h >> 32) & mask;
+   while (table[slot].start != NULL
+          && (table[slot].start != n1 || table[slot].finish != n2)) {
+      slot = (slot + 1) & mask;
+   }
+   return slot;
+}
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::addToAdjacencyIndex(ArcType *arc) {
+   if (2 * (data->adjUsed + 1) > data->adjCapacity) {
+      rebuildAdjacencyIndex(data->adjUsed + 1);
+   }
+   AdjacencyEntry & entry = data->adjTable[findAdjacencySlot(arc->start,
+                                                        arc->finish)];
+   if (entry.start == NULL) {
+      entry.start = arc->start;
+      entry.finish = arc->finish;
+      entry.count = 0;
+      data->adjUsed++;
+   }
+   entry.count++;
+}
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::removeFromAdjacencyIndex(ArcType *arc) {
+   AdjacencyEntry & entry = data->adjTable[findAdjacencySlot(arc->start,
+                                                        arc->finish)];
+   if (entry.start != NULL && entry.count > 0) entry.count--;
+}
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::rebuildAdjacencyIndex(int nPairs) {
+   AdjacencyEntry *oldTable = data->adjTable;
+   int oldCapacity = data->adjCapacity;
+   int nLive = 0;
+   for (int i = 0; i < oldCapacity; i++) {
+      if (oldTable[i].start != NULL && oldTable[i].count > 0) nLive++;
+   }
+   if (nLive > nPairs) nPairs = nLive;
+   data->adjCapacity = 16;
+   while (data->adjCapacity < 4 * nPairs) {
+      data->adjCapacity *= 2;
+   }
+   data->adjTable = new AdjacencyEntry[data->adjCapacity];
+   for (int i = 0; i < data->adjCapacity; i++) {
+      data->adjTable[i].start = NULL;
+   }
+   data->adjUsed = 0;
+   for (int i = 0; i < oldCapacity; i++) {
+      if (oldTable[i].start != NULL && oldTable[i].count > 0) {
+         data->adjTable[findAdjacencySlot(oldTable[i].start,
+                                    oldTable[i].finish)] = oldTable[i];
+         data->adjUsed++;
+      }
+   }
+   delete[] oldTable;
+}
+
 /*
  * Implementation notes: getNodeSet, getArcSet
  * -------------------------------------------
@@ -282,12 +727,12 @@ bool Graph<NodeType,ArcType>::isConnected(string s1, string s2) {
 
 template <typename NodeType,typename ArcType>
 Set<NodeType *> & Graph<NodeType,ArcType>::getNodeSet() {
-   return nodes;
+   return data->nodes;
 }
 
 template <typename NodeType,typename ArcType>
 Set<ArcType *> & Graph<NodeType,ArcType>::getArcSet() {
-   return arcs;
+   return data->arcs;
 }
 
 template <typename NodeType,typename ArcType>
@@ -296,52 +741,107 @@ Set<ArcType *> & Graph<NodeType,ArcType>::getArcSet(NodeType *node) {
 }
 
 template <typename NodeType,typename ArcType>
-Set<ArcType *> & Graph<NodeType,ArcType>::getArcSet(string name) {
+Set<ArcType *> & Graph<NodeType,ArcType>::getArcSet(const string & name) {
    return getArcSet(getNode(name));
 }
 
+template <typename NodeType,typename ArcType>
+Set<ArcType *> & Graph<NodeType,ArcType>::getArcSet(int id) {
+   return getArcSet(getNode(id));
+}
+
 /*
- * Implementation notes: getNeighbors
- * ----------------------------------
- * This implementation recomputes the set each time, which is reasonably
- * efficient if the degree of the node is small.
+ * Implementation notes: getNeighbors, neighbors
+ * ---------------------------------------------
+ * The getNeighbors method recomputes the set each time, which is
+ * reasonably efficient if the degree of the node is small.  Clients
+ * that only need to visit the neighbors should use neighbors instead,
+ * which returns a view of the existing arc set.
  */
 
 template <typename NodeType,typename ArcType>
 Set<NodeType *> Graph<NodeType,ArcType>::getNeighbors(NodeType *node) {
    Set<NodeType *> nodes(nodeCompare<NodeType>);
-   foreach (ArcType *arc in node->arcs) {
-      nodes.add(arc->finish);
+   typename Set<ArcType *>::iterator end = node->arcs.end();
+   for (typename Set<ArcType *>::iterator it = node->arcs.begin();
+        it != end; ++it) {
+      nodes.add((*it)->finish);
    }
    return nodes;
 }
 
 template <typename NodeType,typename ArcType>
-Set<NodeType *> Graph<NodeType,ArcType>::getNeighbors(string name) {
+Set<NodeType *> Graph<NodeType,ArcType>::getNeighbors(const string & name) {
    return getNeighbors(getNode(name));
 }
 
+template <typename NodeType,typename ArcType>
+typename Graph<NodeType,ArcType>::NeighborView
+         Graph<NodeType,ArcType>::neighbors(NodeType *node) {
+   return NeighborView(&node->arcs);
+}
+
+/*
+ * Implementation notes: freeze
+ * ----------------------------
+ * These methods construct the snapshot in the return statement, which
+ * allows the compiler to build it directly in the caller's variable
+ * rather than copying it.
+ */
+
+template <typename NodeType,typename ArcType>
+FrozenGraph<NodeType,ArcType> Graph<NodeType,ArcType>::freeze() {
+   return FrozenGraph<NodeType,ArcType>(*this);
+}
+
+template <typename NodeType,typename ArcType>
+template <typename WeightFunction>
+FrozenGraph<NodeType,ArcType>
+           Graph<NodeType,ArcType>::freeze(WeightFunction weightFn) {
+   return FrozenGraph<NodeType,ArcType>(*this, weightFn);
+}
+
+/*
+ * Implementation notes: setCopyOnWrite, isCopyOnWrite
+ * ---------------------------------------------------
+ * Turning sharing off gives the graph its own data immediately, so
+ * that a graph without copy-on-write never shares its data.
+ */
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::setCopyOnWrite(bool flag) {
+   copyOnWrite = flag;
+   if (!flag) detachData(NULL, NULL, NULL);
+}
+
+template <typename NodeType,typename ArcType>
+bool Graph<NodeType,ArcType>::isCopyOnWrite() {
+   return copyOnWrite;
+}
+
 /*
  * Implementation notes: operator=, copy constructor
  * -------------------------------------------------
  * These methods ensure that copying a graph creates an entirely new
- * parallel structure of nodes and arcs.
+ * parallel structure of nodes and arcs, unless copy-on-write sharing
+ * is on, in which case the copy shares the data of the original.  A
+ * deep copy begins with the symbol table of the original, so each
+ * node keeps its id, and it allocates its nodes and arcs in the same
+ * way as the original.
  */
 
 template <typename NodeType,typename ArcType>
 Graph<NodeType,ArcType>
            & Graph<NodeType,ArcType>::operator=(const Graph & rhs) {
    if (this != &rhs) {
-      clear();
+      releaseData(data);
       copyInternalData(rhs);
    }
    return *this;
 }
 
 template <typename NodeType,typename ArcType>
-Graph<NodeType,ArcType>::Graph(const Graph & rhs) :
-                      nodes(nodeCompare<NodeType>),
-                      arcs(arcCompare<NodeType,ArcType>) {
+Graph<NodeType,ArcType>::Graph(const Graph & rhs) {
    copyInternalData(rhs);
 }
 
@@ -353,21 +853,112 @@ Graph<NodeType,ArcType>::Graph(const Graph & rhs) :
 
 template <typename NodeType,typename ArcType>
 void Graph<NodeType,ArcType>::copyInternalData(const Graph & other) {
-   Set<NodeType *>nodes = other.nodes;
-   foreach (NodeType *oldNode in nodes) {
-      NodeType *newNode = new NodeType();
-      *newNode = *oldNode;
+   arenaMode = other.arenaMode;
+   copyOnWrite = other.copyOnWrite;
+   if (copyOnWrite) {
+      data = other.data;
+      atomicIncrement(&data->shareCount);
+   } else {
+      data = new GraphData();
+      copyData(other.data, NULL);
+   }
+}
+
+/*
+ * Private method: copyData
+ * ------------------------
+ * Fills the empty data of this graph with copies of the nodes and arcs
+ * in src.  If arc is not NULL and points to an arc in src, the method
+ * changes it to point to the copy of that arc.  The copy has an entry
+ * in nodeIds for every name in the symbol table, including the names
+ * of nodes that have been removed, just as the original does.
+ */
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::copyData(GraphData *src, ArcType **arc) {
+   setAdjacencyIndex(src->adjTable != NULL);
+   data->symbols = src->symbols;
+   ArcList empty = { NULL, 0, 0 };
+   for (int i = 0; i < data->symbols.size(); i++) {
+      data->nodeIds.add(NULL);
+      data->incoming.add(empty);
+   }
+   typename Set<NodeType *>::iterator nodeEnd = src->nodes.end();
+   for (typename Set<NodeType *>::iterator it = src->nodes.begin();
+        it != nodeEnd; ++it) {
+      NodeType *newNode = allocateNode();
+      *newNode = **it;
       newNode->arcs.clear();
       addNode(newNode);
    }
-   Set<ArcType *> arcs = other.arcs;
-   foreach (ArcType *oldArc in arcs) {
-      ArcType *newArc = new ArcType();
+   typename Set<ArcType *>::iterator arcEnd = src->arcs.end();
+   for (typename Set<ArcType *>::iterator it = src->arcs.begin();
+        it != arcEnd; ++it) {
+      ArcType *oldArc = *it;
+      ArcType *newArc = allocateArc();
       *newArc = *oldArc;
-      newArc->start = getNode(oldArc->start->name);
-      newArc->finish = getNode(oldArc->finish->name);
+      newArc->start = data->nodeIds[data->symbols.find(oldArc->start->name)];
+      newArc->finish = data->nodeIds[data->symbols.find(oldArc->finish->name)];
       addArc(newArc);
+      if (arc != NULL && *arc == oldArc) *arc = newArc;
+   }
+}
+
+/*
+ * Implementation notes: detachData, releaseData
+ * ---------------------------------------------
+ * Every method that changes the graph calls detachData first.  If the
+ * data is shared, detachData gives this graph a copy of its own before
+ * the change is made.  The node and arc pointers passed to the method
+ * that made the call belong to the shared data, so detachData changes
+ * them to point to the corresponding objects in the copy; a node is
+ * matched by its id and an arc during the copy itself.  The releaseData
+ * method gives up a claim on shared data.  Its count is decremented
+ * atomically, so exactly one of the graphs sharing the data frees it,
+ * even if several graphs release it at once.  Objects that belong to
+ * an arena are freed when the arena is destroyed.  If an arena holds
+ * exactly as many objects as the corresponding set, every object in
+ * the set came from the arena, and the loop over the set is skipped.
+ */
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::detachData(NodeType **n1, NodeType **n2,
+                                         ArcType **arc) {
+   if (atomicLoad(&data->shareCount) == 1) return;
+   GraphData *old = data;
+   data = new GraphData();
+   copyData(old, arc);
+   NodeType **nodes[] = { n1, n2 };
+   for (int i = 0; i < 2; i++) {
+      if (nodes[i] != NULL && *nodes[i] != NULL) {
+         int id = old->symbols.find((*nodes[i])->name);
+         if (id >= 0 && old->nodeIds[id] == *nodes[i]) {
+            *nodes[i] = data->nodeIds[id];
+         }
+      }
+   }
+   releaseData(old);
+}
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::releaseData(GraphData *old) {
+   if (atomicDecrement(&old->shareCount) > 0) return;
+   if (old->nodeArena.size() != old->nodes.size()) {
+      foreach (NodeType *node in old->nodes) {
+         if (!old->nodeArena.contains(node)) delete node;
+      }
+   }
+   if (old->arcArena.size() != old->arcs.size()) {
+      foreach (ArcType *arc in old->arcs) {
+         if (!old->arcArena.contains(arc)) delete arc;
+      }
+   }
+   for (int i = 0; i < old->incoming.size(); i++) {
+      delete[] old->incoming[i].arcs;
    }
+   delete[] old->adjTable;
+   delete[] old->posTable;
+   delete old;
 }
 
 #endif
@@ -4,12 +4,184 @@
  * This file defines the private data for the Graph class.
  */
 
+/* Type used for the slots in the adjacency index */
+
+private:
+   struct AdjacencyEntry {
+      NodeType *start;                    /* Start node, or NULL if empty  */
+      NodeType *finish;                   /* Finish node                   */
+      int count;                          /* Number of arcs, possibly 0    */
+   };
+
+/* Type used for the list of arcs that end at a node */
+
+   struct ArcList {
+      ArcType **arcs;                     /* Array of arcs, or NULL        */
+      int count;                          /* Number of arcs in the list    */
+      int capacity;                       /* Allocated size of the array   */
+   };
+
+/* Type used for the slots in the table of incoming-arc positions */
+
+   struct ArcPosition {
+      ArcType *arc;                       /* Arc, or NULL if empty         */
+      int index;                          /* Index in ArcList, or -1       */
+   };
+
+/* Type used to sort the arcs added by addArcs */
+
+   struct SortedArc {
+      int start;                          /* Rank of the start node        */
+      int finish;                         /* Rank of the finish node       */
+      ArcType *arc;                       /* The new arc                   */
+   };
+
+/* Ordering used to sort the new arcs, which matches arcCompare */
+
+   struct SortedArcLess {
+      bool operator()(const SortedArc & a1, const SortedArc & a2) const {
+         if (a1.start != a2.start) return a1.start < a2.start;
+         if (a1.finish != a2.finish) return a1.finish < a2.finish;
+         return a1.arc < a2.arc;
+      }
+   };
+
+/*
+ * Type: GraphData
+ * ---------------
+ * This structure holds everything that copy-on-write copies of a
+ * graph can share: the nodes and arcs themselves, the sets and tables
+ * that index them, and the arenas they come from.  The shareCount
+ * field counts the graphs that refer to the structure and is updated
+ * atomically.  A structure with more than one owner is never changed.
+ */
+
+   struct GraphData {
+      Set<NodeType *> nodes;              /* The set of nodes in the graph */
+      Set<ArcType *> arcs;                /* The set of arcs in the graph  */
+      SymbolTable symbols;                /* Node names and their ids      */
+      Vector<NodeType *> nodeIds;         /* The node with each id or NULL */
+      Vector<ArcList> incoming;           /* Arcs ending at each node id   */
+      Arena<NodeType> nodeArena;          /* Storage for nodes in arena    */
+      Arena<ArcType> arcArena;            /* Storage for arcs in arena     */
+      AdjacencyEntry *adjTable;           /* Adjacency index, or NULL      */
+      int adjCapacity;                    /* Number of slots in adjTable   */
+      int adjUsed;                        /* Slots that hold a node pair   */
+      ArcPosition *posTable;              /* Position of each incoming arc */
+      int posCapacity;                    /* Number of slots in posTable   */
+      int posUsed;                        /* Slots that hold an arc        */
+      int shareCount;                     /* Graphs sharing this data      */
+
+      GraphData() : nodes(nodeCompare<NodeType>),
+                    arcs(arcCompare<NodeType,ArcType>) {
+         adjTable = NULL;
+         adjCapacity = 0;
+         adjUsed = 0;
+         posTable = NULL;
+         posCapacity = 0;
+         posUsed = 0;
+         shareCount = 1;
+      }
+   };
+
 /* Instance variables */
 
 private:
-   Set<NodeType *> nodes;                 /* The set of nodes in the graph */
-   Set<ArcType *> arcs;                   /* The set of arcs in the graph  */
-   Map<std::string, NodeType *> nodeMap;  /* A map from names and nodes    */
+   GraphData *data;                       /* The contents of the graph     */
+   bool arenaMode;                        /* True if allocating from arena */
+   bool copyOnWrite;                      /* True if copies share data     */
+
+/* Private method prototypes */
+
+   void checkNodeId(int id, std::string caller);
+   int findNodeId(NodeType *node, std::string caller);
+   NodeType *allocateNode();
+   ArcType *allocateArc();
+   void releaseNode(NodeType *node);
+   void releaseArc(ArcType *arc);
+   void addIncomingArc(int id, ArcType *arc);
+   void removeIncomingArc(int id, ArcType *arc);
+   void reserveIncomingArcs(int id, int n);
+   int findArcPosition(ArcType *arc);
+   void rebuildPositionTable(int nArcs);
+   void discardArc(ArcType *arc);
+   void copyData(GraphData *src, ArcType **arc);
+   void detachData(NodeType **n1, NodeType **n2, ArcType **arc);
+   void releaseData(GraphData *old);
+   int findAdjacencySlot(NodeType *n1, NodeType *n2);
+   void addToAdjacencyIndex(ArcType *arc);
+   void removeFromAdjacencyIndex(ArcType *arc);
+   void rebuildAdjacencyIndex(int nPairs);
+
+/*
+ * Class: Graph<NodeType,ArcType>::NeighborView
+ * --------------------------------------------
+ * This class is the view returned by the neighbors method.  It holds
+ * only a pointer to the arc set of the node, and its iterator wraps
+ * the iterator for that set.
+ */
+
+public:
+   class NeighborView {
+   public:
+      class iterator
+         : public std::iterator<std::input_iterator_tag,NodeType *> {
+      public:
+         iterator() {
+            /* Empty */
+         }
+
+         iterator(const typename Set<ArcType *>::iterator & it) : it(it) {
+            /* Empty */
+         }
+
+         iterator & operator++() {
+            ++it;
+            return *this;
+         }
+
+         iterator operator++(int) {
+            iterator copy(*this);
+            ++it;
+            return copy;
+         }
+
+         bool operator==(const iterator & rhs) {
+            return it == rhs.it;
+         }
+
+         bool operator!=(const iterator & rhs) {
+            return it != rhs.it;
+         }
+
+         NodeType *operator*() {
+            return (*it)->finish;
+         }
+
+      private:
+         typename Set<ArcType *>::iterator it;
+      };
+
+      NeighborView() {
+         arcSet = NULL;
+      }
+
+      iterator begin() const {
+         return iterator(arcSet->begin());
+      }
+
+      iterator end() const {
+         return iterator(arcSet->end());
+      }
+
+   private:
+      NeighborView(const Set<ArcType *> *arcSet) {
+         this->arcSet = arcSet;
+      }
+
+      const Set<ArcType *> *arcSet;
+      friend class Graph;
+   };
 
 /*
  * Functions: operator=, copy constructor
@@ -0,0 +1,443 @@
+/*
+ * File: graphsearchimpl.cpp
+ * -------------------------
+ * This file contains the implementation of the graphsearch.h interface.
+ * Because of the way C++ compiles templates, this code must be
+ * available to the compiler when it reads the header file.
+ */
+
+#ifdef _graphsearch_h
+
+template <typename NodeType,typename ArcType>
+GraphSearch<NodeType,ArcType>::GraphSearch(Graph<NodeType,ArcType> & g)
+                                           : fg(g) {
+   init();
+}
+
+template <typename NodeType,typename ArcType>
+template <typename WeightFunction>
+GraphSearch<NodeType,ArcType>::GraphSearch(Graph<NodeType,ArcType> & g,
+                                           WeightFunction weightFn)
+                                           : fg(g, weightFn) {
+   init();
+}
+
+template <typename NodeType,typename ArcType>
+GraphSearch<NodeType,ArcType>::GraphSearch(
+                                 const FrozenGraph<NodeType,ArcType> & src)
+                                 : fg(src) {
+   init();
+}
+
+template <typename NodeType,typename ArcType>
+GraphSearch<NodeType,ArcType>::~GraphSearch() {
+   delete[] stamp;
+   delete[] dist;
+   delete[] estimate;
+   delete[] parentArc;
+   delete[] heap;
+   delete[] heapPos;
+}
+
+/*
+ * Implementation notes: breadthFirstSearch
+ * ----------------------------------------
+ * The heap array is not otherwise in use during a breadth-first
+ * search, so it serves as the queue.  Each node enters the queue at
+ * most once, so the queue never needs more than one slot per node.
+ */
+
+template <typename NodeType,typename ArcType>
+void GraphSearch<NodeType,ArcType>::breadthFirstSearch(NodeType *node) {
+   int s = startSearch(node, "breadthFirstSearch");
+   const int *offsets = fg.getOutOffsets();
+   const int *targets = fg.getOutTargets();
+   int head = 0;
+   int tail = 0;
+   heap[tail++] = s;
+   while (head < tail) {
+      int v = heap[head++];
+      double d = dist[v] + 1;
+      for (int i = offsets[v]; i < offsets[v + 1]; i++) {
+         int w = targets[i];
+         if (stamp[w] != searchNumber) {
+            stamp[w] = searchNumber;
+            dist[w] = d;
+            parentArc[w] = i;
+            heap[tail++] = w;
+         }
+      }
+   }
+}
+
+template <typename NodeType,typename ArcType>
+void GraphSearch<NodeType,ArcType>::dijkstra(NodeType *node) {
+   startSearch(node, "dijkstra");
+   if (negativeWeights) error("dijkstra: Graph has negative weights");
+   runBestFirst(-1, ZeroHeuristic(), (NodeType *) NULL);
+}
+
+template <typename NodeType,typename ArcType>
+Vector<ArcType *>
+GraphSearch<NodeType,ArcType>::findShortestPath(NodeType *start,
+                                                NodeType *finish) {
+   return findShortestPath(start, finish, ZeroHeuristic());
+}
+
+template <typename NodeType,typename ArcType>
+template <typename HeuristicFunction>
+Vector<ArcType *>
+GraphSearch<NodeType,ArcType>::findShortestPath(NodeType *start,
+                                                NodeType *finish,
+                                                HeuristicFunction h) {
+   if (!fg.containsNode(finish)) {
+      error("findShortestPath: Node is not in the graph");
+   }
+   startSearch(start, "findShortestPath");
+   if (negativeWeights) error("findShortestPath: Graph has negative weights");
+   int goal = fg.getId(finish);
+   runBestFirst(goal, h, finish);
+   return tracePath(goal);
+}
+
+template <typename NodeType,typename ArcType>
+bool GraphSearch<NodeType,ArcType>::isReachable(NodeType *node) {
+   if (!fg.containsNode(node)) error("isReachable: Node is not in the graph");
+   return reached(fg.getId(node));
+}
+
+template <typename NodeType,typename ArcType>
+double GraphSearch<NodeType,ArcType>::getDistance(NodeType *node) {
+   if (!fg.containsNode(node)) error("getDistance: Node is not in the graph");
+   int v = fg.getId(node);
+   return reached(v) ? dist[v] : -1;
+}
+
+template <typename NodeType,typename ArcType>
+Vector<ArcType *> GraphSearch<NodeType,ArcType>::getPath(NodeType *node) {
+   if (!fg.containsNode(node)) error("getPath: Node is not in the graph");
+   return tracePath(fg.getId(node));
+}
+
+template <typename NodeType,typename ArcType>
+const FrozenGraph<NodeType,ArcType> &
+GraphSearch<NodeType,ArcType>::getSnapshot() const {
+   return fg;
+}
+
+template <typename NodeType,typename ArcType>
+void GraphSearch<NodeType,ArcType>::init() {
+   nNodes = fg.size();
+   start = -1;
+   searchNumber = 0;
+   heapSize = 0;
+   stamp = new int[nNodes];
+   dist = new double[nNodes];
+   estimate = new double[nNodes];
+   parentArc = new int[nNodes];
+   heap = new int[nNodes];
+   heapPos = new int[nNodes];
+   for (int v = 0; v < nNodes; v++) {
+      stamp[v] = 0;
+   }
+   negativeWeights = false;
+   const double *weights = fg.getOutWeights();
+   if (weights != NULL) {
+      int nArcs = fg.getArcCount();
+      for (int i = 0; i < nArcs; i++) {
+         if (weights[i] < 0) negativeWeights = true;
+      }
+   }
+}
+
+/*
+ * Implementation notes: startSearch
+ * ---------------------------------
+ * Starting a search advances the search number, which makes every
+ * node unreached without touching the arrays.  In the unlikely event
+ * that the number would overflow, the stamps are cleared and the
+ * numbering starts again.
+ */
+
+template <typename NodeType,typename ArcType>
+int GraphSearch<NodeType,ArcType>::startSearch(NodeType *node,
+                                               std::string caller) {
+   if (!fg.containsNode(node)) error(caller + ": Node is not in the graph");
+   if (searchNumber == INT_MAX) {
+      for (int v = 0; v < nNodes; v++) {
+         stamp[v] = 0;
+      }
+      searchNumber = 0;
+   }
+   searchNumber++;
+   start = fg.getId(node);
+   stamp[start] = searchNumber;
+   dist[start] = 0;
+   parentArc[start] = -1;
+   heapSize = 0;
+   return start;
+}
+
+/*
+ * Implementation notes: runBestFirst
+ * ----------------------------------
+ * This method carries out both Dijkstra's algorithm and A* search,
+ * which differ only in the estimate added to each node's distance to
+ * give its key in the heap; for Dijkstra's algorithm the estimate is
+ * always 0.  The heuristic is called once per node, when the node is
+ * first reached.  If a shorter path is found to a node that has
+ * already left the heap, the node goes back into the heap.  That never
+ * happens for Dijkstra's algorithm or for a consistent heuristic, but
+ * it keeps A* correct for a heuristic that is merely admissible.  The
+ * search stops when the goal leaves the heap, or when the heap is
+ * empty if there is no goal.
+ */
+
+template <typename NodeType,typename ArcType>
+template <typename HeuristicFunction>
+void GraphSearch<NodeType,ArcType>::runBestFirst(int goal,
+                                                 HeuristicFunction h,
+                                                 NodeType *goalNode) {
+   const int *offsets = fg.getOutOffsets();
+   const int *targets = fg.getOutTargets();
+   const double *weights = fg.getOutWeights();
+   estimate[start] = (goal < 0) ? 0 : h(fg.getNode(start), goalNode);
+   heapInsert(start);
+   while (heapSize > 0) {
+      int v = heapRemoveMin();
+      if (v == goal) break;
+      for (int i = offsets[v]; i < offsets[v + 1]; i++) {
+         int w = targets[i];
+         double d = dist[v] + ((weights == NULL) ? 1.0 : weights[i]);
+         if (stamp[w] != searchNumber) {
+            stamp[w] = searchNumber;
+            dist[w] = d;
+            parentArc[w] = i;
+            estimate[w] = (goal < 0) ? 0 : h(fg.getNode(w), goalNode);
+            heapInsert(w);
+         } else if (d < dist[w]) {
+            dist[w] = d;
+            parentArc[w] = i;
+            if (heapPos[w] < 0) {
+               heapInsert(w);
+            } else {
+               heapMoveUp(heapPos[w]);
+            }
+         }
+      }
+   }
+}
+
+template <typename NodeType,typename ArcType>
+bool GraphSearch<NodeType,ArcType>::reached(int v) const {
+   return searchNumber > 0 && stamp[v] == searchNumber;
+}
+
+/*
+ * Implementation notes: tracePath
+ * -------------------------------
+ * The parent links run from the end of the path back to the start, so
+ * this method collects the arcs in that order and then reverses them.
+ * The start of each arc is found from the arc number by binary search
+ * in the snapshot, which keeps the search itself from having to record
+ * a second array.
+ */
+
+template <typename NodeType,typename ArcType>
+Vector<ArcType *> GraphSearch<NodeType,ArcType>::tracePath(int v) const {
+   Vector<ArcType *> path;
+   if (!reached(v)) return path;
+   for (int u = v; parentArc[u] >= 0; u = fg.getStart(parentArc[u])) {
+      path.add(fg.getArc(parentArc[u]));
+   }
+   int n = path.size();
+   for (int i = 0; i < n / 2; i++) {
+      ArcType *tmp = path[i];
+      path[i] = path[n - 1 - i];
+      path[n - 1 - i] = tmp;
+   }
+   return path;
+}
+
+template <typename NodeType,typename ArcType>
+double GraphSearch<NodeType,ArcType>::heapKey(int v) const {
+   return dist[v] + estimate[v];
+}
+
+template <typename NodeType,typename ArcType>
+void GraphSearch<NodeType,ArcType>::heapInsert(int v) {
+   heap[heapSize] = v;
+   heapPos[v] = heapSize;
+   heapMoveUp(heapSize++);
+}
+
+template <typename NodeType,typename ArcType>
+void GraphSearch<NodeType,ArcType>::heapMoveUp(int pos) {
+   int v = heap[pos];
+   double key = heapKey(v);
+   while (pos > 0) {
+      int parent = (pos - 1) / 2;
+      if (heapKey(heap[parent]) <= key) break;
+      heap[pos] = heap[parent];
+      heapPos[heap[pos]] = pos;
+      pos = parent;
+   }
+   heap[pos] = v;
+   heapPos[v] = pos;
+}
+
+template <typename NodeType,typename ArcType>
+int GraphSearch<NodeType,ArcType>::heapRemoveMin() {
+   int min = heap[0];
+   heapPos[min] = -1;
+   int v = heap[--heapSize];
+   if (heapSize > 0) {
+      double key = heapKey(v);
+      int pos = 0;
+      while (true) {
+         int child = 2 * pos + 1;
+         if (child >= heapSize) break;
+         if (child + 1 < heapSize
+             && heapKey(heap[child + 1]) < heapKey(heap[child])) {
+            child++;
+         }
+         if (key <= heapKey(heap[child])) break;
+         heap[pos] = heap[child];
+         heapPos[heap[pos]] = pos;
+         pos = child;
+      }
+      heap[pos] = v;
+      heapPos[v] = pos;
+   }
+   return min;
+}
+
+template <typename NodeType,typename ArcType>
+Vector<NodeType *> topologicalSort(Graph<NodeType,ArcType> & g) {
+   return topologicalSort(FrozenGraph<NodeType,ArcType>(g));
+}
+
+/*
+ * Implementation notes: topologicalSort
+ * -------------------------------------
+ * This function uses Kahn's algorithm, which repeatedly removes a node
+ * that no remaining arc enters.  The candidates are kept in a priority
+ * queue ordered by id, which makes the choice among them match the
+ * order of the node set.  If nodes remain when no candidate is left,
+ * each of them lies on or after a cycle.
+ */
+
+template <typename NodeType,typename ArcType>
+Vector<NodeType *> topologicalSort(const FrozenGraph<NodeType,ArcType> & fg) {
+   int nNodes = fg.size();
+   const int *offsets = fg.getOutOffsets();
+   const int *targets = fg.getOutTargets();
+   const int *inOffsets = fg.getInOffsets();
+   int *inDegree = new int[nNodes];
+   PriorityQueue<int,int> ready;
+   for (int v = 0; v < nNodes; v++) {
+      inDegree[v] = inOffsets[v + 1] - inOffsets[v];
+      if (inDegree[v] == 0) ready.enqueue(v, v);
+   }
+   Vector<NodeType *> order;
+   while (!ready.isEmpty()) {
+      int v = ready.dequeue();
+      order.add(fg.getNode(v));
+      for (int i = offsets[v]; i < offsets[v + 1]; i++) {
+         int w = targets[i];
+         if (--inDegree[w] == 0) ready.enqueue(w, w);
+      }
+   }
+   delete[] inDegree;
+   if (order.size() != nNodes) error("topologicalSort: Graph has a cycle");
+   return order;
+}
+
+template <typename NodeType,typename ArcType>
+Vector< Vector<NodeType *> >
+   stronglyConnectedComponents(Graph<NodeType,ArcType> & g) {
+   return stronglyConnectedComponents(FrozenGraph<NodeType,ArcType>(g));
+}
+
+/*
+ * Implementation notes: stronglyConnectedComponents
+ * -------------------------------------------------
+ * Tarjan's algorithm is usually written recursively, but a path in a
+ * large graph can be long enough to overflow the C++ call stack.  This
+ * version keeps its own stack of calls, in which callNode holds the
+ * node being explored at each level and nextArc holds the next of its
+ * arcs to follow.  The index of each node is the order in which the
+ * search first reached it, and low is the smallest index that can be
+ * reached from the node's subtree by following at most one arc back to
+ * a node that is still on the component stack.
+ */
+
+template <typename NodeType,typename ArcType>
+Vector< Vector<NodeType *> >
+   stronglyConnectedComponents(const FrozenGraph<NodeType,ArcType> & fg) {
+   int nNodes = fg.size();
+   const int *offsets = fg.getOutOffsets();
+   const int *targets = fg.getOutTargets();
+   int *index = new int[nNodes];
+   int *low = new int[nNodes];
+   bool *onStack = new bool[nNodes];
+   int *stack = new int[nNodes];
+   int *callNode = new int[nNodes];
+   int *nextArc = new int[nNodes];
+   for (int v = 0; v < nNodes; v++) {
+      index[v] = -1;
+      onStack[v] = false;
+   }
+   Vector< Vector<NodeType *> > components;
+   int counter = 0;
+   int sp = 0;
+   for (int root = 0; root < nNodes; root++) {
+      if (index[root] >= 0) continue;
+      int depth = 0;
+      index[root] = low[root] = counter++;
+      stack[sp++] = root;
+      onStack[root] = true;
+      callNode[depth] = root;
+      nextArc[depth++] = offsets[root];
+      while (depth > 0) {
+         int v = callNode[depth - 1];
+         if (nextArc[depth - 1] < offsets[v + 1]) {
+            int w = targets[nextArc[depth - 1]++];
+            if (index[w] < 0) {
+               index[w] = low[w] = counter++;
+               stack[sp++] = w;
+               onStack[w] = true;
+               callNode[depth] = w;
+               nextArc[depth++] = offsets[w];
+            } else if (onStack[w] && index[w] < low[v]) {
+               low[v] = index[w];
+            }
+         } else {
+            depth--;
+            if (low[v] == index[v]) {
+               Vector<NodeType *> component;
+               int w;
+               do {
+                  w = stack[--sp];
+                  onStack[w] = false;
+                  component.add(fg.getNode(w));
+               } while (w != v);
+               components.add(component);
+            }
+            if (depth > 0) {
+               int u = callNode[depth - 1];
+               if (low[v] < low[u]) low[u] = low[v];
+            }
+         }
+      }
+   }
+   delete[] index;
+   delete[] low;
+   delete[] onStack;
+   delete[] stack;
+   delete[] callNode;
+   delete[] nextArc;
+   return components;
+}
+
+#endif
@@ -0,0 +1,67 @@
+/*
+ * File: graphsearchpriv.h
+ * -----------------------
+ * This file contains the private section of the graphsearch.h
+ * interface.
+ */
+
+/*
+ * Implementation notes: GraphSearch data structure
+ * ------------------------------------------------
+ * Rather than clearing its arrays before each search, the object
+ * keeps a search number and records in stamp[v] the number of the
+ * search that last reached node v.  A node whose stamp differs from
+ * the current search number has not been reached, and the other
+ * arrays are read only for nodes that have.  While a node is in the
+ * heap, heapPos[v] gives its position there; a node that has been
+ * removed from the heap has heapPos[v] equal to -1.
+ */
+
+private:
+
+/* Instance variables */
+
+   FrozenGraph<NodeType,ArcType> fg;   /* The snapshot being searched   */
+   int nNodes;                         /* The number of nodes           */
+   int start;                          /* Start of the last search      */
+   int searchNumber;                   /* Number of the current search  */
+   int *stamp;                         /* Last search to reach each node */
+   double *dist;                       /* Distance from the start       */
+   double *estimate;                   /* Heuristic estimate to goal    */
+   int *parentArc;                     /* Last arc on the path, or -1   */
+   int *heap;                          /* Node ids in heap order        */
+   int *heapPos;                       /* Position in heap, or -1       */
+   int heapSize;                       /* Number of nodes in the heap   */
+   bool negativeWeights;               /* True if any weight is < 0     */
+
+/* Private method prototypes */
+
+   void init();
+   int startSearch(NodeType *node, std::string caller);
+   template <typename HeuristicFunction>
+   void runBestFirst(int goal, HeuristicFunction h, NodeType *goalNode);
+   bool reached(int v) const;
+   Vector<ArcType *> tracePath(int v) const;
+   double heapKey(int v) const;
+   void heapInsert(int v);
+   void heapMoveUp(int pos);
+   int heapRemoveMin();
+
+/* Heuristic used when runBestFirst implements Dijkstra's algorithm */
+
+   struct ZeroHeuristic {
+      double operator()(NodeType *, NodeType *) const {
+         return 0;
+      }
+   };
+
+/*
+ * Hidden features
+ * ---------------
+ * A search object owns large arrays that are rarely worth copying, so
+ * the copy constructor and assignment operator are declared private
+ * and are never defined.
+ */
+
+   GraphSearch(const GraphSearch & src);
+   GraphSearch & operator=(const GraphSearch & src);
@@ -13,17 +13,19 @@ Grid<ValueType>::Grid() {
    elements = NULL;
    nRows = 0;
    nCols = 0;
+   shareCount = NULL;
 }
 
 template <typename ValueType>
 Grid<ValueType>::Grid(int nRows, int nCols) {
    elements = NULL;
+   shareCount = NULL;
    resize(nRows, nCols);
 }
 
 template <typename ValueType>
 Grid<ValueType>::~Grid() {
-   if (elements != NULL) delete[] elements;
+   releaseElements();
 }
 
 template <typename ValueType>
@@ -43,14 +45,13 @@ void Grid<ValueType>::resize(int nRows, int nCols) {
             + integerToString(nRows) + ", "
             + integerToString(nCols) + ")");
    }
-   if (elements != NULL) delete[] elements;
+   bool shared = shareCount != NULL;
+   releaseElements();
    this->nRows = nRows;
    this->nCols = nCols;
    elements = new ValueType[nRows * nCols];
-   ValueType value = ValueType();
-   for (int i = 0; i < nRows * nCols; i++) {
-      elements[i] = value;
-   }
+   shareCount = (shared) ? new int(1) : NULL;
+   fill(ValueType());
 }
 
 template <typename ValueType>
@@ -60,9 +61,84 @@ bool Grid<ValueType>::inBounds(int row, int col) const {
 
 template <typename ValueType>
 typename Grid<ValueType>::GridRow Grid<ValueType>::operator[](int row) {
+   detachElements();
    return GridRow(this, row);
 }
 
+template <typename ValueType>
+ValueType *Grid<ValueType>::rowPtr(int row) {
+   checkRow(row, "rowPtr");
+   detachElements();
+   return elements + row * nCols;
+}
+
+template <typename ValueType>
+const ValueType *Grid<ValueType>::rowPtr(int row) const {
+   checkRow(row, "rowPtr");
+   return elements + row * nCols;
+}
+
+template <typename ValueType>
+typename Grid<ValueType>::RowView Grid<ValueType>::row(int row) {
+   checkRow(row, "row");
+   detachElements();
+   return RowView(elements + row * nCols, nCols);
+}
+
+template <typename ValueType>
+ValueType *Grid<ValueType>::data() {
+   detachElements();
+   return elements;
+}
+
+template <typename ValueType>
+void Grid<ValueType>::setCopyOnWrite(bool flag) {
+   if (flag && shareCount == NULL) {
+      shareCount = new int(1);
+   } else if (!flag && shareCount != NULL) {
+      detachElements();
+      delete shareCount;
+      shareCount = NULL;
+   }
+}
+
+template <typename ValueType>
+bool Grid<ValueType>::isCopyOnWrite() const {
+   return shareCount != NULL;
+}
+
+template <typename ValueType>
+const ValueType *Grid<ValueType>::data() const {
+   return elements;
+}
+
+/*
+ * Implementation notes: fill, transform
+ * -------------------------------------
+ * Both methods make a single pass over the element array using a local
+ * pointer and a precomputed end.  The loop bound then cannot change
+ * inside the loop, so the compiler can vectorize the loop body.
+ */
+
+template <typename ValueType>
+void Grid<ValueType>::fill(const ValueType & value) {
+   detachElements();
+   ValueType *end = elements + nRows * nCols;
+   for (ValueType *p = elements; p < end; p++) {
+      *p = value;
+   }
+}
+
+template <typename ValueType>
+template <typename FunctionType>
+void Grid<ValueType>::transform(FunctionType fn) {
+   detachElements();
+   ValueType *end = elements + nRows * nCols;
+   for (ValueType *p = elements; p < end; p++) {
+      *p = fn(*p);
+   }
+}
+
 template <typename ValueType>
 void Grid<ValueType>::mapAll(void (*fn)(ValueType)) {
    for (int i = 0; i < nRows * nCols; i++) {
@@ -79,4 +155,43 @@ void Grid<ValueType>::mapAll(void (*fn)(ValueType, ClientDataType&),
    }
 }
 
+/*
+ * Implementation notes: detachElements, releaseElements
+ * -----------------------------------------------------
+ * These methods follow the same pattern as the corresponding methods
+ * in the Map class: a grid copies a shared array before changing it,
+ * and the last grid to release an array deletes it.
+ */
+
+template <typename ValueType>
+void Grid<ValueType>::detachElements() {
+   if (shareCount != NULL && atomicLoad(shareCount) > 1) {
+      int n = nRows * nCols;
+      ValueType *array = new ValueType[n];
+      for (int i = 0; i < n; i++) {
+         array[i] = elements[i];
+      }
+      releaseElements();
+      elements = array;
+      shareCount = new int(1);
+   }
+}
+
+template <typename ValueType>
+void Grid<ValueType>::releaseElements() {
+   if (shareCount == NULL) {
+      delete[] elements;
+   } else if (atomicDecrement(shareCount) == 0) {
+      delete[] elements;
+      delete shareCount;
+   }
+}
+
+template <typename ValueType>
+void Grid<ValueType>::checkRow(int row, std::string caller) const {
+   if (row < 0 || row >= nRows) {
+      error(caller + ": row " + integerToString(row) + " out of range");
+   }
+}
+
 #endif
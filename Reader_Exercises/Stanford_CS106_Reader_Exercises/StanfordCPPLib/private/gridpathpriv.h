@@ -0,0 +1,137 @@
+/*
+ * File: gridpathpriv.h
+ * --------------------
+ * This file contains the private section of the gridpath.h interface.
+ */
+
+/*
+ * Implementation notes: GridPathfinder data structure
+ * ---------------------------------------------------
+ * The cost map is stored as a flat array of doubles in row-major order,
+ * so each cell is identified by the single index row * nCols + col.
+ * The working storage for a search is kept in a Workspace, which holds
+ * the distance and parent of each cell in flat arrays, two bitmaps that
+ * record which cells have been reached and which have been finished,
+ * and the queue or heap that orders the search.  The arrays are sized
+ * for the whole map and are not cleared between searches; only the
+ * bitmaps are cleared, and the other entries for a cell are read only
+ * after its bit in the seen bitmap has been set.
+ */
+
+private:
+
+/* Type used for entries in the priority queue */
+
+   struct HeapEntry {
+      double key;
+      int cell;
+   };
+
+/* Type used to hold the working storage for one search at a time */
+
+   struct Workspace {
+      int capacity;            /* Number of cells the arrays can hold    */
+      double *dist;            /* Best known distance to each cell       */
+      int *parent;             /* Previous cell on the best path, or -1  */
+      uint64_t *seen;          /* Bitmap of cells with a valid distance  */
+      uint64_t *closed;        /* Bitmap of cells that are finished      */
+      int *queue;              /* Queue for breadth-first search         */
+      HeapEntry *heap;         /* Binary min-heap ordered by key         */
+      int heapSize;            /* Number of entries in the heap          */
+      int heapCapacity;        /* Number of entries allocated            */
+   };
+
+/* Type used to pass a batch of searches to the thread pool */
+
+   struct BatchTask {
+      const GridPathfinder *finder;
+      PathAlgorithm algorithm;
+      const PathQuery *queries;
+      PathResult *results;
+      int n;
+      int nThreads;
+   };
+
+/* Instance variables */
+
+   double *costs;              /* The cost of entering each cell         */
+   int nRows;                  /* The number of rows in the map          */
+   int nCols;                  /* The number of columns in the map       */
+   PathMoves moves;            /* The moves that a path may make         */
+   double minCost;             /* The smallest cost of any open cell     */
+   bool uniform;               /* True if all open cells cost the same   */
+   Workspace workspace;        /* The storage used by findPath           */
+
+/* Private method prototypes */
+
+   template <typename ValueType>
+   static void copyRow(double *dst, const ValueType *src, int n);
+
+   void computeCostStatistics();
+   void checkQuery(PathAlgorithm algorithm, int startRow, int startCol,
+                   int goalRow, int goalCol, std::string caller) const;
+   double runSearch(Workspace & ws, PathAlgorithm algorithm, int start,
+                    int goal, Vector<Point> & path) const;
+   double searchBFS(Workspace & ws, int start, int goal) const;
+   double searchBestFirst(Workspace & ws, int start, int goal,
+                          bool useHeuristic) const;
+   double searchJPS(Workspace & ws, int start, int goal) const;
+   int jump(int row, int col, int dRow, int dCol, int goal) const;
+   double heuristic(int cell, int goal) const;
+   double stepLength(int from, int to) const;
+   bool isOpenCell(int row, int col) const;
+   void tracePath(const Workspace & ws, int goal,
+                  Vector<Point> & path) const;
+
+   static void initWorkspace(Workspace & ws);
+   static void freeWorkspace(Workspace & ws);
+   static void prepareWorkspace(Workspace & ws, int nCells);
+   static void heapPush(Workspace & ws, double key, int cell);
+   static HeapEntry heapPop(Workspace & ws);
+   static void runBatch(BatchTask & task, int index);
+
+/*
+ * Hidden features
+ * ---------------
+ * The remainder of this file consists of the code required to
+ * support deep copying.  Including these methods in the public
+ * interface would make that interface more difficult to understand
+ * for the average client.
+ */
+
+/*
+ * Deep copying support
+ * --------------------
+ * This copy constructor and operator= are defined to make a deep copy
+ * of the cost map.  The working storage is not copied; the copy
+ * allocates its own the first time it runs a search.
+ */
+
+   void copyInternalData(const GridPathfinder & finder) {
+      nRows = finder.nRows;
+      nCols = finder.nCols;
+      moves = finder.moves;
+      minCost = finder.minCost;
+      uniform = finder.uniform;
+      int n = nRows * nCols;
+      costs = new double[n];
+      for (int i = 0; i < n; i++) {
+         costs[i] = finder.costs[i];
+      }
+      initWorkspace(workspace);
+   }
+
+public:
+
+   GridPathfinder & operator=(const GridPathfinder & rhs) {
+      if (this != &rhs) {
+         delete[] costs;
+         freeWorkspace(workspace);
+         copyInternalData(rhs);
+      }
+      return *this;
+   }
+
+   GridPathfinder(const GridPathfinder & rhs) {
+      copyInternalData(rhs);
+   }
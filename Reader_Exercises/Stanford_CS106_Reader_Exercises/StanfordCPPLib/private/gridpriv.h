@@ -12,7 +12,8 @@
  * rows and columns is done by arithmetic computation.  The layout
  * is in row-major order, which is to say that the entire first row
  * is laid out contiguously, followed by the entire second row,
- * and so on.
+ * and so on.  If copy-on-write sharing is enabled, shareCount points
+ * to an atomic count of the grids that share the array.
  */
 
 /* Instance variables */
@@ -20,10 +21,13 @@
    ValueType *elements;  /* A dynamic array of the elements   */
    int nRows;            /* The number of rows in the grid    */
    int nCols;            /* The number of columns in the grid */
+   int *shareCount;      /* Grids sharing elements, or NULL   */
 
 /* Private method prototypes */
 
-   void checkRange(int row, int col);
+   void checkRow(int row, std::string caller) const;
+   void detachElements();
+   void releaseElements();
 
 /*
  * Hidden features
@@ -45,24 +49,31 @@
  * assignment (operator=). Making copies is generally avoided
  * because of the expense and thus, grids are typically passed
  * by reference, however, when a copy is needed, these operations
- * are supported.
+ * are supported.  A copy-on-write grid shares the element array
+ * instead, so copying it takes constant time.
  */
 
    void copyInternalData(const Grid & grid) {
+      nRows = grid.nRows;
+      nCols = grid.nCols;
+      shareCount = grid.shareCount;
+      if (shareCount != NULL) {
+         elements = grid.elements;
+         atomicIncrement(shareCount);
+         return;
+      }
       int n = grid.nRows * grid.nCols;
       elements = new ValueType[n];
       for (int i = 0; i < n; i++) {
          elements[i] = grid.elements[i];
       }
-      nRows = grid.nRows;
-      nCols = grid.nCols;
    }
 
 public:
 
    Grid & operator=(const Grid & rhs) {
       if (this != &rhs) {
-         delete[] elements;
+         releaseElements();
          copyInternalData(rhs);
       }
       return *this;
@@ -143,9 +154,9 @@ public:
       }
 
       ValueType & operator[](int col) {
-              if (!gp->inBounds(row, col)) {
-                 error("Grid index values out of range");
-              }
+         if (!gp->inBounds(row, col)) {
+            error("Grid index values out of range");
+         }
          return gp->elements[(row * gp->nCols) + col];
       }
 
@@ -160,3 +171,46 @@ public:
       friend class Grid;
    };
    friend class GridRow;
+
+/*
+ * Class: Grid<ValType>::RowView
+ * -----------------------------
+ * This class is the view returned by the row method.  It holds a pointer
+ * to the first element of the row and the row length, so that indexing
+ * it involves no further reference to the grid.  The column index is
+ * not checked, which makes the view suitable for inner loops.
+ */
+
+   class RowView {
+   public:
+      RowView() {
+         start = NULL;
+         length = 0;
+      }
+
+      int size() const {
+         return length;
+      }
+
+      ValueType & operator[](int col) const {
+         return start[col];
+      }
+
+      ValueType *begin() const {
+         return start;
+      }
+
+      ValueType *end() const {
+         return start + length;
+      }
+
+   private:
+      RowView(ValueType *start, int length) {
+         this->start = start;
+         this->length = length;
+      }
+
+      ValueType *start;
+      int length;
+      friend class Grid;
+   };
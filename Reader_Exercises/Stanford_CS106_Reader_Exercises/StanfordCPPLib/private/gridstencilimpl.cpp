@@ -0,0 +1,247 @@
+/*
+ * File: gridstencilimpl.cpp
+ * -------------------------
+ * This file contains the implementation of the gridstencil.h interface.
+ * Because of the way C++ compiles templates, this code must be
+ * available to the compiler when it reads the header file.
+ */
+
+#ifdef _gridstencil_h
+
+template <typename ValueType>
+GridStencil<ValueType>::GridStencil(const Grid<ValueType> & grid,
+                                    int radius) {
+   if (radius < 1 || radius > MAX_RADIUS) {
+      error("GridStencil: radius must be 1 or 2");
+   }
+   buffers[0] = grid;
+   buffers[0].setCopyOnWrite(false);
+   buffers[1].resize(grid.numRows(), grid.numCols());
+   current = 0;
+   this->radius = radius;
+   policy = EDGE_CLAMP;
+   edgeValue = ValueType();
+   nThreads = 1;
+   tileWidth = TILE_BYTES / ((2 * radius + 1) * (int) sizeof(ValueType));
+   if (tileWidth < 16) tileWidth = 16;
+}
+
+template <typename ValueType>
+GridStencil<ValueType>::~GridStencil() {
+   /* Empty */
+}
+
+template <typename ValueType>
+int GridStencil<ValueType>::numRows() const {
+   return buffers[current].numRows();
+}
+
+template <typename ValueType>
+int GridStencil<ValueType>::numCols() const {
+   return buffers[current].numCols();
+}
+
+template <typename ValueType>
+int GridStencil<ValueType>::getRadius() const {
+   return radius;
+}
+
+template <typename ValueType>
+void GridStencil<ValueType>::setEdgePolicy(EdgePolicy policy,
+                                           ValueType value) {
+   this->policy = policy;
+   edgeValue = value;
+}
+
+template <typename ValueType>
+EdgePolicy GridStencil<ValueType>::getEdgePolicy() const {
+   return policy;
+}
+
+template <typename ValueType>
+void GridStencil<ValueType>::setThreadCount(int nThreads) {
+   if (nThreads < 1) {
+      error("setThreadCount: thread count must be at least 1");
+   }
+   this->nThreads = nThreads;
+}
+
+template <typename ValueType>
+int GridStencil<ValueType>::getThreadCount() const {
+   return nThreads;
+}
+
+template <typename ValueType>
+void GridStencil<ValueType>::setTileWidth(int nCols) {
+   if (nCols < 1) {
+      error("setTileWidth: tile width must be at least 1");
+   }
+   tileWidth = nCols;
+}
+
+template <typename ValueType>
+Grid<ValueType> & GridStencil<ValueType>::getGrid() {
+   return buffers[current];
+}
+
+template <typename ValueType>
+ValueType GridStencil<ValueType>::get(int row, int col) {
+   return buffers[current][row][col];
+}
+
+template <typename ValueType>
+void GridStencil<ValueType>::set(int row, int col, ValueType value) {
+   buffers[current][row][col] = value;
+}
+
+/*
+ * Implementation notes: step
+ * --------------------------
+ * The rows are divided into nThreads bands of nearly equal size.  The
+ * first band is computed by the calling thread, and each of the others
+ * by a thread created with fork.  Every thread writes only the rows of
+ * its own band, so no locking is needed, and the join calls ensure
+ * that the whole generation is finished before the buffers are swapped.
+ * Neither buffer may share its elements with another grid while the
+ * threads run, because a worker would then detach the shared array at
+ * the same time as others read it.  The constructor turns sharing off,
+ * and step turns it off again in case the client has turned it back on
+ * through getGrid.
+ */
+
+template <typename ValueType>
+template <typename KernelType>
+void GridStencil<ValueType>::step(KernelType kernel, int nSteps) {
+   int nRows = numRows();
+   int nBands = (nThreads < nRows) ? nThreads : nRows;
+   if (nBands < 1 || numCols() == 0) return;
+   buffers[0].setCopyOnWrite(false);
+   buffers[1].setCopyOnWrite(false);
+   StencilTask<KernelType> *tasks = new StencilTask<KernelType>[nBands];
+   Thread *threads = new Thread[nBands];
+   for (int i = 0; i < nBands; i++) {
+      tasks[i].stencil = this;
+      tasks[i].kernel = &kernel;
+      tasks[i].startRow = (int) ((long) nRows * i / nBands);
+      tasks[i].endRow = (int) ((long) nRows * (i + 1) / nBands);
+   }
+   for (int s = 0; s < nSteps; s++) {
+      for (int i = 1; i < nBands; i++) {
+         threads[i] = fork(runTask<KernelType>, tasks[i]);
+      }
+      runTask(tasks[0]);
+      for (int i = 1; i < nBands; i++) {
+         join(threads[i]);
+      }
+      current = 1 - current;
+   }
+   delete[] threads;
+   delete[] tasks;
+}
+
+template <typename ValueType>
+template <typename KernelType>
+void GridStencil<ValueType>::runTask(StencilTask<KernelType> & task) {
+   task.stencil->applyKernel(*task.kernel, task.startRow, task.endRow);
+}
+
+/*
+ * Implementation notes: applyKernel
+ * ---------------------------------
+ * This method computes rows startRow through endRow - 1 of the next
+ * generation.  The columns are processed in strips of tileWidth, and
+ * within each strip the rows are processed from top to bottom, which
+ * means that each input row is read from the cache by the 2 * radius
+ * output rows that follow.  For each output row, rowPtrs[k] is set to
+ * the start of the strip in row r + k - radius, extended by radius
+ * cells on each side.  Those cells lie in the grid unless the strip
+ * touches an edge, in which case the row is built in a scratch row.
+ * The current buffer is read through a constant reference so that the
+ * workers never call the methods that detach a shared array.
+ */
+
+template <typename ValueType>
+template <typename KernelType>
+void GridStencil<ValueType>::applyKernel(KernelType & kernel,
+                                         int startRow, int endRow) {
+   int nRows = numRows();
+   int nCols = numCols();
+   int span = 2 * radius + 1;
+   int paddedWidth = tileWidth + 2 * radius;
+   const Grid<ValueType> & source = buffers[current];
+   const ValueType *src = source.data();
+   ValueType *dst = buffers[1 - current].data();
+   ValueType *scratch = new ValueType[span * paddedWidth];
+   const ValueType *rowPtrs[2 * MAX_RADIUS + 1];
+   Neighborhood nb;
+   nb.rows = rowPtrs + radius;
+   for (int c0 = 0; c0 < nCols; c0 += tileWidth) {
+      int c1 = (c0 + tileWidth < nCols) ? c0 + tileWidth : nCols;
+      bool inside = c0 - radius >= 0 && c1 + radius <= nCols;
+      nb.firstCol = c0 - radius;
+      for (int r = startRow; r < endRow; r++) {
+         for (int k = 0; k < span; k++) {
+            int sr = r + k - radius;
+            if (inside && sr >= 0 && sr < nRows) {
+               rowPtrs[k] = src + sr * nCols + c0 - radius;
+            } else {
+               ValueType *buffer = scratch + k * paddedWidth;
+               loadPaddedRow(buffer, sr, c0 - radius, c1 + radius);
+               rowPtrs[k] = buffer;
+            }
+         }
+         nb.row = r;
+         ValueType *out = dst + r * nCols + c0;
+         int width = c1 - c0;
+         for (int i = 0; i < width; i++) {
+            nb.index = i + radius;
+            out[i] = kernel(nb);
+         }
+      }
+   }
+   delete[] scratch;
+}
+
+/*
+ * Implementation notes: loadPaddedRow, mapIndex
+ * ---------------------------------------------
+ * loadPaddedRow copies columns startCol through endCol - 1 of the given
+ * row into dst, where the row and column numbers may lie outside the
+ * grid.  Under EDGE_CONSTANT, such cells take the edge value; otherwise
+ * mapIndex converts each index to the cell that the policy designates.
+ */
+
+template <typename ValueType>
+void GridStencil<ValueType>::loadPaddedRow(ValueType *dst, int row,
+                                           int startCol, int endCol) {
+   int nRows = numRows();
+   int nCols = numCols();
+   int n = endCol - startCol;
+   if (policy == EDGE_CONSTANT && (row < 0 || row >= nRows)) {
+      for (int i = 0; i < n; i++) {
+         dst[i] = edgeValue;
+      }
+      return;
+   }
+   const Grid<ValueType> & source = buffers[current];
+   const ValueType *src = source.data() + mapIndex(row, nRows) * nCols;
+   for (int i = 0; i < n; i++) {
+      int col = startCol + i;
+      if (col >= 0 && col < nCols) {
+         dst[i] = src[col];
+      } else if (policy == EDGE_CONSTANT) {
+         dst[i] = edgeValue;
+      } else {
+         dst[i] = src[mapIndex(col, nCols)];
+      }
+   }
+}
+
+template <typename ValueType>
+int GridStencil<ValueType>::mapIndex(int index, int n) const {
+   if (index >= 0 && index < n) return index;
+   if (policy == EDGE_WRAP) return ((index % n) + n) % n;
+   return (index < 0) ? 0 : n - 1;
+}
+
+#endif
@@ -0,0 +1,98 @@
+/*
+ * File: gridstencilpriv.h
+ * -----------------------
+ * This file contains the private section of the gridstencil.h interface.
+ */
+
+/*
+ * Implementation notes: GridStencil data structure
+ * ------------------------------------------------
+ * The two generations are stored as a pair of grids, and the index
+ * current selects the one that holds the current values.  A step
+ * reads from that grid, writes every cell of the other, and then flips
+ * the index.  Because each grid is a single row-major array, the kernel
+ * reads its neighbors through an array of row pointers, one for each
+ * row of the neighborhood, so a neighbor access is a single indexed
+ * load.  Neighborhoods that lie entirely inside the grid point directly
+ * into the current buffer.  For strips along an edge, the rows are
+ * first copied into scratch rows, with extra cells beyond the border
+ * filled in according to the edge policy.
+ */
+
+private:
+
+/* Constants */
+
+   static const int MAX_RADIUS = 2;
+   static const int TILE_BYTES = 16384;
+
+/* Instance variables */
+
+   Grid<ValueType> buffers[2];    /* The two generations                 */
+   int current;                   /* Index of the current generation     */
+   int radius;                    /* Distance from center to edge        */
+   EdgePolicy policy;             /* Treatment of cells beyond the edge  */
+   ValueType edgeValue;           /* Value used by EDGE_CONSTANT         */
+   int nThreads;                  /* Number of threads used by step      */
+   int tileWidth;                 /* Number of columns in each strip     */
+
+/* Type used to pass a band of rows to a worker thread */
+
+   template <typename KernelType>
+   struct StencilTask {
+      GridStencil *stencil;
+      KernelType *kernel;
+      int startRow;
+      int endRow;
+   };
+
+/* Private method prototypes */
+
+   template <typename KernelType>
+   static void runTask(StencilTask<KernelType> & task);
+
+   template <typename KernelType>
+   void applyKernel(KernelType & kernel, int startRow, int endRow);
+
+   void loadPaddedRow(ValueType *dst, int row, int startCol, int endCol);
+   int mapIndex(int index, int n) const;
+
+public:
+
+/*
+ * Class: GridStencil<ValueType>::Neighborhood
+ * -------------------------------------------
+ * This class is the argument passed to a kernel.  The expression
+ * <code>nb(dr, dc)</code> returns the cell <code>dr</code> rows and
+ * <code>dc</code> columns away from the center, where each offset
+ * lies between <code>-radius</code> and <code>radius</code>.  The
+ * offsets are not checked.  The methods <code>getRow</code> and
+ * <code>getCol</code> return the position of the center cell.
+ */
+
+   class Neighborhood {
+   public:
+
+      const ValueType & operator()(int dr, int dc) const {
+         return rows[dr][index + dc];
+      }
+
+      const ValueType & center() const {
+         return rows[0][index];
+      }
+
+      int getRow() const {
+         return row;
+      }
+
+      int getCol() const {
+         return firstCol + index;
+      }
+
+   private:
+      const ValueType **rows;    /* Row pointers, centered on offset 0 */
+      int index;                 /* Index of the center in each row    */
+      int firstCol;              /* Column number of index 0           */
+      int row;                   /* Row number of the center           */
+      friend class GridStencil;
+   };
@@ -23,12 +23,14 @@
 
 template <typename KeyType,typename ValueType>
 HashMap<KeyType,ValueType>::HashMap() {
+   bloomFilter = NULL;
    createBuckets(INITIAL_BUCKET_COUNT);
 }
 
 template <typename KeyType,typename ValueType>
 HashMap<KeyType,ValueType>::~HashMap() {
    deleteBuckets(buckets);
+   delete bloomFilter;
 }
 
 template <typename KeyType,typename ValueType>
@@ -48,7 +50,13 @@ void HashMap<KeyType,ValueType>::put(KeyType key, ValueType value) {
 
 template <typename KeyType,typename ValueType>
 ValueType HashMap<KeyType,ValueType>::get(KeyType key) const {
-   Cell *cp = findCell(hashCode(key) % nBuckets, key);
+   Cell *cp = NULL;
+   if (!rejectedByFilter(key)) {
+      cp = findCell(hashCode(key) % nBuckets, key);
+      if (cp == NULL && bloomFilter != NULL) {
+         bloomFilter->recordFalsePositive();
+      }
+   }
    if (cp == NULL) {
       error("Attempt to get value for key which is not contained in map.");
    }
@@ -57,7 +65,10 @@ ValueType HashMap<KeyType,ValueType>::get(KeyType key) const {
 
 template <typename KeyType,typename ValueType>
 bool HashMap<KeyType,ValueType>::containsKey(KeyType key) const {
-   return findCell(hashCode(key) % nBuckets, key) != NULL;
+   if (rejectedByFilter(key)) return false;
+   Cell *cp = findCell(hashCode(key) % nBuckets, key);
+   if (cp == NULL && bloomFilter != NULL) bloomFilter->recordFalsePositive();
+   return cp != NULL;
 }
 
 template <typename KeyType,typename ValueType>
@@ -80,8 +91,18 @@ template <typename KeyType,typename ValueType>
 void HashMap<KeyType,ValueType>::clear() {
    deleteBuckets(buckets);
    numEntries = 0;
+   if (bloomFilter != NULL) bloomFilter->clear();
 }
 
+/*
+ * Implementation notes: operator[]
+ * --------------------------------
+ * The bucket chain is searched without consulting the Bloom filter, so
+ * that the counters in the filter reflect only the calls to get and
+ * containsKey.  The bucket index must be recomputed after a rehash,
+ * because the number of buckets has changed.
+ */
+
 template <typename KeyType,typename ValueType>
 ValueType & HashMap<KeyType,ValueType>::operator[](KeyType key) {
    int bucket = hashCode(key) % nBuckets;
@@ -89,6 +110,7 @@ ValueType & HashMap<KeyType,ValueType>::operator[](KeyType key) {
    if (cp == NULL) {
       if (numEntries > MAX_LOAD_PERCENTAGE * nBuckets / 100.0) {
          expandAndRehash();
+         bucket = hashCode(key) % nBuckets;
       }
       cp = new Cell;
       cp->key = key;
@@ -96,10 +118,44 @@ ValueType & HashMap<KeyType,ValueType>::operator[](KeyType key) {
       cp->next = buckets[bucket];
       buckets[bucket] = cp;
       numEntries++;
+      if (bloomFilter != NULL) bloomFilter->add(key);
    }
    return cp->value;
 }
 
+/*
+ * Implementation notes: enableBloomFilter, disableBloomFilter
+ * -----------------------------------------------------------
+ * The filter is sized to the current number of buckets, which bounds
+ * the number of keys the table holds before its next rehash, at which
+ * point expandAndRehash resizes the filter to match.
+ */
+
+template <typename KeyType,typename ValueType>
+void HashMap<KeyType,ValueType>::enableBloomFilter(double falsePositiveRate) {
+   delete bloomFilter;
+   bloomFilter = NULL;
+   BloomFilter<KeyType> *filter =
+      new BloomFilter<KeyType>(nBuckets, falsePositiveRate, hashKey);
+   for (int i = 0; i < nBuckets; i++) {
+      for (Cell *cp = buckets[i]; cp != NULL; cp = cp->next) {
+         filter->add(cp->key);
+      }
+   }
+   bloomFilter = filter;
+}
+
+template <typename KeyType,typename ValueType>
+void HashMap<KeyType,ValueType>::disableBloomFilter() {
+   delete bloomFilter;
+   bloomFilter = NULL;
+}
+
+template <typename KeyType,typename ValueType>
+const BloomFilter<KeyType> *HashMap<KeyType,ValueType>::getBloomFilter() const {
+   return bloomFilter;
+}
+
 template <typename KeyType,typename ValueType>
 template <typename ClientData>
 void HashMap<KeyType,ValueType>::mapAll(void (*fn)(KeyType, ClientData &),
@@ -8,7 +8,11 @@
  * Implementation notes:
  * ---------------------
  * The HashMap class is represented using a hash table that uses
- * bucket chaining to resolve collisions.
+ * bucket chaining to resolve collisions.  If the client enables a
+ * Bloom filter, it is kept in sync with the keys in the table and
+ * resized along with the buckets.  Removing a key leaves its bits
+ * set in the filter, which affects only the false-positive rate;
+ * those bits are cleared at the next rehash.
  */
 
 private:
@@ -31,6 +35,7 @@ private:
    Vector<Cell *> buckets;
    int nBuckets;
    int numEntries;
+   BloomFilter<KeyType> *bloomFilter;
 
 /* Private methods */
 
@@ -77,18 +82,52 @@ private:
  * and then rehashes all existing entries and adds them into new buckets.
  * This operation is used when the load factor (i.e. the number of cells
  * per bucket) has increased enough to warrant this O(N) operation to
- * enlarge and redistribute the entries.
+ * enlarge and redistribute the entries.  The keys are known to be
+ * distinct, so each cell is relinked into its new bucket without
+ * searching the chain or consulting the Bloom filter.
  */
 
    void expandAndRehash() {
       Vector<Cell *>oldBuckets = buckets;
+      int count = numEntries;
       createBuckets(oldBuckets.size() * 2 + 1);
+      if (bloomFilter != NULL) bloomFilter->resize(nBuckets);
       for (int i = 0; i < oldBuckets.size(); i++) {
-         for (Cell *cp = oldBuckets[i]; cp != NULL; cp = cp->next) {
-            put(cp->key, cp->value);
+         Cell *cp = oldBuckets[i];
+         while (cp != NULL) {
+            Cell *np = cp->next;
+            int bucket = hashCode(cp->key) % nBuckets;
+            cp->next = buckets[bucket];
+            buckets[bucket] = cp;
+            if (bloomFilter != NULL) bloomFilter->add(cp->key);
+            cp = np;
          }
       }
-      deleteBuckets(oldBuckets);
+      numEntries = count;
+   }
+
+/*
+ * Private method: rejectedByFilter
+ * Usage: if (rejectedByFilter(key)) . . .
+ * ---------------------------------------
+ * Returns true if a Bloom filter is enabled and it proves that key is
+ * not in the map.  Only the lookup methods call it, so the counters in
+ * the filter describe lookups alone.
+ */
+
+   bool rejectedByFilter(const KeyType & key) const {
+      return bloomFilter != NULL && !bloomFilter->mightContain(key);
+   }
+
+/*
+ * Private method: hashKey
+ * Usage: filter = new BloomFilter<KeyType>(n, rate, hashKey);
+ * -----------------------------------------------------------
+ * Adapts the hashCode function to the signature used by BloomFilter.
+ */
+
+   static int hashKey(const KeyType & key) {
+      return hashCode(key);
    }
 
 /*
@@ -105,12 +144,13 @@ private:
  * that the cell is the first cell in the bucket chain.
  */
 
-   Cell *findCell(int bucket, string key) const {
+   Cell *findCell(int bucket, const KeyType & key) const {
       Cell *dummy;
       return findCell(bucket, key, dummy);
    }
 
-   Cell *findCell(int bucket, string key, Cell * & parent) const {
+   Cell *findCell(int bucket, const KeyType & key,
+                  Cell * & parent) const {
       parent = NULL;
       Cell *cp = buckets.get(bucket);
       while (cp != NULL && key != cp->key) {
@@ -121,12 +161,16 @@ private:
    }
 
    void copyInternalData(const HashMap & rhs) {
+      bloomFilter = NULL;
       createBuckets(rhs.size());
       for (int i = 0; i < rhs.nBuckets; i++) {
          for (Cell *cp = rhs.buckets.get(i); cp != NULL; cp = cp->next) {
             put(cp->key, cp->value);
          }
       }
+      if (rhs.bloomFilter != NULL) {
+         bloomFilter = new BloomFilter<KeyType>(*rhs.bloomFilter);
+      }
    }
 
 public:
@@ -151,7 +195,7 @@ public:
    HashMap & operator=(const HashMap & rhs) {
       if (this != &rhs) {
          clear();
-         delete[] buckets;
+         delete bloomFilter;
          copyInternalData(rhs);
       }
       return *this;
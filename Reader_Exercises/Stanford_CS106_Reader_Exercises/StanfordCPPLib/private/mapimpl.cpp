@@ -13,11 +13,12 @@ Map<KeyType,ValueType>::Map(int (*cmpFn)(KeyType, KeyType)) {
    root = NULL;
    nodeCount = 0;
    this->cmpFn = cmpFn;
+   shareCount = NULL;
 }
 
 template <typename KeyType, typename ValueType>
 Map<KeyType,ValueType>::~Map() {
-   deleteTree(root);
+   releaseTree();
 }
 
 template <typename KeyType, typename ValueType>
@@ -33,9 +34,61 @@ bool Map<KeyType,ValueType>::isEmpty() const {
 template <typename KeyType, typename ValueType>
 void Map<KeyType,ValueType>::put(KeyType key, ValueType value) {
    bool dummy;
+   detachTree();
    *addNode(root, key, dummy) = value;
 }
 
+/*
+ * Implementation notes: putSorted
+ * -------------------------------
+ * The keys are checked before anything changes.  The existing nodes
+ * are then listed in order and merged with new nodes for the keys,
+ * reusing the node of any key that is already present, and the
+ * merged list is linked into a balanced tree by buildTree.
+ */
+
+template <typename KeyType, typename ValueType>
+void Map<KeyType,ValueType>::putSorted(const KeyType *keys,
+                                       const ValueType *values, int n) {
+   for (int i = 1; i < n; i++) {
+      if (cmpFn(keys[i - 1], keys[i]) >= 0) {
+         error("putSorted: Keys are not in increasing order");
+      }
+   }
+   if (n == 0) return;
+   detachTree();
+   int nOld = nodeCount;
+   BSTNode **oldNodes = new BSTNode *[nOld];
+   BSTNode **merged = new BSTNode *[nOld + n];
+   flattenTree(root, oldNodes, 0);
+   int total = 0;
+   int i = 0;
+   int j = 0;
+   while (i < nOld || j < n) {
+      int sign = +1;
+      if (j == n) {
+         sign = -1;
+      } else if (i < nOld) {
+         sign = cmpFn(oldNodes[i]->key, keys[j]);
+      }
+      if (sign < 0) {
+         merged[total++] = oldNodes[i++];
+      } else if (sign == 0) {
+         oldNodes[i]->value = values[j++];
+      } else {
+         BSTNode *np = new BSTNode();
+         np->key = keys[j];
+         np->value = values[j++];
+         merged[total++] = np;
+      }
+   }
+   int height;
+   root = buildTree(merged, total, height);
+   nodeCount = total;
+   delete[] oldNodes;
+   delete[] merged;
+}
+
 template <typename KeyType, typename ValueType>
 ValueType Map<KeyType,ValueType>::get(KeyType key) const {
    ValueType *vp = findNode(root, key);
@@ -47,14 +100,18 @@ ValueType Map<KeyType,ValueType>::get(KeyType key) const {
 
 template <typename KeyType, typename ValueType>
 void Map<KeyType,ValueType>::remove(KeyType key) {
+   if (shareCount != NULL && findNode(root, key) == NULL) return;
+   detachTree();
    removeNode(root, key);
 }
 
 template <typename KeyType, typename ValueType>
 void Map<KeyType,ValueType>::clear() {
-   deleteTree(root);
+   bool shared = shareCount != NULL;
+   releaseTree();
    root = NULL;
    nodeCount = 0;
+   shareCount = (shared) ? new int(1) : NULL;
 }
 
 template <typename KeyType, typename ValueType>
@@ -65,9 +122,26 @@ bool Map<KeyType,ValueType>::containsKey(KeyType key) const {
 template <typename KeyType, typename ValueType>
 ValueType & Map<KeyType,ValueType>::operator[](KeyType key) {
    bool dummy;
+   detachTree();
    return *addNode(root, key, dummy);
 }
 
+template <typename KeyType, typename ValueType>
+void Map<KeyType,ValueType>::setCopyOnWrite(bool flag) {
+   if (flag && shareCount == NULL) {
+      shareCount = new int(1);
+   } else if (!flag && shareCount != NULL) {
+      detachTree();
+      delete shareCount;
+      shareCount = NULL;
+   }
+}
+
+template <typename KeyType, typename ValueType>
+bool Map<KeyType,ValueType>::isCopyOnWrite() const {
+   return shareCount != NULL;
+}
+
 template <typename KeyType, typename ValueType>
 void Map<KeyType,ValueType>::mapAll(void (*fn)(KeyType)) {
    mapAll(root, fn);
@@ -354,6 +428,76 @@ void Map<KeyType,ValueType>::deleteTree(BSTNode *t) {
    }
 }
 
+/*
+ * Implementation notes: flattenTree(t, array, k), buildTree(array, n, h)
+ * ----------------------------------------------------------------------
+ * The flattenTree method stores the nodes of the tree in order in the
+ * array, starting at index k, and returns the index after the last one.
+ * The buildTree method links the n nodes in the array, which must be in
+ * order, into a tree that takes the middle node as its root and builds
+ * its subtrees in the same way.  The two subtrees differ in size by at
+ * most one node and therefore in height by at most one level, so the
+ * result is a valid AVL tree whose balance factors follow directly
+ * from the heights.  The height of the new tree is returned in h.
+ */
+
+template <typename KeyType, typename ValueType>
+int Map<KeyType,ValueType>::flattenTree(BSTNode *t, BSTNode **array, int k) {
+   if (t == NULL) return k;
+   k = flattenTree(t->left, array, k);
+   array[k++] = t;
+   return flattenTree(t->right, array, k);
+}
+
+template <typename KeyType, typename ValueType>
+typename Map<KeyType,ValueType>::BSTNode *
+         Map<KeyType,ValueType>::buildTree(BSTNode **array, int n,
+                                           int & h) {
+   if (n == 0) {
+      h = 0;
+      return NULL;
+   }
+   int mid = n / 2;
+   int leftHeight, rightHeight;
+   BSTNode *t = array[mid];
+   t->left = buildTree(array, mid, leftHeight);
+   t->right = buildTree(array + mid + 1, n - mid - 1, rightHeight);
+   t->bf = rightHeight - leftHeight;
+   h = 1 + ((leftHeight > rightHeight) ? leftHeight : rightHeight);
+   return t;
+}
+
+/*
+ * Implementation notes: detachTree, releaseTree
+ * ---------------------------------------------
+ * The detachTree method gives this map a tree of its own before it is
+ * changed, if the tree is currently shared.  The releaseTree method
+ * gives up this map's claim on its tree, deleting the tree only if no
+ * other map shares it.  Because the count is decremented atomically,
+ * exactly one of the maps sharing a tree sees it reach zero, even if
+ * several of them release the tree at the same time.
+ */
+
+template <typename KeyType, typename ValueType>
+void Map<KeyType,ValueType>::detachTree() {
+   if (shareCount != NULL && atomicLoad(shareCount) > 1) {
+      BSTNode *copy = copyTree(root);
+      releaseTree();
+      root = copy;
+      shareCount = new int(1);
+   }
+}
+
+template <typename KeyType, typename ValueType>
+void Map<KeyType,ValueType>::releaseTree() {
+   if (shareCount == NULL) {
+      deleteTree(root);
+   } else if (atomicDecrement(shareCount) == 0) {
+      deleteTree(root);
+      delete shareCount;
+   }
+}
+
 /*
  * Implementation notes: mapAll(t, fn)
  * -----------------------------------
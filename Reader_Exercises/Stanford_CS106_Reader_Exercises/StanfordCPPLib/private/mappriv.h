@@ -10,6 +10,9 @@
  * The map class is represented using a binary search tree.  The
  * specific implementation used here is the classic AVL algorithm
  * developed by Georgii Adel'son-Vel'skii and Evgenii Landis in 1962.
+ * If copy-on-write sharing is enabled, shareCount points to a counter
+ * of the maps that share the tree, which is updated atomically.  The
+ * tree is never changed while that count is greater than one.
  */
 
 private:
@@ -35,6 +38,7 @@ private:
    BSTNode *root;                  /* Pointer to the root of the tree */
    int nodeCount;                  /* Number of entries in the map    */
    int (*cmpFn)(KeyType, KeyType); /* Function used to compare keys   */
+   int *shareCount;                /* Maps sharing the tree, or NULL  */
 
 /* Private method prototypes */
 
@@ -48,14 +52,24 @@ private:
    void fixRightImbalance(BSTNode * & t);
    void rotateRight(BSTNode * & t);
    void deleteTree(BSTNode *t);
+   int flattenTree(BSTNode *t, BSTNode **array, int k);
+   BSTNode *buildTree(BSTNode **array, int n, int & h);
+   void detachTree();
+   void releaseTree();
    void mapAll(BSTNode *t, void (*fn)(KeyType));
    template <typename ClientDataType>
    void mapAll(BSTNode *t, void (*fn)(KeyType), ClientDataType & data);
 
    void copyInternalData(const Map & other) {
-      root = copyTree(other.root);
       nodeCount = other.nodeCount;
       cmpFn = other.cmpFn;
+      shareCount = other.shareCount;
+      if (shareCount == NULL) {
+         root = copyTree(other.root);
+      } else {
+         root = other.root;
+         atomicIncrement(shareCount);
+      }
    }
 
    BSTNode *copyTree(BSTNode * const t) {
@@ -85,12 +99,13 @@ public:
  * --------------------
  * This copy constructor and operator= are defined to make a
  * deep copy, making it possible to pass/return maps by value
- * and assign from one map to another.
+ * and assign from one map to another.  A copy-on-write map
+ * shares its tree instead and copies it only when changed.
  */
 
    Map & operator=(const Map & rhs) {
       if (this != &rhs) {
-         clear();
+         releaseTree();
          copyInternalData(rhs);
       }
       return *this;
@@ -112,21 +127,34 @@ public:
 
    private:
 
+/*
+ * Implementation notes: iterator
+ * ------------------------------
+ * The iterator keeps the path of unfinished nodes in a fixed array
+ * rather than a Stack, so that iterating over a map allocates no heap
+ * storage.  The path never holds more than one entry for each level
+ * of the tree, and the height of an AVL tree with fewer than 2^31
+ * nodes is at most 45, so MAX_DEPTH leaves a generous margin.
+ */
+
+      static const int MAX_DEPTH = 64;
+
       struct NodeMarker {
          BSTNode *np;
          bool processed;
       };
 
-      const Map *mp;               /* Pointer to the map         */
-      int index;                   /* Index of current element   */
-      Stack<NodeMarker> stack;     /* Stack of unprocessed nodes */
+      const Map *mp;                   /* Pointer to the map           */
+      int index;                       /* Index of current element     */
+      int depth;                       /* Number of entries in stack   */
+      NodeMarker stack[MAX_DEPTH];     /* Stack of unprocessed nodes   */
 
       void findLeftmostChild() {
-         BSTNode *np = stack.peek().np;
+         BSTNode *np = stack[depth - 1].np;
          if (np == NULL) return;
          while (np->left != NULL) {
             NodeMarker marker = { np->left,  false };
-            stack.push(marker);
+            stack[depth++] = marker;
             np = np->left;
          }
       }
@@ -134,17 +162,18 @@ public:
    public:
 
       iterator() {
-        /* Empty */
+         depth = 0;
       }
 
       iterator(const Map *mp, bool end) {
          this->mp = mp;
+         depth = 0;
          if (end || mp->nodeCount == 0) {
             index = mp->nodeCount;
          } else {
             index = 0;
             NodeMarker marker = { mp->root, false };
-            stack.push(marker);
+            stack[depth++] = marker;
             findLeftmostChild();
          }
       }
@@ -152,22 +181,35 @@ public:
       iterator(const iterator & it) {
          mp = it.mp;
          index = it.index;
-         stack = it.stack;
+         depth = it.depth;
+         for (int i = 0; i < depth; i++) {
+            stack[i] = it.stack[i];
+         }
+      }
+
+      iterator & operator=(const iterator & it) {
+         mp = it.mp;
+         index = it.index;
+         depth = it.depth;
+         for (int i = 0; i < depth; i++) {
+            stack[i] = it.stack[i];
+         }
+         return *this;
       }
 
       iterator & operator++() {
-         NodeMarker marker = stack.pop();
+         NodeMarker marker = stack[--depth];
          BSTNode *np = marker.np;
          if (np->right == NULL) {
-            while (!stack.isEmpty() && stack.peek().processed) {
-               stack.pop();
+            while (depth > 0 && stack[depth - 1].processed) {
+               depth--;
             }
          } else {
             marker.processed = true;
-            stack.push(marker);
+            stack[depth++] = marker;
             marker.np = np->right;
             marker.processed = false;
-            stack.push(marker);
+            stack[depth++] = marker;
             findLeftmostChild();
          }
          index++;
@@ -189,7 +231,7 @@ public:
       }
 
       KeyType operator*() {
-         return stack.peek().np->key;
+         return stack[depth - 1].np->key;
       }
 
       friend class Map;
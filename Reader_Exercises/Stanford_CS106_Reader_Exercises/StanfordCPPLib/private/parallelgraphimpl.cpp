@@ -0,0 +1,484 @@
+/*
+ * File: parallelgraphimpl.cpp
+ * ---------------------------
+ * This file contains the implementation of the parallelgraph.h
+ * interface.  Because of the way C++ compiles templates, this code
+ * must be available to the compiler when it reads the header file.
+ */
+
+#ifdef _parallelgraph_h
+
+template <typename NodeType,typename ArcType>
+ParallelGraphSearch<NodeType,ArcType>::ParallelGraphSearch(
+                                          Graph<NodeType,ArcType> & g)
+                                          : fg(g) {
+   init();
+}
+
+template <typename NodeType,typename ArcType>
+ParallelGraphSearch<NodeType,ArcType>::ParallelGraphSearch(
+                                 const FrozenGraph<NodeType,ArcType> & src)
+                                 : fg(src) {
+   init();
+}
+
+template <typename NodeType,typename ArcType>
+ParallelGraphSearch<NodeType,ArcType>::~ParallelGraphSearch() {
+   delete[] level;
+   delete[] frontier;
+   delete[] nextFrontier;
+   delete[] visited;
+   delete[] frontierBits;
+   delete[] nextBits;
+   delete[] parent;
+   delete[] component;
+}
+
+template <typename NodeType,typename ArcType>
+void ParallelGraphSearch<NodeType,ArcType>::breadthFirstSearch(
+                                                   NodeType *start) {
+   breadthFirstSearch(start, getDefaultThreadPool());
+}
+
+/*
+ * Implementation notes: breadthFirstSearch
+ * ----------------------------------------
+ * Each pass through the loop finds the nodes at distance d + 1 from
+ * the nodes at distance d.  A top-down step follows every arc that
+ * leaves the frontier, so its cost is the number of those arcs, which
+ * is kept in frontierArcs.  A bottom-up step looks at the incoming
+ * arcs of each unvisited node and stops at the first one that starts
+ * in the frontier, so once the frontier is large it usually examines
+ * only a few arcs per node.  Following Beamer, Asanovic, and
+ * Patterson, the search switches to bottom-up when the arcs leaving
+ * the frontier exceed 1/ALPHA of the arcs leaving unvisited nodes, and
+ * back to top-down when the frontier is shrinking and holds fewer than
+ * 1/BETA of the nodes.  The switch changes only the amount of work:
+ * every node still gets the distance of the first level at which some
+ * arc reaches it.
+ */
+
+template <typename NodeType,typename ArcType>
+void ParallelGraphSearch<NodeType,ArcType>::breadthFirstSearch(
+                                                   NodeType *start,
+                                                   ThreadPool & pool) {
+   int s = getNodeId(start, "breadthFirstSearch");
+   const int *offsets = fg.getOutOffsets();
+   for (int v = 0; v < nNodes; v++) {
+      level[v] = -1;
+   }
+   for (int i = 0; i < nWords; i++) {
+      visited[i] = 0;
+   }
+   level[s] = 0;
+   setBit(visited, s);
+   frontier[0] = s;
+   int frontierSize = 1;
+   long frontierArcs = offsets[s + 1] - offsets[s];
+   long unvisitedArcs = fg.getArcCount() - frontierArcs;
+   int previousSize = 0;
+   bool bottomUp = false;
+   int d = 0;
+   while (frontierSize > 0) {
+      StepTask task;
+      task.search = this;
+      task.level = d;
+      if (!bottomUp && frontierArcs > unvisitedArcs / ALPHA) {
+         for (int i = 0; i < nWords; i++) {
+            frontierBits[i] = 0;
+         }
+         task.type = LIST_TO_BITS;
+         task.n = frontierSize;
+         runStep(task, pool, true);
+         bottomUp = true;
+      } else if (bottomUp && frontierSize < previousSize
+                          && frontierSize < nNodes / BETA) {
+         task.type = BITS_TO_LIST;
+         task.n = nNodes;
+         task.listOut = frontier;
+         runStep(task, pool, true);
+         bottomUp = false;
+      }
+      if (bottomUp) {
+         for (int i = 0; i < nWords; i++) {
+            nextBits[i] = 0;
+         }
+         task.type = BOTTOM_UP;
+         task.n = nNodes;
+         runStep(task, pool, true);
+         uint64_t *tmp = frontierBits;
+         frontierBits = nextBits;
+         nextBits = tmp;
+      } else {
+         task.type = TOP_DOWN;
+         task.n = frontierSize;
+         task.listOut = nextFrontier;
+         runStep(task, pool, frontierArcs >= SERIAL_CUTOFF);
+         int *tmp = frontier;
+         frontier = nextFrontier;
+         nextFrontier = tmp;
+      }
+      previousSize = frontierSize;
+      frontierSize = task.found;
+      frontierArcs = task.foundArcs;
+      unvisitedArcs -= frontierArcs;
+      d++;
+   }
+}
+
+template <typename NodeType,typename ArcType>
+bool ParallelGraphSearch<NodeType,ArcType>::isReachable(NodeType *node) {
+   return level[getNodeId(node, "isReachable")] >= 0;
+}
+
+template <typename NodeType,typename ArcType>
+int ParallelGraphSearch<NodeType,ArcType>::getDistance(NodeType *node) {
+   return level[getNodeId(node, "getDistance")];
+}
+
+template <typename NodeType,typename ArcType>
+int ParallelGraphSearch<NodeType,ArcType>::findComponents() {
+   return findComponents(getDefaultThreadPool());
+}
+
+/*
+ * Implementation notes: findComponents
+ * ------------------------------------
+ * Each arc joins the trees that contain its two ends by making the
+ * larger root a child of the smaller one.  A thread makes the link with
+ * a compare-and-swap, which fails if another thread has changed that
+ * root in the meantime, in which case the thread finds the new roots
+ * and tries again.  Because every link points to a smaller id, the
+ * root of each tree is the smallest id in its component, whatever
+ * order the links were made in.  After every node has been pointed
+ * directly at its root, a serial pass numbers the roots in order of
+ * id, and a final parallel pass copies each root's number to the rest
+ * of its component.
+ */
+
+template <typename NodeType,typename ArcType>
+int ParallelGraphSearch<NodeType,ArcType>::findComponents(
+                                                   ThreadPool & pool) {
+   if (component == NULL) component = new int[nNodes];
+   for (int v = 0; v < nNodes; v++) {
+      parent[v] = v;
+   }
+   StepTask task;
+   task.search = this;
+   task.n = nNodes;
+   task.type = UNION_ARCS;
+   runStep(task, pool, true);
+   task.type = FIND_ROOTS;
+   runStep(task, pool, true);
+   int nComponents = 0;
+   for (int v = 0; v < nNodes; v++) {
+      if (parent[v] == v) component[v] = nComponents++;
+   }
+   task.type = LABEL_NODES;
+   runStep(task, pool, true);
+   return nComponents;
+}
+
+template <typename NodeType,typename ArcType>
+int ParallelGraphSearch<NodeType,ArcType>::getComponent(NodeType *node) {
+   int v = getNodeId(node, "getComponent");
+   if (component == NULL) {
+      error("getComponent: findComponents has not been called");
+   }
+   return component[v];
+}
+
+template <typename NodeType,typename ArcType>
+const int *ParallelGraphSearch<NodeType,ArcType>::getDistances() const {
+   return level;
+}
+
+template <typename NodeType,typename ArcType>
+const int *ParallelGraphSearch<NodeType,ArcType>::getComponents() const {
+   return component;
+}
+
+template <typename NodeType,typename ArcType>
+const FrozenGraph<NodeType,ArcType> &
+ParallelGraphSearch<NodeType,ArcType>::getSnapshot() const {
+   return fg;
+}
+
+template <typename NodeType,typename ArcType>
+void ParallelGraphSearch<NodeType,ArcType>::init() {
+   nNodes = fg.size();
+   nWords = (nNodes + 63) / 64;
+   level = new int[nNodes];
+   frontier = new int[nNodes];
+   nextFrontier = new int[nNodes];
+   visited = new uint64_t[nWords];
+   frontierBits = new uint64_t[nWords];
+   nextBits = new uint64_t[nWords];
+   parent = new int[nNodes];
+   component = NULL;
+   for (int v = 0; v < nNodes; v++) {
+      level[v] = -1;
+   }
+}
+
+template <typename NodeType,typename ArcType>
+int ParallelGraphSearch<NodeType,ArcType>::getNodeId(NodeType *node,
+                                                     std::string caller) {
+   if (!fg.containsNode(node)) error(caller + ": Node is not in the graph");
+   return fg.getId(node);
+}
+
+/*
+ * Implementation notes: runStep
+ * -----------------------------
+ * A step with little work runs on the calling thread alone, because
+ * waking the pool would take longer than the step itself.  This
+ * matters for graphs with long paths, in which most levels of a
+ * breadth-first search hold only a few nodes.
+ */
+
+template <typename NodeType,typename ArcType>
+void ParallelGraphSearch<NodeType,ArcType>::runStep(StepTask & task,
+                                                    ThreadPool & pool,
+                                                    bool parallel) {
+   task.nextChunk = 0;
+   task.found = 0;
+   task.foundArcs = 0;
+   if (parallel && pool.getThreadCount() > 1) {
+      pool.runParallel(runStepChunks, task);
+   } else {
+      runStepChunks(task, 0);
+   }
+}
+
+template <typename NodeType,typename ArcType>
+void ParallelGraphSearch<NodeType,ArcType>::runStepChunks(StepTask & task,
+                                                          int) {
+   ParallelGraphSearch *search = task.search;
+   int buffer[BUFFER_SIZE];
+   int count = 0;
+   while (true) {
+      int lh = atomicFetchAndAdd(&task.nextChunk, CHUNK_SIZE);
+      if (lh >= task.n) break;
+      int rh = (lh > task.n - CHUNK_SIZE) ? task.n : lh + CHUNK_SIZE;
+      switch (task.type) {
+       case TOP_DOWN:
+         search->topDownStep(task, lh, rh, buffer, count);
+         break;
+       case BOTTOM_UP:
+         search->bottomUpStep(task, lh, rh);
+         break;
+       case LIST_TO_BITS:
+         search->listToBitsStep(task, lh, rh);
+         break;
+       case BITS_TO_LIST:
+         search->bitsToListStep(task, lh, rh, buffer, count);
+         break;
+       case UNION_ARCS:
+         search->unionArcsStep(lh, rh);
+         break;
+       case FIND_ROOTS:
+         search->findRootsStep(lh, rh);
+         break;
+       case LABEL_NODES:
+         search->labelNodesStep(lh, rh);
+         break;
+      }
+   }
+   flushBuffer(task, buffer, count);
+}
+
+/*
+ * Implementation notes: topDownStep
+ * ---------------------------------
+ * Nodes found by this thread collect in a small buffer and are copied
+ * to the output list in a block whose position comes from one atomic
+ * addition, which keeps the threads from contending for every node.
+ */
+
+template <typename NodeType,typename ArcType>
+void ParallelGraphSearch<NodeType,ArcType>::topDownStep(StepTask & task,
+                                                        int lh, int rh,
+                                                        int *buffer,
+                                                        int & count) {
+   const int *offsets = fg.getOutOffsets();
+   const int *targets = fg.getOutTargets();
+   int next = task.level + 1;
+   long arcs = 0;
+   for (int i = lh; i < rh; i++) {
+      int v = frontier[i];
+      for (int j = offsets[v]; j < offsets[v + 1]; j++) {
+         int w = targets[j];
+         if (claimNode(visited, w)) {
+            level[w] = next;
+            arcs += offsets[w + 1] - offsets[w];
+            if (count == BUFFER_SIZE) flushBuffer(task, buffer, count);
+            buffer[count++] = w;
+         }
+      }
+   }
+   atomicFetchAndAdd(&task.foundArcs, arcs);
+}
+
+/*
+ * Implementation notes: bottomUpStep
+ * ----------------------------------
+ * The block of nodes covers whole words of the visited and nextBits
+ * bitmaps, so no other thread writes those words during the step and
+ * the bits can be set without atomic operations.
+ */
+
+template <typename NodeType,typename ArcType>
+void ParallelGraphSearch<NodeType,ArcType>::bottomUpStep(StepTask & task,
+                                                         int lh, int rh) {
+   const int *offsets = fg.getOutOffsets();
+   const int *inOffsets = fg.getInOffsets();
+   const int *inSources = fg.getInSources();
+   int next = task.level + 1;
+   int found = 0;
+   long arcs = 0;
+   for (int v = lh; v < rh; v++) {
+      if (testBit(visited, v)) continue;
+      for (int j = inOffsets[v]; j < inOffsets[v + 1]; j++) {
+         if (testBit(frontierBits, inSources[j])) {
+            level[v] = next;
+            setBit(visited, v);
+            setBit(nextBits, v);
+            found++;
+            arcs += offsets[v + 1] - offsets[v];
+            break;
+         }
+      }
+   }
+   atomicFetchAndAdd(&task.found, found);
+   atomicFetchAndAdd(&task.foundArcs, arcs);
+}
+
+template <typename NodeType,typename ArcType>
+void ParallelGraphSearch<NodeType,ArcType>::listToBitsStep(StepTask &,
+                                                           int lh, int rh) {
+   for (int i = lh; i < rh; i++) {
+      int v = frontier[i];
+      atomicFetchAndOr(&frontierBits[v >> 6], uint64_t(1) << (v & 63));
+   }
+}
+
+template <typename NodeType,typename ArcType>
+void ParallelGraphSearch<NodeType,ArcType>::bitsToListStep(StepTask & task,
+                                                           int lh, int rh,
+                                                           int *buffer,
+                                                           int & count) {
+   for (int v = lh; v < rh; v++) {
+      if (testBit(frontierBits, v)) {
+         if (count == BUFFER_SIZE) flushBuffer(task, buffer, count);
+         buffer[count++] = v;
+      }
+   }
+}
+
+template <typename NodeType,typename ArcType>
+void ParallelGraphSearch<NodeType,ArcType>::unionArcsStep(int lh, int rh) {
+   const int *offsets = fg.getOutOffsets();
+   const int *targets = fg.getOutTargets();
+   for (int v = lh; v < rh; v++) {
+      for (int j = offsets[v]; j < offsets[v + 1]; j++) {
+         unite(v, targets[j]);
+      }
+   }
+}
+
+template <typename NodeType,typename ArcType>
+void ParallelGraphSearch<NodeType,ArcType>::findRootsStep(int lh, int rh) {
+   for (int v = lh; v < rh; v++) {
+      atomicStore(&parent[v], findRoot(v));
+   }
+}
+
+template <typename NodeType,typename ArcType>
+void ParallelGraphSearch<NodeType,ArcType>::labelNodesStep(int lh, int rh) {
+   for (int v = lh; v < rh; v++) {
+      if (parent[v] != v) component[v] = component[parent[v]];
+   }
+}
+
+template <typename NodeType,typename ArcType>
+void ParallelGraphSearch<NodeType,ArcType>::flushBuffer(StepTask & task,
+                                                        int *buffer,
+                                                        int & count) {
+   if (count == 0) return;
+   int pos = atomicFetchAndAdd(&task.found, count);
+   for (int i = 0; i < count; i++) {
+      task.listOut[pos + i] = buffer[i];
+   }
+   count = 0;
+}
+
+/*
+ * Implementation notes: claimNode
+ * -------------------------------
+ * The relaxed read skips the atomic operation for nodes that were
+ * visited in an earlier step, which are most of the targets in a dense
+ * graph.  If two threads read a clear bit at the same time, the atomic
+ * OR decides between them, since only one of them can see the bit
+ * clear in the value it returns.
+ */
+
+template <typename NodeType,typename ArcType>
+bool ParallelGraphSearch<NodeType,ArcType>::claimNode(uint64_t *bits,
+                                                      int v) {
+   uint64_t mask = uint64_t(1) << (v & 63);
+   if (atomicLoad(&bits[v >> 6]) & mask) return false;
+   return (atomicFetchAndOr(&bits[v >> 6], mask) & mask) == 0;
+}
+
+template <typename NodeType,typename ArcType>
+bool ParallelGraphSearch<NodeType,ArcType>::testBit(const uint64_t *bits,
+                                                    int v) {
+   return (bits[v >> 6] >> (v & 63)) & 1;
+}
+
+template <typename NodeType,typename ArcType>
+void ParallelGraphSearch<NodeType,ArcType>::setBit(uint64_t *bits, int v) {
+   bits[v >> 6] |= uint64_t(1) << (v & 63);
+}
+
+/*
+ * Implementation notes: findRoot
+ * ------------------------------
+ * This method shortens the path as it goes by pointing each node it
+ * passes at its grandparent.  The update is a compare-and-swap so that
+ * it is lost, rather than undoing another thread's work, if the parent
+ * has changed since it was read.  Every parent is an ancestor, so a
+ * lost update leaves the forest correct.  Other threads change parent
+ * while this method runs, so every read and write of parent in the
+ * parallel steps is atomic; relaxed ordering is enough, because the
+ * compare-and-swap is the only operation whose result matters.
+ */
+
+template <typename NodeType,typename ArcType>
+int ParallelGraphSearch<NodeType,ArcType>::findRoot(int v) {
+   while (true) {
+      int p = atomicLoad(&parent[v]);
+      if (p == v) return v;
+      int gp = atomicLoad(&parent[p]);
+      if (gp != p) atomicCompareAndSwap(&parent[v], p, gp);
+      v = gp;
+   }
+}
+
+template <typename NodeType,typename ArcType>
+void ParallelGraphSearch<NodeType,ArcType>::unite(int u, int v) {
+   while (true) {
+      u = findRoot(u);
+      v = findRoot(v);
+      if (u == v) return;
+      if (u < v) {
+         int tmp = u;
+         u = v;
+         v = tmp;
+      }
+      if (atomicCompareAndSwap(&parent[u], u, v)) return;
+   }
+}
+
+#endif
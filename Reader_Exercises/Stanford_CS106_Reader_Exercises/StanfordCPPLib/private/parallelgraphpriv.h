@@ -0,0 +1,101 @@
+/*
+ * File: parallelgraphpriv.h
+ * -------------------------
+ * This file contains the private section of the parallelgraph.h
+ * interface.
+ */
+
+/*
+ * Implementation notes: ParallelGraphSearch data structure
+ * --------------------------------------------------------
+ * The breadth-first search keeps the nodes at the current distance,
+ * called the frontier, either as a list of ids or as a bitmap with one
+ * bit per node, depending on the direction in which it is working.
+ * The visited bitmap records every node that has been reached, and
+ * threads that follow arcs forward claim a node by setting its bit with
+ * an atomic operation, so exactly one thread records each node.  The
+ * component search uses a union-find forest in the parent array.
+ *
+ * Each parallel step is described by a StepTask.  The threads take
+ * blocks of CHUNK_SIZE items at a time from a shared counter, so a
+ * thread that gets nodes with few arcs takes more blocks.  Because
+ * CHUNK_SIZE is a multiple of 64, each word of a bitmap indexed by the
+ * items belongs to exactly one block.
+ */
+
+private:
+
+/* Constants */
+
+   static const int CHUNK_SIZE = 1024;     /* Items in each block          */
+   static const int BUFFER_SIZE = 256;     /* Ids a thread holds back      */
+   static const int SERIAL_CUTOFF = 4096;  /* Arcs worth a parallel step   */
+   static const int ALPHA = 14;            /* Tuning for the switch to     */
+   static const int BETA = 24;             /*   and from bottom-up search  */
+
+/* Type used to identify the kind of step */
+
+   enum StepType {
+      TOP_DOWN, BOTTOM_UP, LIST_TO_BITS, BITS_TO_LIST,
+      UNION_ARCS, FIND_ROOTS, LABEL_NODES
+   };
+
+/* Type used to describe a parallel step to the threads */
+
+   struct StepTask {
+      ParallelGraphSearch *search;   /* The search object                */
+      StepType type;                 /* The kind of step                 */
+      int n;                         /* The number of items to process   */
+      int level;                     /* The distance of the frontier     */
+      int *listOut;                  /* Where new list entries go        */
+      int nextChunk;                 /* The first unclaimed item         */
+      int found;                     /* The nodes added to the output    */
+      long foundArcs;                /* The arcs leaving those nodes     */
+   };
+
+/* Instance variables */
+
+   FrozenGraph<NodeType,ArcType> fg;   /* The snapshot being searched    */
+   int nNodes;                         /* The number of nodes            */
+   int nWords;                         /* The number of words per bitmap */
+   int *level;                         /* The distance to each node      */
+   int *frontier;                      /* The current frontier as a list */
+   int *nextFrontier;                  /* The next frontier as a list    */
+   uint64_t *visited;                  /* Nodes that have been reached   */
+   uint64_t *frontierBits;             /* The current frontier as bits   */
+   uint64_t *nextBits;                 /* The next frontier as bits      */
+   int *parent;                        /* The union-find forest          */
+   int *component;                     /* Component numbers, or NULL     */
+
+/* Private method prototypes */
+
+   void init();
+   int getNodeId(NodeType *node, std::string caller);
+   void runStep(StepTask & task, ThreadPool & pool, bool parallel);
+   static void runStepChunks(StepTask & task, int index);
+   void topDownStep(StepTask & task, int lh, int rh, int *buffer,
+                    int & count);
+   void bottomUpStep(StepTask & task, int lh, int rh);
+   void listToBitsStep(StepTask & task, int lh, int rh);
+   void bitsToListStep(StepTask & task, int lh, int rh, int *buffer,
+                       int & count);
+   void unionArcsStep(int lh, int rh);
+   void findRootsStep(int lh, int rh);
+   void labelNodesStep(int lh, int rh);
+   static void flushBuffer(StepTask & task, int *buffer, int & count);
+   static bool claimNode(uint64_t *bits, int v);
+   static bool testBit(const uint64_t *bits, int v);
+   static void setBit(uint64_t *bits, int v);
+   int findRoot(int v);
+   void unite(int u, int v);
+
+/*
+ * Hidden features
+ * ---------------
+ * A search object owns large arrays that are rarely worth copying, so
+ * the copy constructor and assignment operator are declared private
+ * and are never defined.
+ */
+
+   ParallelGraphSearch(const ParallelGraphSearch & src);
+   ParallelGraphSearch & operator=(const ParallelGraphSearch & src);
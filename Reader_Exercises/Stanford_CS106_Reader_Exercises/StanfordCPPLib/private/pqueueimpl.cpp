@@ -8,51 +8,126 @@
 
 #ifdef _pqueue_h
 
-template <typename ValueType>
-PriorityQueue<ValueType>::PriorityQueue() {
-   clear();
-}
-
 /*
- * Implementation notes: ~PriorityQueue destructor
+ * Implementation notes: PriorityQueue constructor
  * -----------------------------------------------
- * All of the dynamic memory is allocated in the Vector class,
- * so no work is required at this level.
+ * The constructor sets the array pointers to NULL so that clear can
+ * free them unconditionally before allocating the initial storage.
  */
 
-template <typename ValueType>
-PriorityQueue<ValueType>::~PriorityQueue() {
-   /* Empty */
+template <typename ValueType,typename PriorityType,typename Compare>
+PriorityQueue<ValueType,PriorityType,Compare>::PriorityQueue() {
+   heap = NULL;
+   values = NULL;
+   positions = NULL;
+   freeSlots = NULL;
+   enqueueCount = 0;
+   clear();
+}
+
+template <typename ValueType,typename PriorityType,typename Compare>
+template <typename IteratorType>
+PriorityQueue<ValueType,PriorityType,Compare>::PriorityQueue(IteratorType begin,
+        IteratorType end) {
+   heap = NULL;
+   values = NULL;
+   positions = NULL;
+   freeSlots = NULL;
+   enqueueCount = 0;
+   clear();
+   enqueueAll(begin, end);
+}
+
+template <typename ValueType,typename PriorityType,typename Compare>
+PriorityQueue<ValueType,PriorityType,Compare>::~PriorityQueue() {
+   deleteInternalData();
 }
 
-template <typename ValueType>
-int PriorityQueue<ValueType>::size() const {
+template <typename ValueType,typename PriorityType,typename Compare>
+int PriorityQueue<ValueType,PriorityType,Compare>::size() const {
    return count;
 }
 
-template <typename ValueType>
-bool PriorityQueue<ValueType>::isEmpty() const {
+template <typename ValueType,typename PriorityType,typename Compare>
+bool PriorityQueue<ValueType,PriorityType,Compare>::isEmpty() const {
    return count == 0;
 }
 
-template <typename ValueType>
-void PriorityQueue<ValueType>::clear() {
-   heap.clear();
+template <typename ValueType,typename PriorityType,typename Compare>
+void PriorityQueue<ValueType,PriorityType,Compare>::clear() {
+   deleteInternalData();
+   capacity = INITIAL_CAPACITY;
+   heap = new HeapEntry[capacity];
+   values = new ValueType[capacity];
+   positions = new int[capacity];
+   freeSlots = new int[capacity];
+   for (int i = 0; i < capacity; i++) {
+      positions[i] = -1;
+      freeSlots[i] = capacity - 1 - i;
+   }
+   nFree = capacity;
    count = 0;
 }
 
-template <typename ValueType>
-void PriorityQueue<ValueType>::enqueue(ValueType value, double priority) {
-   if (count == heap.size()) heap.add(HeapEntry());
-   int index = count++;
-   heap[index].value = value;
-   heap[index].priority = priority;
-   heap[index].sequence = enqueueCount++;
-   while (index > 0) {
-      int parent = (index - 1) / 2;
-      if (takesPriority(parent, index)) break;
-      swapHeapEntries(parent, index);
-      index = parent;
+/*
+ * Implementation notes: enqueue
+ * -----------------------------
+ * The new value is copied into a free slot, and its heap entry is
+ * sifted up from the end of the heap.  Rather than swapping entries
+ * at each level, siftUp moves parents down into the hole and stores
+ * the new entry once when its position is known.
+ */
+
+template <typename ValueType,typename PriorityType,typename Compare>
+typename PriorityQueue<ValueType,PriorityType,Compare>::Handle
+PriorityQueue<ValueType,PriorityType,Compare>::enqueue(ValueType value,
+        const PriorityType & priority) {
+   if (count == capacity) expandCapacity(count + 1);
+   HeapEntry entry;
+   entry.priority = priority;
+   entry.sequence = enqueueCount++;
+   entry.slot = freeSlots[--nFree];
+   values[entry.slot] = value;
+   siftUp(count++, entry);
+   Handle handle;
+   handle.slot = entry.slot;
+   handle.sequence = entry.sequence;
+   return handle;
+}
+
+/*
+ * Implementation notes: enqueueAll
+ * --------------------------------
+ * The new entries are first appended to the end of the heap array.  If
+ * the batch is small compared to the existing heap, each new entry is
+ * then sifted up, which costs O(log N) apiece.  Otherwise the whole
+ * array is reordered by heapify, which takes time proportional to its
+ * length.
+ */
+
+template <typename ValueType,typename PriorityType,typename Compare>
+template <typename IteratorType>
+void
+PriorityQueue<ValueType,PriorityType,Compare>::enqueueAll(IteratorType begin,
+        IteratorType end) {
+   int n = (int) std::distance(begin, end);
+   if (n <= 0) return;
+   if (count + n > capacity) expandCapacity(count + n);
+   int oldCount = count;
+   for (IteratorType it = begin; it != end; ++it) {
+      HeapEntry entry;
+      entry.priority = (*it).second;
+      entry.sequence = enqueueCount++;
+      entry.slot = freeSlots[--nFree];
+      values[entry.slot] = (*it).first;
+      placeEntry(count++, entry);
+   }
+   if (n * HEAP_ARITY >= oldCount) {
+      heapify();
+   } else {
+      for (int i = oldCount; i < count; i++) {
+         siftUp(i, heap[i]);
+      }
    }
 }
 
@@ -60,46 +135,201 @@ void PriorityQueue<ValueType>::enqueue(ValueType value, double priority) {
  * Implementation notes: dequeue, peek
  * -----------------------------------
  * These methods must check for an empty queue and report an error
- * if there is no first element.
+ * if there is no first element.  After the value at the root is
+ * removed, the last heap entry is sifted down from the root.  The
+ * freed slot is reset so that it does not hold on to the value.
  */
 
-template <typename ValueType>
-ValueType PriorityQueue<ValueType>::dequeue() {
+template <typename ValueType,typename PriorityType,typename Compare>
+ValueType PriorityQueue<ValueType,PriorityType,Compare>::dequeue() {
    if (count == 0) error("dequeue: Attempting to dequeue an empty queue");
-   ValueType value = heap[0].value;
-   swapHeapEntries(0, --count);
-   int index = 0;
+   int slot = heap[0].slot;
+   positions[slot] = -1;
+   freeSlots[nFree++] = slot;
+   count--;
+   if (count > 0) siftDown(0, heap[count]);
+   return releaseSlot(slot);
+}
+
+template <typename ValueType,typename PriorityType,typename Compare>
+ValueType PriorityQueue<ValueType,PriorityType,Compare>::peek() const {
+   if (count == 0) error("peek: Attempting to peek at an empty queue");
+   return values[heap[0].slot];
+}
+
+/*
+ * Implementation notes: changePriority, remove
+ * --------------------------------------------
+ * Both methods locate the entry through the positions array.  Changing
+ * the priority keeps the original sequence number so that ties are
+ * still broken in enqueue order.  Removing an entry fills its position
+ * with the last entry in the heap, which may then need to move either
+ * up or down, and resets the value in the freed slot.
+ */
+
+template <typename ValueType,typename PriorityType,typename Compare>
+void
+PriorityQueue<ValueType,PriorityType,Compare>::changePriority(Handle handle,
+        const PriorityType & priority) {
+   int index = findHandle(handle, "changePriority");
+   HeapEntry entry = heap[index];
+   entry.priority = priority;
+   restoreHeap(index, entry);
+}
+
+template <typename ValueType,typename PriorityType,typename Compare>
+void PriorityQueue<ValueType,PriorityType,Compare>::remove(Handle handle) {
+   int index = findHandle(handle, "remove");
+   positions[handle.slot] = -1;
+   freeSlots[nFree++] = handle.slot;
+   count--;
+   if (index < count) restoreHeap(index, heap[count]);
+   values[handle.slot] = ValueType();
+}
+
+template <typename ValueType,typename PriorityType,typename Compare>
+bool
+PriorityQueue<ValueType,PriorityType,Compare>::contains(Handle handle) const {
+   if (handle.slot < 0 || handle.slot >= capacity) return false;
+   int index = positions[handle.slot];
+   return index >= 0 && heap[index].sequence == handle.sequence;
+}
+
+template <typename ValueType,typename PriorityType,typename Compare>
+PriorityType
+PriorityQueue<ValueType,PriorityType,Compare>::getPriority(Handle handle) const {
+   return heap[findHandle(handle, "getPriority")].priority;
+}
+
+template <typename ValueType,typename PriorityType,typename Compare>
+int
+PriorityQueue<ValueType,PriorityType,Compare>::findHandle(const Handle & handle,
+        std::string caller) const {
+   if (!contains(handle)) {
+      error(caller + ": Handle does not refer to an entry in the queue");
+   }
+   return positions[handle.slot];
+}
+
+/*
+ * Implementation notes: siftUp, siftDown
+ * --------------------------------------
+ * These methods restore the heap property by moving a hole from index
+ * toward the root or toward the leaves until entry can be stored there.
+ * In a 4-ary heap, the children of index i are at 4i+1 through 4i+4,
+ * and the parent of i is at (i-1)/4.
+ */
+
+template <typename ValueType,typename PriorityType,typename Compare>
+void
+PriorityQueue<ValueType,PriorityType,Compare>::siftUp(int index,
+        HeapEntry entry) {
+   while (index > 0) {
+      int parent = (index - 1) / HEAP_ARITY;
+      if (!takesPriority(entry, heap[parent])) break;
+      placeEntry(index, heap[parent]);
+      index = parent;
+   }
+   placeEntry(index, entry);
+}
+
+template <typename ValueType,typename PriorityType,typename Compare>
+void
+PriorityQueue<ValueType,PriorityType,Compare>::siftDown(int index,
+        HeapEntry entry) {
    while (true) {
-      int left = 2 * index + 1;
-      int right = 2 * index + 2;
-      if (left >= count) break;
-      int child = left;
-      if (right < count && takesPriority(right, left)) child = right;
-      if (takesPriority(index, child)) break;
-      swapHeapEntries(index, child);
-      index = child;
+      int first = HEAP_ARITY * index + 1;
+      if (first >= count) break;
+      int last = first + HEAP_ARITY;
+      if (last > count) last = count;
+      int best = first;
+      for (int child = first + 1; child < last; child++) {
+         if (takesPriority(heap[child], heap[best])) best = child;
+      }
+      if (!takesPriority(heap[best], entry)) break;
+      placeEntry(index, heap[best]);
+      index = best;
    }
-   return value;
+   placeEntry(index, entry);
 }
 
-template <typename ValueType>
-ValueType PriorityQueue<ValueType>::peek() const {
-   if (count == 0) error("peek: Attempting to peek at an empty queue");
-   return heap.get(0).value;
+/*
+ * Private method: heapify
+ * -----------------------
+ * Establishes the heap property over the entire array using Floyd's
+ * bottom-up method, which sifts down each internal node starting with
+ * the last one.  Most nodes lie near the leaves and move only a short
+ * distance, so the total cost is linear in the number of entries.
+ */
+
+template <typename ValueType,typename PriorityType,typename Compare>
+void PriorityQueue<ValueType,PriorityType,Compare>::heapify() {
+   if (count < 2) return;
+   for (int i = (count - 2) / HEAP_ARITY; i >= 0; i--) {
+      siftDown(i, heap[i]);
+   }
 }
 
-template <typename ValueType>
-bool PriorityQueue<ValueType>::takesPriority(int i1, int i2) {
-   if (heap[i1].priority < heap[i2].priority) return true;
-   if (heap[i1].priority > heap[i2].priority) return false;
-   return (heap[i1].sequence < heap[i2].sequence);
+/*
+ * Private method: restoreHeap
+ * ---------------------------
+ * Stores entry at index, moving it toward the root or the leaves as
+ * its priority requires.
+ */
+
+template <typename ValueType,typename PriorityType,typename Compare>
+void
+PriorityQueue<ValueType,PriorityType,Compare>::restoreHeap(int index,
+        HeapEntry entry) {
+   if (index > 0 && takesPriority(entry, heap[(index - 1) / HEAP_ARITY])) {
+      siftUp(index, entry);
+   } else {
+      siftDown(index, entry);
+   }
 }
 
-template <typename ValueType>
-void PriorityQueue<ValueType>::swapHeapEntries(int i1, int i2) {
-   HeapEntry entry = heap[i1];
-   heap[i1] = heap[i2];
-   heap[i2] = entry;
+/*
+ * Implementation notes: expandCapacity
+ * ------------------------------------
+ * This private method doubles the capacity of the arrays until they
+ * can hold at least minCapacity entries.  Any slots that are already
+ * free stay on the free-slot stack, and the new slots are pushed on
+ * top of them.
+ */
+
+template <typename ValueType,typename PriorityType,typename Compare>
+void
+PriorityQueue<ValueType,PriorityType,Compare>::expandCapacity(int minCapacity) {
+   int newCapacity = capacity;
+   while (newCapacity < minCapacity) {
+      newCapacity *= 2;
+   }
+   HeapEntry *newHeap = new HeapEntry[newCapacity];
+   ValueType *newValues = new ValueType[newCapacity];
+   int *newPositions = new int[newCapacity];
+   int *newFreeSlots = new int[newCapacity];
+   for (int i = 0; i < count; i++) {
+      newHeap[i] = heap[i];
+   }
+   for (int i = 0; i < capacity; i++) {
+      newValues[i] = values[i];
+      newPositions[i] = positions[i];
+   }
+   for (int i = capacity; i < newCapacity; i++) {
+      newPositions[i] = -1;
+   }
+   for (int i = 0; i < nFree; i++) {
+      newFreeSlots[i] = freeSlots[i];
+   }
+   for (int i = newCapacity - 1; i >= capacity; i--) {
+      newFreeSlots[nFree++] = i;
+   }
+   deleteInternalData();
+   heap = newHeap;
+   values = newValues;
+   positions = newPositions;
+   freeSlots = newFreeSlots;
+   capacity = newCapacity;
 }
 
 #endif
@@ -8,29 +8,164 @@
  * Implementation notes: PriorityQueue data structure
  * --------------------------------------------------
  * The PriorityQueue class is implemented using a data structure called
- * a heap.
+ * a heap.  This version uses a 4-ary heap, which is shallower than a
+ * binary heap and examines sibling entries that sit next to each other
+ * in memory.  The heap itself contains only the priority, the sequence
+ * number used to break ties, and the index of a slot in a separate
+ * array of values.  Reordering the heap therefore moves small entries
+ * of fixed size; each value is copied into its slot when it is enqueued
+ * and copied out when it is dequeued, but is never moved in between.
+ * Free slots are kept on a stack so that they can be reused.
+ *
+ * To support handles, the positions array records the heap index of
+ * the entry that owns each slot, or -1 if the slot is free.  A handle
+ * stores a slot together with the sequence number of its entry, which
+ * makes it possible to detect a handle whose slot has been reused.
  */
 
 private:
 
+/* Constants */
+
+   static const int INITIAL_CAPACITY = 16;
+   static const int HEAP_ARITY = 4;
+
 /* Type used for each heap entry */
 
    struct HeapEntry {
-      ValueType value;
-      double priority;
+      PriorityType priority;
       long sequence;
+      int slot;
    };
 
 /* Instance variables */
 
-   Vector<HeapEntry> heap;
-   long enqueueCount;
-   int count;
-   int capacity;
+   Compare cmp;              /* Ordering applied to the priorities       */
+   HeapEntry *heap;          /* The heap of priorities and slot indices  */
+   ValueType *values;        /* The values, indexed by slot              */
+   int *positions;           /* Heap index of each slot, or -1 if free   */
+   int *freeSlots;           /* Stack of unused slot indices             */
+   int nFree;                /* Number of entries on the freeSlots stack */
+   long enqueueCount;        /* Sequence number for the next enqueue     */
+   int count;                /* Number of entries in the heap            */
+   int capacity;             /* Allocated size of each array             */
 
 /* Private function prototypes */
 
-   void enqueueHeap(ValueType & value, double priority);
-   ValueType dequeueHeap();
-   bool takesPriority(int i1, int i2);
-   void swapHeapEntries(int i1, int i2);
+   void expandCapacity(int minCapacity);
+   void heapify();
+   void siftUp(int index, HeapEntry entry);
+   void siftDown(int index, HeapEntry entry);
+   void restoreHeap(int index, HeapEntry entry);
+   int findHandle(const Handle & handle, std::string caller) const;
+
+/*
+ * Private method: placeEntry
+ * Usage: placeEntry(index, entry);
+ * --------------------------------
+ * Stores entry at the specified heap index and records that position
+ * for the entry's slot.
+ */
+
+   void placeEntry(int index, const HeapEntry & entry) {
+      heap[index] = entry;
+      positions[entry.slot] = index;
+   }
+
+/*
+ * Private method: takesPriority
+ * Usage: if (takesPriority(e1, e2)) . . .
+ * ---------------------------------------
+ * Returns true if entry e1 should be dequeued before entry e2.  Entries
+ * with equal priority are ordered by their sequence numbers, which
+ * preserves the first-in/first-out order among them.  Because the
+ * comparison object is a template parameter, the calls to cmp are
+ * resolved at compile time and are normally expanded inline.
+ */
+
+   bool takesPriority(const HeapEntry & e1, const HeapEntry & e2) const {
+      if (cmp(e1.priority, e2.priority)) return true;
+      if (cmp(e2.priority, e1.priority)) return false;
+      return e1.sequence < e2.sequence;
+   }
+
+/*
+ * Private method: releaseSlot
+ * Usage: ValueType value = releaseSlot(slot);
+ * -------------------------------------------
+ * Returns the value in the specified slot and resets the slot to the
+ * default value, so that a free slot does not keep the storage of a
+ * large value alive until it is reused.  When the compiler supports
+ * move semantics, the value is moved out of the slot rather than
+ * copied.
+ */
+
+   ValueType releaseSlot(int slot) {
+#if __cplusplus >= 201103L
+      ValueType value = std::move(values[slot]);
+#else
+      ValueType value = values[slot];
+#endif
+      values[slot] = ValueType();
+      return value;
+   }
+
+/*
+ * Hidden features
+ * ---------------
+ * The remainder of this file consists of the code required to
+ * support deep copying.  Including these methods in the public
+ * interface would make that interface more difficult to understand
+ * for the average client.
+ */
+
+/*
+ * Deep copying support
+ * --------------------
+ * This copy constructor and operator= are defined to make a
+ * deep copy, making it possible to pass/return priority queues
+ * by value and assign from one priority queue to another.
+ */
+
+   void copyInternalData(const PriorityQueue & pq) {
+      cmp = pq.cmp;
+      capacity = pq.capacity;
+      count = pq.count;
+      nFree = pq.nFree;
+      enqueueCount = pq.enqueueCount;
+      heap = new HeapEntry[capacity];
+      values = new ValueType[capacity];
+      positions = new int[capacity];
+      freeSlots = new int[capacity];
+      for (int i = 0; i < count; i++) {
+         heap[i] = pq.heap[i];
+         values[heap[i].slot] = pq.values[heap[i].slot];
+      }
+      for (int i = 0; i < capacity; i++) {
+         positions[i] = pq.positions[i];
+      }
+      for (int i = 0; i < nFree; i++) {
+         freeSlots[i] = pq.freeSlots[i];
+      }
+   }
+
+   void deleteInternalData() {
+      delete[] heap;
+      delete[] values;
+      delete[] positions;
+      delete[] freeSlots;
+   }
+
+public:
+
+   PriorityQueue & operator=(const PriorityQueue & rhs) {
+      if (this != &rhs) {
+         deleteInternalData();
+         copyInternalData(rhs);
+      }
+      return *this;
+   }
+
+   PriorityQueue(const PriorityQueue & rhs) {
+      copyInternalData(rhs);
+   }
@@ -12,22 +12,24 @@
  * Implementation notes: Queue data structure
  * ------------------------------------------
  * The array-based queue stores the elements in successive index
- * positions in a vector, just as a stack does.  What makes the
+ * positions in an array, just as a stack does.  What makes the
  * queue structure more complex is the need to avoid shifting
  * elements as the queue expands and contracts.  In the array
  * model, this goal is achieved by keeping track of both the
  * head and tail indices.  The tail index increases by one each
  * time an element is enqueued, and the head index increases by
  * one each time an element is dequeued.  Each index therefore
- * marches toward the end of the allocated vector and will
+ * marches toward the end of the allocated array and will
  * eventually reach the end.  Rather than allocate new memory,
  * this implementation lets each index wrap around back to the
  * beginning as if the ends of the array of elements were joined
  * to form a circle.  This representation is called a ring buffer.
+ *
+ * Because the count is stored separately, the queue can use every
+ * slot in the buffer; head and tail are equal both when the queue
+ * is empty and when it is full.
  */
 
-const int INITIAL_CAPACITY = 10;
-
 /*
  * Implementation notes: Queue constructor
  * ---------------------------------------
@@ -37,19 +39,19 @@ const int INITIAL_CAPACITY = 10;
 
 template <typename ValueType>
 Queue<ValueType>::Queue() {
+   elements = NULL;
    clear();
 }
 
 /*
  * Implementation notes: ~Queue destructor
  * ---------------------------------------
- * All of the dynamic memory is allocated in the Vector class,
- * so no work is required at this level.
+ * The destructor frees the ring buffer.
  */
 
 template <typename ValueType>
 Queue<ValueType>::~Queue() {
-   /* Empty */
+   delete[] elements;
 }
 
 template <typename ValueType>
@@ -64,8 +66,10 @@ bool Queue<ValueType>::isEmpty() const {
 
 template <typename ValueType>
 void Queue<ValueType>::clear() {
+   delete[] elements;
    capacity = INITIAL_CAPACITY;
-   ringBuffer = Vector<ValueType>(capacity);
+   mask = capacity - 1;
+   elements = new ValueType[capacity];
    head = 0;
    tail = 0;
    count = 0;
@@ -73,64 +77,111 @@ void Queue<ValueType>::clear() {
 
 template <typename ValueType>
 void Queue<ValueType>::enqueue(ValueType value) {
-   if (count >= capacity - 1) expandRingBufferCapacity();
-   ringBuffer[tail] = value;
-   tail = (tail + 1) % capacity;
+   if (count == capacity) expandRingBufferCapacity(count + 1);
+   elements[tail] = value;
+   tail = (tail + 1) & mask;
    count++;
 }
 
+/*
+ * Implementation notes: enqueueAll
+ * --------------------------------
+ * The length of the range is computed first so that the buffer is
+ * expanded at most once.  The values are then stored one after another
+ * without further capacity checks.
+ */
+
+template <typename ValueType>
+template <typename IteratorType>
+void Queue<ValueType>::enqueueAll(IteratorType begin, IteratorType end) {
+   int n = (int) std::distance(begin, end);
+   if (n <= 0) return;
+   if (count + n > capacity) expandRingBufferCapacity(count + n);
+   for (IteratorType it = begin; it != end; ++it) {
+      elements[tail] = *it;
+      tail = (tail + 1) & mask;
+   }
+   count += n;
+}
+
 /*
  * Implementation notes: dequeue, peek
  * -----------------------------------
  * These methods must check for an empty queue and report an error
- * if there is no first element.
+ * if there is no first element.  The dequeue method moves the value
+ * out of the buffer, which releases any storage the value owns.
  */
 
 template <typename ValueType>
 ValueType Queue<ValueType>::dequeue() {
    if (count == 0) error("dequeue: Attempting to dequeue an empty queue");
-   ValueType result = ringBuffer[head];
-   head = (head + 1) % capacity;
+   ValueType result;
+   moveValue(result, elements[head]);
+   head = (head + 1) & mask;
    count--;
    return result;
 }
 
+template <typename ValueType>
+int Queue<ValueType>::dequeueInto(Vector<ValueType> & vec, int maxCount) {
+   int n = (maxCount < 0 || maxCount > count) ? count : maxCount;
+   for (int i = 0; i < n; i++) {
+      vec.add(ValueType());
+      moveValue(vec[vec.size() - 1], elements[head]);
+      head = (head + 1) & mask;
+   }
+   count -= n;
+   return n;
+}
+
 template <typename ValueType>
 ValueType Queue<ValueType>::peek() const {
    if (count == 0) error("peek: Attempting to peek at an empty queue");
-   return ringBuffer.get(head);
+   return elements[head];
 }
 
 template <typename ValueType>
 ValueType & Queue<ValueType>::front() {
    if (count == 0) error("front: Attempting to read front of an empty queue");
-   return ringBuffer[head];
+   return elements[head];
 }
 
 template <typename ValueType>
 ValueType & Queue<ValueType>::back() {
    if (count == 0) error("back: Attempting to read back of an empty queue");
-   return ringBuffer[(tail + capacity - 1) % capacity];
+   return elements[(tail - 1) & mask];
 }
 
 /*
  * Implementation notes: expandRingBufferCapacity
  * ----------------------------------------------
- * This private method doubles the capacity of the ringBuffer vector.
- * Note that this implementation also shifts all the elements back to
- * the beginning of the vector.
+ * This private method doubles the capacity of the ring buffer until it
+ * can hold minCapacity elements.  The elements are moved directly from
+ * the old buffer into the beginning of the new one, which takes at most
+ * two passes over contiguous memory.
  */
 
 template <typename ValueType>
-void Queue<ValueType>::expandRingBufferCapacity() {
-   Vector<ValueType> copy = ringBuffer;
-   ringBuffer = Vector<ValueType>(2 * capacity);
-   for (int i = 0; i < count; i++) {
-      ringBuffer[i] = copy[(head + i) % capacity];
+void Queue<ValueType>::expandRingBufferCapacity(int minCapacity) {
+   int newCapacity = capacity;
+   while (newCapacity < minCapacity) {
+      newCapacity *= 2;
+   }
+   ValueType *newElements = new ValueType[newCapacity];
+   int firstRun = capacity - head;
+   if (firstRun > count) firstRun = count;
+   for (int i = 0; i < firstRun; i++) {
+      moveValue(newElements[i], elements[head + i]);
+   }
+   for (int i = firstRun; i < count; i++) {
+      moveValue(newElements[i], elements[i - firstRun]);
    }
+   delete[] elements;
+   elements = newElements;
+   capacity = newCapacity;
+   mask = capacity - 1;
    head = 0;
-   tail = count;
-   capacity *= 2;
+   tail = count & mask;
 }
 
 #endif
@@ -7,19 +7,89 @@
 /*
  * Implementation notes: Queue data structure
  * ------------------------------------------
- * The Queue class is implemented using a ring buffer.
+ * The Queue class is implemented using a ring buffer.  The capacity
+ * of the buffer is always a power of two, so that an index can be
+ * wrapped around to the beginning with a bitwise AND against
+ * capacity - 1 instead of a division.
  */
 
 private:
 
+/* Constants */
+
+   static const int INITIAL_CAPACITY = 16;
+
 /* Instance variables */
 
-   Vector<ValueType> ringBuffer;
-   int count;
-   int capacity;
-   int head;
-   int tail;
+   ValueType *elements;      /* The ring buffer                          */
+   int count;                /* Number of values in the queue            */
+   int capacity;             /* Allocated size, always a power of two    */
+   int mask;                 /* Equal to capacity - 1                    */
+   int head;                 /* Index of the first value                 */
+   int tail;                 /* Index just past the last value           */
 
 /* Private functions */
 
-   void expandRingBufferCapacity();
+   void expandRingBufferCapacity(int minCapacity);
+
+/*
+ * Private method: moveValue
+ * Usage: moveValue(dst, src);
+ * ---------------------------
+ * Transfers the value in src to dst.  When the compiler supports move
+ * semantics, the value is moved; otherwise, it is copied and src is
+ * reset to its default value so that it holds no storage.
+ */
+
+   static void moveValue(ValueType & dst, ValueType & src) {
+#if __cplusplus >= 201103L
+      dst = std::move(src);
+#else
+      dst = src;
+      src = ValueType();
+#endif
+   }
+
+/*
+ * Hidden features
+ * ---------------
+ * The remainder of this file consists of the code required to
+ * support deep copying.  Including these methods in the public
+ * interface would make that interface more difficult to understand
+ * for the average client.
+ */
+
+/*
+ * Deep copying support
+ * --------------------
+ * This copy constructor and operator= are defined to make a
+ * deep copy, making it possible to pass/return queues by value
+ * and assign from one queue to another.  The copy is packed at
+ * the beginning of a buffer of the same capacity.
+ */
+
+   void copyInternalData(const Queue & queue) {
+      capacity = queue.capacity;
+      mask = queue.mask;
+      count = queue.count;
+      elements = new ValueType[capacity];
+      for (int i = 0; i < count; i++) {
+         elements[i] = queue.elements[(queue.head + i) & mask];
+      }
+      head = 0;
+      tail = count & mask;
+   }
+
+public:
+
+   Queue & operator=(const Queue & rhs) {
+      if (this != &rhs) {
+         delete[] elements;
+         copyInternalData(rhs);
+      }
+      return *this;
+   }
+
+   Queue(const Queue & rhs) {
+      copyInternalData(rhs);
+   }
@@ -11,11 +11,13 @@
 template <typename ValueType>
 Set<ValueType>::Set(int (*cmpFn)(ValueType, ValueType)) : map(cmpFn) {
    this->cmpFn = cmpFn;
+   removeFlag = false;
+   bloomFilter = NULL;
 }
 
 template <typename ValueType>
 Set<ValueType>::~Set() {
-   /* Empty */
+   delete bloomFilter;
 }
 
 template <typename ValueType>
@@ -28,14 +30,46 @@ bool Set<ValueType>::isEmpty() const {
    return map.isEmpty();
 }
 
+/*
+ * Implementation notes: add, insert, addSorted
+ * --------------------------------------------
+ * If a Bloom filter is attached, each new element is recorded in it.
+ * When the set outgrows the capacity of the filter, the filter is
+ * rebuilt at twice the size so that its false-positive rate stays
+ * near the requested value.
+ */
+
 template <typename ValueType>
 void Set<ValueType>::add(const ValueType & value) {
    map.put(value, true);
+   if (bloomFilter != NULL) {
+      if (map.size() > bloomFilter->capacity()) {
+         rebuildBloomFilter(2 * map.size());
+      } else {
+         bloomFilter->add(value);
+      }
+   }
 }
 
 template <typename ValueType>
 void Set<ValueType>::insert(const ValueType & value) {
-   map.put(value, true);
+   add(value);
+}
+
+template <typename ValueType>
+void Set<ValueType>::addSorted(const ValueType *array, int n) {
+   if (n == 0) return;
+   Vector<bool> flags(n, true);
+   map.putSorted(array, &flags[0], n);
+   if (bloomFilter != NULL) {
+      if (map.size() > bloomFilter->capacity()) {
+         rebuildBloomFilter(2 * map.size());
+      } else {
+         for (int i = 0; i < n; i++) {
+            bloomFilter->add(array[i]);
+         }
+      }
+   }
 }
 
 template <typename ValueType>
@@ -45,12 +79,61 @@ void Set<ValueType>::remove(const ValueType & value) {
 
 template <typename ValueType>
 bool Set<ValueType>::contains(const ValueType & value) const {
-   return map.containsKey(value);
+   if (bloomFilter == NULL) return map.containsKey(value);
+   if (!bloomFilter->mightContain(value)) return false;
+   if (map.containsKey(value)) return true;
+   bloomFilter->recordFalsePositive();
+   return false;
 }
 
 template <typename ValueType>
 void Set<ValueType>::clear() {
    map.clear();
+   if (bloomFilter != NULL) bloomFilter->clear();
+}
+
+/*
+ * Implementation notes: enableBloomFilter, rebuildBloomFilter
+ * -----------------------------------------------------------
+ * The filter cannot forget a value, so remove leaves it unchanged.
+ * Any stale bits are discarded the next time the filter is rebuilt.
+ */
+
+template <typename ValueType>
+void Set<ValueType>::enableBloomFilter(double falsePositiveRate) {
+   int capacity = 2 * map.size();
+   if (capacity < MIN_FILTER_CAPACITY) capacity = MIN_FILTER_CAPACITY;
+   delete bloomFilter;
+   bloomFilter =
+      new BloomFilter<ValueType>(capacity, falsePositiveRate, hashValue);
+   bloomFilter->addAll(*this);
+}
+
+template <typename ValueType>
+void Set<ValueType>::disableBloomFilter() {
+   delete bloomFilter;
+   bloomFilter = NULL;
+}
+
+template <typename ValueType>
+const BloomFilter<ValueType> *Set<ValueType>::getBloomFilter() const {
+   return bloomFilter;
+}
+
+template <typename ValueType>
+void Set<ValueType>::setCopyOnWrite(bool flag) {
+   map.setCopyOnWrite(flag);
+}
+
+template <typename ValueType>
+bool Set<ValueType>::isCopyOnWrite() const {
+   return map.isCopyOnWrite();
+}
+
+template <typename ValueType>
+void Set<ValueType>::rebuildBloomFilter(int capacity) {
+   bloomFilter->resize(capacity);
+   bloomFilter->addAll(*this);
 }
 
 template <typename ValueType>
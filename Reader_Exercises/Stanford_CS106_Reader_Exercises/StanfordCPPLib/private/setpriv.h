@@ -12,6 +12,19 @@ private:
    Map<ValueType,bool> map;            /* Map used to store the element     */
    bool removeFlag;                    /* Flag to differentiate += and -=   */
    int (*cmpFn)(ValueType, ValueType); /* Function used to compare elements */
+   BloomFilter<ValueType> *bloomFilter; /* Optional negative-lookup filter  */
+
+/* Constants */
+
+   static const int MIN_FILTER_CAPACITY = 128;
+
+/* Private methods */
+
+   void rebuildBloomFilter(int capacity);
+
+   static int hashValue(const ValueType & value) {
+      return hashCode(value);
+   }
 
 public:
 
@@ -33,6 +46,37 @@ public:
       return *this;
    }
 
+/*
+ * Deep copying support
+ * --------------------
+ * The elements themselves are copied by the underlying map.  These
+ * methods exist so that each copy of the set owns a separate copy
+ * of its Bloom filter.
+ */
+
+   Set & operator=(const Set & rhs) {
+      if (this != &rhs) {
+         map = rhs.map;
+         removeFlag = rhs.removeFlag;
+         cmpFn = rhs.cmpFn;
+         delete bloomFilter;
+         bloomFilter = NULL;
+         if (rhs.bloomFilter != NULL) {
+            bloomFilter = new BloomFilter<ValueType>(*rhs.bloomFilter);
+         }
+      }
+      return *this;
+   }
+
+   Set(const Set & rhs) : map(rhs.map) {
+      removeFlag = rhs.removeFlag;
+      cmpFn = rhs.cmpFn;
+      bloomFilter = NULL;
+      if (rhs.bloomFilter != NULL) {
+         bloomFilter = new BloomFilter<ValueType>(*rhs.bloomFilter);
+      }
+   }
+
 /*
  * Iterator support
  * ----------------
@@ -0,0 +1,152 @@
+/*
+ * File: sparsegridimpl.cpp
+ * ------------------------
+ * This file contains the implementation of the sparsegrid.h interface.
+ * Because of the way C++ compiles templates, this code must be
+ * available to the compiler when it reads the header file.
+ */
+
+#ifdef _sparsegrid_h
+
+template <typename ValueType>
+SparseGrid<ValueType>::SparseGrid() {
+   nRows = 0;
+   nCols = 0;
+   nTileCols = 0;
+   defaultValue = ValueType();
+   cachedKey = -1;
+   cachedTile = NULL;
+}
+
+template <typename ValueType>
+SparseGrid<ValueType>::SparseGrid(int nRows, int nCols,
+                                  ValueType defaultValue) {
+   this->defaultValue = defaultValue;
+   resize(nRows, nCols);
+}
+
+template <typename ValueType>
+SparseGrid<ValueType>::~SparseGrid() {
+   deleteTiles();
+}
+
+template <typename ValueType>
+int SparseGrid<ValueType>::numRows() const {
+   return nRows;
+}
+
+template <typename ValueType>
+int SparseGrid<ValueType>::numCols() const {
+   return nCols;
+}
+
+/*
+ * Implementation notes: resize
+ * ----------------------------
+ * The tile index must fit in an int, which limits the grid to about
+ * 2^31 tiles, or roughly 2.9 million rows and columns if it is square.
+ */
+
+template <typename ValueType>
+void SparseGrid<ValueType>::resize(int nRows, int nCols) {
+   if (nRows < 0 || nCols < 0) {
+      error("Attempt to resize grid to invalid size ("
+            + integerToString(nRows) + ", "
+            + integerToString(nCols) + ")");
+   }
+   int nTileRows = (nRows + TILE_MASK) >> TILE_SHIFT;
+   int nTileCols = (nCols + TILE_MASK) >> TILE_SHIFT;
+   if (nTileCols > 0 && nTileRows > 0x7FFFFFFF / nTileCols) {
+      error("resize: SparseGrid is too large");
+   }
+   deleteTiles();
+   this->nRows = nRows;
+   this->nCols = nCols;
+   this->nTileCols = nTileCols;
+}
+
+template <typename ValueType>
+bool SparseGrid<ValueType>::inBounds(int row, int col) const {
+   return row >= 0 && col >= 0 && row < nRows && col < nCols;
+}
+
+template <typename ValueType>
+ValueType SparseGrid<ValueType>::get(int row, int col) const {
+   checkCell(row, col, "get");
+   int key = (row >> TILE_SHIFT) * nTileCols + (col >> TILE_SHIFT);
+   ValueType *tile = (key == cachedKey) ? cachedTile : findTile(key);
+   if (tile == NULL) return defaultValue;
+   return tile[((row & TILE_MASK) << TILE_SHIFT) + (col & TILE_MASK)];
+}
+
+template <typename ValueType>
+void SparseGrid<ValueType>::set(int row, int col, ValueType value) {
+   checkCell(row, col, "set");
+   int key = (row >> TILE_SHIFT) * nTileCols + (col >> TILE_SHIFT);
+   if (key != cachedKey) {
+      cachedKey = key;
+      cachedTile = findTile(key);
+   }
+   ValueType *tile = cachedTile;
+   if (tile == NULL) {
+      tile = new ValueType[TILE_SIZE * TILE_SIZE];
+      for (int i = 0; i < TILE_SIZE * TILE_SIZE; i++) {
+         tile[i] = defaultValue;
+      }
+      tiles.put(key, tile);
+      cachedTile = tile;
+   }
+   tile[((row & TILE_MASK) << TILE_SHIFT) + (col & TILE_MASK)] = value;
+}
+
+template <typename ValueType>
+ValueType SparseGrid<ValueType>::getDefaultValue() const {
+   return defaultValue;
+}
+
+template <typename ValueType>
+void SparseGrid<ValueType>::clear() {
+   deleteTiles();
+}
+
+template <typename ValueType>
+int SparseGrid<ValueType>::tileCount() const {
+   return tiles.size();
+}
+
+/*
+ * Implementation notes: findTile
+ * ------------------------------
+ * This method returns the tile with the given key, or NULL if there is
+ * none.  It does not touch the one-entry cache, which only set updates.
+ * As a result, the const get method changes nothing in the grid, and
+ * several threads can read the same grid at once as long as none of
+ * them writes to it.
+ */
+
+template <typename ValueType>
+ValueType *SparseGrid<ValueType>::findTile(int key) const {
+   return tiles.containsKey(key) ? tiles.get(key) : NULL;
+}
+
+template <typename ValueType>
+void SparseGrid<ValueType>::checkCell(int row, int col,
+                                      std::string caller) const {
+   if (!inBounds(row, col)) {
+      error(caller + ": SparseGrid index values out of range");
+   }
+}
+
+template <typename ValueType>
+void SparseGrid<ValueType>::deleteTiles() {
+   typename HashMap<int,ValueType *>::iterator end = tiles.end();
+   for (typename HashMap<int,ValueType *>::iterator it = tiles.begin();
+        it != end; ++it) {
+      delete[] tiles.get(*it);
+   }
+   tiles.clear();
+   cachedKey = -1;
+   cachedTile = NULL;
+}
+
+#endif
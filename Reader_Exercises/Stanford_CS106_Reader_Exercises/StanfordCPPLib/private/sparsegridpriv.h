@@ -0,0 +1,94 @@
+/*
+ * File: sparsegridpriv.h
+ * ----------------------
+ * This file contains the private section of the sparsegrid.h interface.
+ */
+
+/*
+ * Implementation notes: SparseGrid data structure
+ * -----------------------------------------------
+ * Each tile is a dynamic array of TILE_SIZE * TILE_SIZE values in
+ * row-major order.  The tiles are kept in a HashMap keyed by the index
+ * tileRow * nTileCols + tileCol.  Accesses to a grid tend to stay within
+ * one tile for a while, so set remembers the most recent key and the
+ * tile it found, which may be NULL if no tile exists.  Most calls to set
+ * then skip the hash table entirely.  The get method uses the cache when
+ * the key matches but never changes it, which keeps const access free
+ * of writes.
+ */
+
+private:
+
+/* Constants */
+
+   static const int TILE_SHIFT = 6;
+   static const int TILE_SIZE = 1 << TILE_SHIFT;
+   static const int TILE_MASK = TILE_SIZE - 1;
+
+/* Instance variables */
+
+   HashMap<int,ValueType *> tiles;   /* The allocated tiles              */
+   int nRows;                        /* The number of rows in the grid   */
+   int nCols;                        /* The number of columns            */
+   int nTileCols;                    /* The number of tiles in each row  */
+   ValueType defaultValue;           /* Value of unwritten cells         */
+   int cachedKey;                    /* Key of the last tile set uses    */
+   ValueType *cachedTile;            /* That tile, or NULL if absent     */
+
+/* Private method prototypes */
+
+   ValueType *findTile(int key) const;
+   void checkCell(int row, int col, std::string caller) const;
+   void deleteTiles();
+
+/*
+ * Hidden features
+ * ---------------
+ * The remainder of this file consists of the code required to
+ * support deep copying.  Including these methods in the public
+ * interface would make that interface more difficult to understand
+ * for the average client.
+ */
+
+/*
+ * Deep copying support
+ * --------------------
+ * This copy constructor and operator= are defined to make a
+ * deep copy, making it possible to pass/return grids by value
+ * and assign from one grid to another.  Only the allocated tiles
+ * are copied.
+ */
+
+   void copyInternalData(const SparseGrid & grid) {
+      nRows = grid.nRows;
+      nCols = grid.nCols;
+      nTileCols = grid.nTileCols;
+      defaultValue = grid.defaultValue;
+      cachedKey = -1;
+      cachedTile = NULL;
+      typename HashMap<int,ValueType *>::iterator end = grid.tiles.end();
+      for (typename HashMap<int,ValueType *>::iterator it = grid.tiles.begin();
+           it != end; ++it) {
+         int key = *it;
+         ValueType *src = grid.tiles.get(key);
+         ValueType *tile = new ValueType[TILE_SIZE * TILE_SIZE];
+         for (int i = 0; i < TILE_SIZE * TILE_SIZE; i++) {
+            tile[i] = src[i];
+         }
+         tiles.put(key, tile);
+      }
+   }
+
+public:
+
+   SparseGrid & operator=(const SparseGrid & rhs) {
+      if (this != &rhs) {
+         deleteTiles();
+         copyInternalData(rhs);
+      }
+      return *this;
+   }
+
+   SparseGrid(const SparseGrid & rhs) {
+      copyInternalData(rhs);
+   }
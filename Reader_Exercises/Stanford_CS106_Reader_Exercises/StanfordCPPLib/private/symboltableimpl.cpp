@@ -0,0 +1,176 @@
+/*
+ * File: symboltableimpl.cpp
+ * -------------------------
+ * This file contains the implementation of the symboltable.h
+ * interface.  The methods are declared inline so that the file can be
+ * included by more than one source file.
+ */
+
+#ifdef _symboltable_h
+
+#include <cstring>
+
+inline SymbolTable::SymbolTable() {
+   initEmpty();
+}
+
+inline SymbolTable::~SymbolTable() {
+   freeStorage();
+}
+
+inline int SymbolTable::size() const {
+   return count;
+}
+
+inline bool SymbolTable::isEmpty() const {
+   return count == 0;
+}
+
+inline void SymbolTable::clear() {
+   freeStorage();
+   initEmpty();
+}
+
+inline int SymbolTable::intern(const std::string & name) {
+   return intern(name.data(), int(name.length()));
+}
+
+/*
+ * Implementation notes: intern
+ * ----------------------------
+ * The hash table grows before it becomes more than half full, after
+ * which the slot must be found again because the new table places the
+ * strings differently.
+ */
+
+inline int SymbolTable::intern(const char *chars, int length) {
+   uint32_t hash = hashChars(chars, length);
+   int slot = findSlot(chars, length, hash);
+   if (slots[slot] >= 0) return slots[slot];
+   if (2 * (count + 1) > slotMask + 1) {
+      rehash(2 * (slotMask + 1));
+      slot = findSlot(chars, length, hash);
+   }
+   if (count == capacity) expandNames();
+   names[count].assign(chars, length);
+   hashes[count] = hash;
+   slots[slot] = count;
+   return count++;
+}
+
+inline int SymbolTable::find(const std::string & name) const {
+   return find(name.data(), int(name.length()));
+}
+
+inline int SymbolTable::find(const char *chars, int length) const {
+   return slots[findSlot(chars, length, hashChars(chars, length))];
+}
+
+inline bool SymbolTable::contains(const std::string & name) const {
+   return find(name) >= 0;
+}
+
+inline const std::string & SymbolTable::getName(int id) const {
+   if (id < 0 || id >= count) error("getName: Symbol id is out of range");
+   return names[id];
+}
+
+inline void SymbolTable::initEmpty() {
+   count = 0;
+   capacity = 0;
+   names = NULL;
+   hashes = NULL;
+   slotMask = 15;
+   slots = new int[slotMask + 1];
+   for (int i = 0; i <= slotMask; i++) {
+      slots[i] = -1;
+   }
+}
+
+inline void SymbolTable::freeStorage() {
+   delete[] names;
+   delete[] hashes;
+   delete[] slots;
+}
+
+/*
+ * Implementation notes: expandNames
+ * ---------------------------------
+ * The strings are moved to the new array by swapping, which for most
+ * library implementations exchanges the internal pointers of the two
+ * strings rather than copying their characters.
+ */
+
+inline void SymbolTable::expandNames() {
+   int newCapacity = (capacity == 0) ? 16 : 2 * capacity;
+   std::string *newNames = new std::string[newCapacity];
+   uint32_t *newHashes = new uint32_t[newCapacity];
+   for (int i = 0; i < count; i++) {
+      newNames[i].swap(names[i]);
+      newHashes[i] = hashes[i];
+   }
+   delete[] names;
+   delete[] hashes;
+   names = newNames;
+   hashes = newHashes;
+   capacity = newCapacity;
+}
+
+inline void SymbolTable::rehash(int nSlots) {
+   delete[] slots;
+   slotMask = nSlots - 1;
+   slots = new int[nSlots];
+   for (int i = 0; i < nSlots; i++) {
+      slots[i] = -1;
+   }
+   for (int id = 0; id < count; id++) {
+      int slot = hashes[id] & slotMask;
+      while (slots[slot] >= 0) {
+         slot = (slot + 1) & slotMask;
+      }
+      slots[slot] = id;
+   }
+}
+
+/*
+ * Implementation notes: findSlot
+ * ------------------------------
+ * This method returns the slot that holds the id of the string or, if
+ * the string is not in the table, the empty slot at which the search
+ * stopped.
+ */
+
+inline int SymbolTable::findSlot(const char *chars, int length,
+                                 uint32_t hash) const {
+   int slot = hash & slotMask;
+   while (true) {
+      int id = slots[slot];
+      if (id < 0) return slot;
+      if (hashes[id] == hash && int(names[id].length()) == length
+          && std::memcmp(names[id].data(), chars, length) == 0) {
+         return slot;
+      }
+      slot = (slot + 1) & slotMask;
+   }
+}
+
+/*
+ * Implementation notes: hashChars
+ * -------------------------------
+ * The hash function is FNV-1a, followed by a final mixing step that
+ * spreads the effect of the last few characters into the low-order
+ * bits, which are the ones used to choose a slot.
+ */
+
+inline uint32_t SymbolTable::hashChars(const char *chars, int length) {
+   uint32_t hash = 2166136261U;
+   for (int i = 0; i < length; i++) {
+      hash = (hash ^ (unsigned char) chars[i]) * 16777619U;
+   }
+   hash ^= hash >> 16;
+   hash *= 0x85EBCA6BU;
+   hash ^= hash >> 13;
+   return hash;
+}
+
+#endif
@@ -0,0 +1,85 @@
+/*
+ * File: symboltablepriv.h
+ * -----------------------
+ * This file contains the private section of the symboltable.h
+ * interface.
+ */
+
+/*
+ * Implementation notes: SymbolTable data structure
+ * ------------------------------------------------
+ * The strings are stored in an array indexed by id, along with the
+ * hash code of each one.  The hash table itself holds only ids, using
+ * open addressing with linear probing; an empty slot holds -1.  The
+ * table has a power-of-two number of slots and is kept no more than
+ * half full.  Comparing the stored hash codes before the strings means
+ * that a probe rarely compares the characters of a string that does
+ * not match.
+ */
+
+private:
+
+/* Instance variables */
+
+   std::string *names;           /* The string with each id             */
+   uint32_t *hashes;             /* The hash code of each string        */
+   int count;                    /* The number of strings               */
+   int capacity;                 /* The allocated size of names         */
+   int *slots;                   /* Hash table of ids, -1 if empty      */
+   int slotMask;                 /* The number of slots minus one       */
+
+/* Private method prototypes */
+
+   void initEmpty();
+   void freeStorage();
+   void expandNames();
+   void rehash(int nSlots);
+   int findSlot(const char *chars, int length, uint32_t hash) const;
+   static uint32_t hashChars(const char *chars, int length);
+
+/*
+ * Hidden features
+ * ---------------
+ * The remainder of this file consists of the code required to
+ * support deep copying.  Including these methods in the public
+ * interface would make that interface more difficult to understand
+ * for the average client.
+ */
+
+/*
+ * Deep copying support
+ * --------------------
+ * This copy constructor and operator= are defined to make a deep copy,
+ * making it possible to pass and return symbol tables by value and
+ * assign from one to another.  The copy assigns the same ids.
+ */
+
+   void copyInternalData(const SymbolTable & src) {
+      count = src.count;
+      capacity = src.capacity;
+      slotMask = src.slotMask;
+      names = new std::string[capacity];
+      hashes = new uint32_t[capacity];
+      for (int i = 0; i < count; i++) {
+         names[i] = src.names[i];
+         hashes[i] = src.hashes[i];
+      }
+      slots = new int[slotMask + 1];
+      for (int i = 0; i <= slotMask; i++) {
+         slots[i] = src.slots[i];
+      }
+   }
+
+public:
+
+   SymbolTable & operator=(const SymbolTable & src) {
+      if (this != &src) {
+         freeStorage();
+         copyInternalData(src);
+      }
+      return *this;
+   }
+
+   SymbolTable(const SymbolTable & src) {
+      copyInternalData(src);
+   }
@@ -0,0 +1,491 @@
+/*
+ * File: threadpoolimpl.cpp
+ * ------------------------
+ * This file contains the implementation of the threadpool.h interface.
+ * Because of the way C++ compiles templates, this code must be
+ * available to the compiler when it reads the header file.  The
+ * functions that are not templates are declared inline so that the
+ * file can be included by more than one source file.
+ */
+
+#ifdef _threadpool_h
+
+#include <exception>
+#ifndef _WIN32
+#  include <unistd.h>
+#endif
+
+/* Constants */
+
+const int PARALLEL_MIN_SIZE = 4096;       /* Smaller arrays run serially  */
+const int PARALLEL_REDUCE_CHUNK = 16384;  /* Deterministic chunk length   */
+
+inline ThreadPool::ThreadPool(int nThreads) {
+   if (nThreads < 1) {
+      error("ThreadPool: thread count must be at least 1");
+   }
+   generation = 0;
+   pending = 0;
+   taskFn = NULL;
+   taskData = NULL;
+   taskCount = 0;
+   failed = false;
+   startWorkers(nThreads);
+}
+
+inline ThreadPool::~ThreadPool() {
+   stopWorkers();
+}
+
+inline int ThreadPool::getThreadCount() const {
+   int n = 0;
+   synchronized (lock) {
+      n = nThreads;
+   }
+   return n;
+}
+
+inline void ThreadPool::setThreadCount(int nThreads) {
+   if (nThreads < 1) {
+      error("setThreadCount: thread count must be at least 1");
+   }
+   if (activePool() == this) {
+      error("setThreadCount: Pool is running the calling task");
+   }
+   synchronized (submitLock) {
+      stopWorkers();
+      startWorkers(nThreads);
+   }
+}
+
+template <typename ClientType>
+void ThreadPool::runParallel(void (*fn)(ClientType & data, int index),
+                             ClientType & data) {
+   TypedTask<ClientType> task = { fn, &data };
+   runTasks(runTypedTask<ClientType>, &task, 0);
+}
+
+template <typename ClientType>
+void ThreadPool::runParallel(void (*fn)(ClientType & data, int index),
+                             ClientType & data, int nTasks) {
+   TypedTask<ClientType> task = { fn, &data };
+   runTasks(runTypedTask<ClientType>, &task, nTasks);
+}
+
+template <typename ClientType>
+void ThreadPool::runTypedTask(void *data, int index) {
+   TypedTask<ClientType> *task = (TypedTask<ClientType> *) data;
+   task->fn(*task->data, index);
+}
+
+/*
+ * Implementation notes: startWorkers, stopWorkers
+ * -----------------------------------------------
+ * Each worker is given the generation number at the time it starts,
+ * so that it waits for the next operation rather than repeating the
+ * last one.  stopWorkers sets shuttingDown, wakes every worker, and
+ * joins them all.
+ */
+
+inline void ThreadPool::startWorkers(int nThreads) {
+   synchronized (lock) {
+      this->nThreads = nThreads;
+   }
+   shuttingDown = false;
+   threads = new Thread[nThreads];
+   workers = new WorkerState[nThreads];
+   for (int i = 1; i < nThreads; i++) {
+      workers[i].pool = this;
+      workers[i].index = i;
+      workers[i].generation = generation;
+      threads[i] = fork(workerMain, workers[i]);
+   }
+}
+
+inline void ThreadPool::stopWorkers() {
+   synchronized (lock) {
+      shuttingDown = true;
+      lock.signal();
+   }
+   for (int i = 1; i < nThreads; i++) {
+      join(threads[i]);
+   }
+   delete[] threads;
+   delete[] workers;
+}
+
+/*
+ * Implementation notes: runTasks, workerMain
+ * ------------------------------------------
+ * runTasks publishes the operation and increments the generation
+ * number under lock, makes the calls for thread 0 itself, and then
+ * waits for pending to fall to zero.  Each worker copies the operation
+ * while it holds the lock and releases the lock while it makes its
+ * calls.  A call to runTasks from a task of the same pool would wait
+ * forever for submitLock, which its own operation holds, so such a
+ * call makes all of its calls directly.  The activePool function
+ * identifies those calls: it returns the pool whose task the current
+ * thread is running, which is always the pool for a worker and is set
+ * by runTasks while the calling thread makes its own calls.  Any
+ * exception thrown by a task is recorded by runShare, and runTasks
+ * reports it once every thread has finished and both locks have been
+ * released.
+ */
+
+inline void ThreadPool::runTasks(void (*fn)(void *data, int index),
+                                 void *data, int nTasks) {
+   if (activePool() == this) {
+      if (nTasks <= 0) nTasks = nThreads;
+      for (int i = 0; i < nTasks; i++) {
+         fn(data, i);
+      }
+      return;
+   }
+   bool taskFailed = false;
+   std::string msg;
+   synchronized (submitLock) {
+      int stride = nThreads;
+      if (nTasks <= 0) nTasks = stride;
+      ThreadPool *outer = activePool();
+      activePool() = this;
+      if (stride == 1 || nTasks == 1) {
+         runShare(fn, data, 0, nTasks, 1);
+      } else {
+         synchronized (lock) {
+            taskFn = fn;
+            taskData = data;
+            taskCount = nTasks;
+            pending = stride - 1;
+            generation++;
+            lock.signal();
+         }
+         runShare(fn, data, 0, nTasks, stride);
+         synchronized (lock) {
+            while (pending > 0) {
+               lock.wait();
+            }
+         }
+      }
+      activePool() = outer;
+      synchronized (lock) {
+         taskFailed = failed;
+         msg = failure;
+         failed = false;
+         failure = "";
+      }
+   }
+   if (taskFailed) error(msg);
+}
+
+inline void ThreadPool::runShare(void (*fn)(void *data, int index),
+                                 void *data, int first, int nTasks,
+                                 int stride) {
+   try {
+      for (int i = first; i < nTasks; i += stride) {
+         fn(data, i);
+      }
+   } catch (ErrorException & ex) {
+      recordFailure(ex.getMessage());
+   } catch (std::exception & ex) {
+      recordFailure(ex.what());
+   } catch (...) {
+      recordFailure("runParallel: Task threw an unknown exception");
+   }
+}
+
+inline void ThreadPool::recordFailure(std::string msg) {
+   synchronized (lock) {
+      if (!failed) {
+         failed = true;
+         failure = msg;
+      }
+   }
+}
+
+inline void ThreadPool::workerMain(WorkerState & state) {
+   ThreadPool *pool = state.pool;
+   activePool() = pool;
+   bool done = false;
+   while (!done) {
+      void (*fn)(void *, int) = NULL;
+      void *data = NULL;
+      int nTasks = 0;
+      int stride = 1;
+      synchronized (pool->lock) {
+         while (pool->generation == state.generation
+                && !pool->shuttingDown) {
+            pool->lock.wait();
+         }
+         done = pool->shuttingDown;
+         state.generation = pool->generation;
+         fn = pool->taskFn;
+         data = pool->taskData;
+         nTasks = pool->taskCount;
+         stride = pool->nThreads;
+      }
+      if (!done) {
+         pool->runShare(fn, data, state.index, nTasks, stride);
+         synchronized (pool->lock) {
+            if (--pool->pending == 0) pool->lock.signal();
+         }
+      }
+   }
+}
+
+/*
+ * Implementation notes: activePool
+ * --------------------------------
+ * The pointer is a static local variable with thread-local storage, so
+ * each thread has its own copy.  Because the function is inline, every
+ * source file refers to the same variable.
+ */
+
+inline ThreadPool *& ThreadPool::activePool() {
+   static __thread ThreadPool *pool = NULL;
+   return pool;
+}
+
+/*
+ * Implementation notes: getDefaultThreadPool
+ * ------------------------------------------
+ * The pool is a static local variable, which is shared by every source
+ * file because the function is inline.  The number of processors comes
+ * from sysconf where it is available; elsewhere the default pool has a
+ * single thread until the client sets its size.
+ */
+
+inline ThreadPool & getDefaultThreadPool() {
+   int nThreads = 1;
+#ifdef _SC_NPROCESSORS_ONLN
+   nThreads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+   if (nThreads < 1) nThreads = 1;
+#endif
+   static ThreadPool pool(nThreads);
+   return pool;
+}
+
+/*
+ * Implementation notes: parallel array operations
+ * -----------------------------------------------
+ * Each operation packages its arguments in a task structure and passes
+ * it to runParallel along with a function that processes one chunk.
+ * The number of chunks is read from the pool once and passed to
+ * runParallel, so every chunk is processed exactly once even if the
+ * size of the pool changes in the meantime.  Chunk i covers the indices
+ * from
+ * parallelChunkStart(n, nChunks, i) up to the start of chunk i + 1,
+ * which divides the array as evenly as possible.  Arrays with fewer
+ * than PARALLEL_MIN_SIZE elements are processed on the calling thread,
+ * where the cost of waking the workers would outweigh the gain.
+ */
+
+inline int parallelChunkStart(int n, int nChunks, int index) {
+   return (int) ((int64_t) n * index / nChunks);
+}
+
+template <typename ValueType, typename FunctionType>
+struct ParallelMapTask {
+   ValueType *array;
+   int n;
+   int nChunks;
+   FunctionType *fn;
+};
+
+template <typename ValueType, typename FunctionType>
+void parallelMapChunk(ParallelMapTask<ValueType,FunctionType> & task,
+                      int index) {
+   ValueType *p = task.array + parallelChunkStart(task.n, task.nChunks, index);
+   ValueType *end = task.array
+                  + parallelChunkStart(task.n, task.nChunks, index + 1);
+   FunctionType & fn = *task.fn;
+   for (; p < end; p++) {
+      fn(*p);
+   }
+}
+
+template <typename ValueType, typename FunctionType>
+void parallelTransformChunk(ParallelMapTask<ValueType,FunctionType> & task,
+                            int index) {
+   ValueType *p = task.array + parallelChunkStart(task.n, task.nChunks, index);
+   ValueType *end = task.array
+                  + parallelChunkStart(task.n, task.nChunks, index + 1);
+   FunctionType & fn = *task.fn;
+   for (; p < end; p++) {
+      *p = fn(*p);
+   }
+}
+
+template <typename ValueType, typename FunctionType>
+void parallelMapAll(ThreadPool & pool, ValueType *array, int n,
+                    FunctionType fn) {
+   ParallelMapTask<ValueType,FunctionType> task = { array, n, 1, &fn };
+   if (n >= PARALLEL_MIN_SIZE) task.nChunks = pool.getThreadCount();
+   if (task.nChunks == 1) {
+      parallelMapChunk(task, 0);
+   } else {
+      pool.runParallel(parallelMapChunk<ValueType,FunctionType>, task,
+                       task.nChunks);
+   }
+}
+
+template <typename ValueType, typename FunctionType>
+void parallelTransform(ThreadPool & pool, ValueType *array, int n,
+                       FunctionType fn) {
+   ParallelMapTask<ValueType,FunctionType> task = { array, n, 1, &fn };
+   if (n >= PARALLEL_MIN_SIZE) task.nChunks = pool.getThreadCount();
+   if (task.nChunks == 1) {
+      parallelTransformChunk(task, 0);
+   } else {
+      pool.runParallel(parallelTransformChunk<ValueType,FunctionType>, task,
+                       task.nChunks);
+   }
+}
+
+/*
+ * Implementation notes: parallelReduce
+ * ------------------------------------
+ * The array is divided into nChunks chunks, and the chunks themselves
+ * are divided among nThreads threads, so that each thread reduces a
+ * contiguous run of chunks into the partials array.  The calling
+ * thread then combines the partial results in chunk order.  In the
+ * deterministic case the chunks have a fixed length, so neither the
+ * chunks nor the order of combination depend on the number of threads.
+ * The partials array is owned by a ParallelBuffer, which frees it even
+ * if runParallel or the final combination signals an error.
+ */
+
+template <typename ValueType>
+class ParallelBuffer {
+public:
+   explicit ParallelBuffer(int n) {
+      array = new ValueType[n];
+   }
+
+   ~ParallelBuffer() {
+      delete[] array;
+   }
+
+   ValueType *array;
+
+private:
+   ParallelBuffer(const ParallelBuffer & src);
+   ParallelBuffer & operator=(const ParallelBuffer & src);
+};
+
+template <typename ValueType, typename ResultType, typename CombineType>
+struct ParallelReduceTask {
+   const ValueType *array;
+   int n;
+   int nChunks;
+   int nThreads;
+   const ResultType *identity;
+   CombineType *combine;
+   ResultType *partials;
+};
+
+template <typename ValueType, typename ResultType, typename CombineType>
+void parallelReduceChunks(ParallelReduceTask<ValueType,ResultType,
+                                             CombineType> & task,
+                          int index) {
+   int first = parallelChunkStart(task.nChunks, task.nThreads, index);
+   int last = parallelChunkStart(task.nChunks, task.nThreads, index + 1);
+   CombineType & combine = *task.combine;
+   for (int c = first; c < last; c++) {
+      const ValueType *p = task.array
+                         + parallelChunkStart(task.n, task.nChunks, c);
+      const ValueType *end = task.array
+                           + parallelChunkStart(task.n, task.nChunks, c + 1);
+      ResultType result = *task.identity;
+      for (; p < end; p++) {
+         result = combine(result, *p);
+      }
+      task.partials[c] = result;
+   }
+}
+
+template <typename ValueType, typename ResultType, typename CombineType>
+ResultType parallelReduce(ThreadPool & pool, const ValueType *array, int n,
+                          ResultType identity, CombineType combine,
+                          bool deterministic) {
+   int nThreads = pool.getThreadCount();
+   if (n < PARALLEL_MIN_SIZE) nThreads = 1;
+   int nChunks = nThreads;
+   if (deterministic) {
+      nChunks = (n + PARALLEL_REDUCE_CHUNK - 1) / PARALLEL_REDUCE_CHUNK;
+      if (nChunks < 1) nChunks = 1;
+   }
+   ParallelReduceTask<ValueType,ResultType,CombineType> task;
+   task.array = array;
+   task.n = n;
+   task.nChunks = nChunks;
+   task.nThreads = nThreads;
+   task.identity = &identity;
+   task.combine = &combine;
+   ParallelBuffer<ResultType> partials(nChunks);
+   task.partials = partials.array;
+   if (nThreads == 1) {
+      parallelReduceChunks(task, 0);
+   } else {
+      pool.runParallel(parallelReduceChunks<ValueType,ResultType,CombineType>,
+                       task, nThreads);
+   }
+   ResultType result = identity;
+   for (int c = 0; c < nChunks; c++) {
+      result = combine(result, task.partials[c]);
+   }
+   return result;
+}
+
+/*
+ * Implementation notes: collection forms
+ * --------------------------------------
+ * Both collections store their elements in a single array.  The Vector
+ * forms reach that array through the address of element 0, which the
+ * constant form of parallelReduce obtains from begin, and the Grid
+ * forms through the data method.  The nonconstant form of data
+ * gives a copy-on-write grid its own copy of the elements, while the
+ * constant form used by parallelReduce leaves them shared.
+ */
+
+template <typename ValueType, typename FunctionType>
+void parallelMapAll(Vector<ValueType> & vec, FunctionType fn) {
+   if (vec.isEmpty()) return;
+   parallelMapAll(getDefaultThreadPool(), &vec[0], vec.size(), fn);
+}
+
+template <typename ValueType, typename FunctionType>
+void parallelMapAll(Grid<ValueType> & grid, FunctionType fn) {
+   parallelMapAll(getDefaultThreadPool(), grid.data(),
+                  grid.numRows() * grid.numCols(), fn);
+}
+
+template <typename ValueType, typename FunctionType>
+void parallelTransform(Vector<ValueType> & vec, FunctionType fn) {
+   if (vec.isEmpty()) return;
+   parallelTransform(getDefaultThreadPool(), &vec[0], vec.size(), fn);
+}
+
+template <typename ValueType, typename FunctionType>
+void parallelTransform(Grid<ValueType> & grid, FunctionType fn) {
+   parallelTransform(getDefaultThreadPool(), grid.data(),
+                     grid.numRows() * grid.numCols(), fn);
+}
+
+template <typename ValueType, typename ResultType, typename CombineType>
+ResultType parallelReduce(const Vector<ValueType> & vec, ResultType identity,
+                          CombineType combine, bool deterministic) {
+   if (vec.isEmpty()) return identity;
+   return parallelReduce(getDefaultThreadPool(),
+                         (const ValueType *) &*vec.begin(), vec.size(),
+                         identity, combine, deterministic);
+}
+
+template <typename ValueType, typename ResultType, typename CombineType>
+ResultType parallelReduce(const Grid<ValueType> & grid, ResultType identity,
+                          CombineType combine, bool deterministic) {
+   return parallelReduce(getDefaultThreadPool(), grid.data(),
+                         grid.numRows() * grid.numCols(),
+                         identity, combine, deterministic);
+}
+
+#endif
@@ -9,6 +9,8 @@
 #ifndef _queue_h
 #define _queue_h
 
+#include <iterator>
+#include <utility>
 #include "error.h"
 #include "vector.h"
 
@@ -80,15 +82,45 @@ public:
 
    void enqueue(ValueType value);
 
+/*
+ * Method: enqueueAll
+ * Usage: queue.enqueueAll(begin, end);
+ * ------------------------------------
+ * Adds the values in the range from <code>begin</code> up to but not
+ * including <code>end</code> to the end of the queue, in order.  The
+ * queue grows at most once to make room for the entire range.
+ */
+
+   template <typename IteratorType>
+   void enqueueAll(IteratorType begin, IteratorType end);
+
 /*
  * Method: dequeue
  * Usage: ValueType first = queue.dequeue();
  * -----------------------------------------
- * Removes and returns the first item in the queue.
+ * Removes and returns the first item in the queue.  The value is moved
+ * out of the queue rather than copied, so the queue no longer holds
+ * any storage belonging to it.
  */
 
    ValueType dequeue();
 
+/*
+ * Method: dequeueInto
+ * Usage: int n = queue.dequeueInto(vec);
+ *        int n = queue.dequeueInto(vec, maxCount);
+ * ------------------------------------------------
+ * Removes values from the front of the queue and adds them in order to
+ * the end of <code>vec</code>, stopping when the queue is empty or when
+ * <code>maxCount</code> values have been moved.  If
+ * <code>maxCount</code> is omitted, the entire queue is emptied.  The
+ * return value is the number of values moved.  This method is useful
+ * for processing a queue in batches, such as the frontier of a
+ * breadth-first search.
+ */
+
+   int dequeueInto(Vector<ValueType> & vec, int maxCount = -1);
+
 /*
  * Method: peek
  * Usage: ValueType first = queue.peek();
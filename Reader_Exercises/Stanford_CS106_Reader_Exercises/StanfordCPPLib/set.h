@@ -8,6 +8,7 @@
 #ifndef _set_h
 #define _set_h
 
+#include "bloomfilter.h"
 #include "cmpfn.h"
 #include "error.h"
 #include "foreach.h"
@@ -82,6 +83,19 @@ public:
    void add(const ValueType & value);
    void insert(const ValueType & value);
 
+/*
+ * Method: addSorted
+ * Usage: set.addSorted(array, n);
+ * -------------------------------
+ * Adds the first <code>n</code> elements of <code>array</code> to this
+ * set.  The elements must be distinct and in increasing order according
+ * to the comparison function of the set, which allows this method to
+ * merge them in a single pass, as described for <code>putSorted</code>
+ * in the <code>Map</code> class.
+ */
+
+   void addSorted(const ValueType *array, int n);
+
 /*
  * Method: remove
  * Usage: set.remove(value);
@@ -102,6 +116,58 @@ public:
 
    bool contains(const ValueType & value) const;
 
+/*
+ * Method: enableBloomFilter
+ * Usage: set.enableBloomFilter();
+ *        set.enableBloomFilter(falsePositiveRate);
+ * ------------------------------------------------
+ * Attaches a <code>BloomFilter</code> to this set that is consulted by
+ * <code>contains</code> before searching the tree, so that most queries
+ * for absent values are answered without any comparisons.  The filter
+ * is built from the current elements and maintained by <code>add</code>.
+ * The optional argument sets the target false-positive rate, which
+ * defaults to one percent.  This method requires that the value type
+ * have a <code>hashCode</code> function, as described in
+ * <code>hashmap.h</code>.
+ */
+
+   void enableBloomFilter(double falsePositiveRate = 0.01);
+
+/*
+ * Method: disableBloomFilter
+ * Usage: set.disableBloomFilter();
+ * --------------------------------
+ * Removes any filter previously attached by <code>enableBloomFilter</code>.
+ */
+
+   void disableBloomFilter();
+
+/*
+ * Method: getBloomFilter
+ * Usage: const BloomFilter<ValueType> *filter = set.getBloomFilter();
+ * -------------------------------------------------------------------
+ * Returns a pointer to the attached filter, which clients can use to
+ * read its hit and miss counters, or <code>NULL</code> if no filter
+ * is enabled.
+ */
+
+   const BloomFilter<ValueType> *getBloomFilter() const;
+
+/*
+ * Methods: setCopyOnWrite, isCopyOnWrite
+ * Usage: set.setCopyOnWrite(true);
+ *        if (set.isCopyOnWrite()) . . .
+ * -------------------------------------
+ * Turns copy-on-write sharing on or off and reports whether it is on.
+ * A copy-on-write set shares its elements with its copies until one
+ * of them is changed, as described for the <code>Map</code> class.
+ * Copying such a set therefore takes constant time, except that an
+ * attached Bloom filter is still copied in full.
+ */
+
+   void setCopyOnWrite(bool flag);
+   bool isCopyOnWrite() const;
+
 /*
  * Method: isSubsetOf
  * Usage: if (set.isSubsetOf(set2)) . . .
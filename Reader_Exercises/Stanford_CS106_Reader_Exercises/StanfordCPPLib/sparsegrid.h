@@ -0,0 +1,142 @@
+/*
+ * File: sparsegrid.h
+ * ------------------
+ * This interface exports the <code>SparseGrid</code> template class,
+ * a two-dimensional array that allocates storage only for the regions
+ * in which values have been stored.
+ */
+
+#ifndef _sparsegrid_h
+#define _sparsegrid_h
+
+#include "error.h"
+#include "hashmap.h"
+#include "strlib.h"
+
+/*
+ * Class: SparseGrid<ValueType>
+ * ----------------------------
+ * The <code>SparseGrid</code> class represents a grid in which most
+ * cells keep a common default value.  The grid is divided into square
+ * tiles of 64x64 cells, and a tile is allocated only when one of its
+ * cells is first written.  Reading a cell in a tile that has never been
+ * written returns the default value.  A grid with 100,000 rows and
+ * columns therefore takes memory in proportion to the area that is in
+ * use rather than to its full size.  The cells are read and written
+ * with <code>get</code> and <code>set</code>, which correspond to
+ * reading and assigning <code>grid[row][col]</code> in a
+ * <code>Grid</code>.  Reading the grid does not change it, so several
+ * threads may call <code>get</code> at once provided that no thread
+ * calls <code>set</code> at the same time.
+ */
+
+template <typename ValueType>
+class SparseGrid {
+
+public:
+
+/*
+ * Constructor: SparseGrid
+ * Usage: SparseGrid<ValueType> grid;
+ *        SparseGrid<ValueType> grid(nRows, nCols);
+ *        SparseGrid<ValueType> grid(nRows, nCols, defaultValue);
+ * -------------------------------------------------------------
+ * Initializes a new grid with the specified number of rows and columns,
+ * in which every cell has the default value.  If
+ * <code>defaultValue</code> is not given, the default value is the one
+ * produced by the default constructor for the type.  The first form
+ * creates an empty grid for which the client must call
+ * <code>resize</code> to set the dimensions.
+ */
+
+   SparseGrid();
+   SparseGrid(int nRows, int nCols, ValueType defaultValue = ValueType());
+
+/*
+ * Destructor: ~SparseGrid
+ * Usage: (usually implicit)
+ * -------------------------
+ * Frees any heap storage associated with this grid.
+ */
+
+   ~SparseGrid();
+
+/*
+ * Methods: numRows, numCols
+ * Usage: int nRows = grid.numRows();
+ * ----------------------------------
+ * These methods return the number of rows and columns in the grid.
+ */
+
+   int numRows() const;
+   int numCols() const;
+
+/*
+ * Method: resize
+ * Usage: grid.resize(nRows, nCols);
+ * ---------------------------------
+ * Reinitializes the grid to have the specified number of rows and
+ * columns.  Any previous contents are discarded.
+ */
+
+   void resize(int nRows, int nCols);
+
+/*
+ * Method: inBounds
+ * Usage: if (grid.inBounds(row, col)) . . .
+ * -----------------------------------------
+ * Returns <code>true</code> if the specified row and column position
+ * is inside the bounds of the grid.
+ */
+
+   bool inBounds(int row, int col) const;
+
+/*
+ * Methods: get, set
+ * Usage: ValueType value = grid.get(row, col);
+ *        grid.set(row, col, value);
+ * ---------------------------------------------
+ * These methods read and write the cell at the specified position.
+ * Calling <code>set</code> allocates the tile that contains the cell
+ * if it does not already exist.  Both methods signal an error if the
+ * position is outside the grid.
+ */
+
+   ValueType get(int row, int col) const;
+   void set(int row, int col, ValueType value);
+
+/*
+ * Method: getDefaultValue
+ * Usage: ValueType value = grid.getDefaultValue();
+ * ------------------------------------------------
+ * Returns the value of cells that have not been written.
+ */
+
+   ValueType getDefaultValue() const;
+
+/*
+ * Method: clear
+ * Usage: grid.clear();
+ * --------------------
+ * Frees every tile, which returns all cells to the default value.
+ */
+
+   void clear();
+
+/*
+ * Method: tileCount
+ * Usage: int n = grid.tileCount();
+ * --------------------------------
+ * Returns the number of tiles that have been allocated.  Each tile
+ * holds 4096 values.
+ */
+
+   int tileCount() const;
+
+#include "private/sparsegridpriv.h"
+
+};
+
+#include "private/sparsegridimpl.cpp"
+
+#endif
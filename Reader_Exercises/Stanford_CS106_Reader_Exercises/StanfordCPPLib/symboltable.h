@@ -0,0 +1,134 @@
+/*
+ * File: symboltable.h
+ * -------------------
+ * This interface exports the <code>SymbolTable</code> class, which
+ * assigns a small integer to each distinct string it is given.
+ */
+
+#ifndef _symboltable_h
+#define _symboltable_h
+
+#include <stdint.h>
+#include <string>
+#include "error.h"
+
+/*
+ * Class: SymbolTable
+ * ------------------
+ * This class <i>interns</i> strings: the first time a string is passed
+ * to <code>intern</code>, the table assigns it the next unused
+ * <i>id,</i> starting at 0, and every later call with an equal string
+ * returns the same id.  The ids are therefore dense, which allows
+ * clients to keep information about each string in an array indexed
+ * by id rather than in a map keyed by the string.  The table finds
+ * strings using a hash table, so both <code>intern</code> and
+ * <code>find</code> take constant time on average.  Strings are never
+ * removed from the table except by <code>clear</code>.
+ */
+
+class SymbolTable {
+
+public:
+
+/*
+ * Constructor: SymbolTable
+ * Usage: SymbolTable symbols;
+ * ---------------------------
+ * Initializes a new empty symbol table.
+ */
+
+   SymbolTable();
+
+/*
+ * Destructor: ~SymbolTable
+ * Usage: (usually implicit)
+ * -------------------------
+ * Frees any heap storage associated with this symbol table.
+ */
+
+   ~SymbolTable();
+
+/*
+ * Method: size
+ * Usage: int nSymbols = symbols.size();
+ * -------------------------------------
+ * Returns the number of strings in the table, which is one more than
+ * the largest id.
+ */
+
+   int size() const;
+
+/*
+ * Method: isEmpty
+ * Usage: if (symbols.isEmpty()) . . .
+ * -----------------------------------
+ * Returns <code>true</code> if the table contains no strings.
+ */
+
+   bool isEmpty() const;
+
+/*
+ * Method: clear
+ * Usage: symbols.clear();
+ * -----------------------
+ * Removes all strings from the table, so that the next string to be
+ * interned receives id 0.
+ */
+
+   void clear();
+
+/*
+ * Method: intern
+ * Usage: int id = symbols.intern(name);
+ *        int id = symbols.intern(chars, length);
+ * ----------------------------------------------
+ * Returns the id of the specified string, adding the string to the
+ * table if it is not already there.  The second form takes the string
+ * as an array of characters and a length, which lets clients that
+ * parse large amounts of text look up each word without first copying
+ * it into a <code>string</code>.
+ */
+
+   int intern(const std::string & name);
+   int intern(const char *chars, int length);
+
+/*
+ * Method: find
+ * Usage: int id = symbols.find(name);
+ *        int id = symbols.find(chars, length);
+ * --------------------------------------------
+ * Returns the id of the specified string, or -1 if the string is not
+ * in the table.  Unlike <code>intern</code>, this method never changes
+ * the table.
+ */
+
+   int find(const std::string & name) const;
+   int find(const char *chars, int length) const;
+
+/*
+ * Method: contains
+ * Usage: if (symbols.contains(name)) . . .
+ * ----------------------------------------
+ * Returns <code>true</code> if the string is in the table.
+ */
+
+   bool contains(const std::string & name) const;
+
+/*
+ * Method: getName
+ * Usage: string name = symbols.getName(id);
+ * -----------------------------------------
+ * Returns the string with the specified id.  The reference remains
+ * valid until the next call to <code>intern</code> or
+ * <code>clear</code>.
+ */
+
+   const std::string & getName(int id) const;
+
+#include "private/symboltablepriv.h"
+
+};
+
+#include "private/symboltableimpl.cpp"
+
+#endif
@@ -0,0 +1,176 @@
+/*
+ * File: graphsearchbenchmark.cpp
+ * ------------------------------
+ * This program times Dijkstra's algorithm on a large random graph in
+ * two ways: by the textbook method, which keeps the distances in a
+ * Map, the finished nodes in a Set, and the frontier in a
+ * PriorityQueue that may hold several entries for the same node, and
+ * by using a GraphSearch object.  It checks that both find the same
+ * distances.  The size of the graph and the number of searches are set
+ * by the constants below.
+ */
+
+#include <iostream>
+#include <string>
+#include <sys/time.h>
+#include "graph.h"
+#include "graphsearch.h"
+#include "map.h"
+#include "pqueue.h"
+#include "random.h"
+#include "set.h"
+#include "strlib.h"
+#include "vector.h"
+using namespace std;
+
+/* Constants */
+
+const int N_NODES = 100000;
+const int ARCS_PER_NODE = 5;
+const int N_SEARCHES = 10;
+const int MAX_COST = 100;
+
+/* Types */
+
+struct Arc;
+
+struct Node {
+   string name;
+   Set<Arc *> arcs;
+};
+
+struct Arc {
+   Node *start;
+   Node *finish;
+   double cost;
+};
+
+/* Function prototypes */
+
+void buildGraph(Graph<Node,Arc> & g, Vector<Node *> & nodes);
+void naiveDijkstra(Graph<Node,Arc> & g, Node *start,
+                   Map<Node *,double> & dist);
+double getCost(Arc *arc);
+double getTime();
+
+/* Main program */
+
+int main() {
+   Graph<Node,Arc> g;
+   Vector<Node *> nodes;
+   buildGraph(g, nodes);
+   Vector<Node *> starts;
+   for (int i = 0; i < N_SEARCHES; i++) {
+      starts.add(nodes[randomInteger(0, N_NODES - 1)]);
+   }
+   cout << N_NODES << " nodes, " << N_NODES * ARCS_PER_NODE << " arcs, "
+        << N_SEARCHES << " searches" << endl;
+   Vector< Map<Node *,double> > expected(N_SEARCHES);
+   double t0 = getTime();
+   for (int i = 0; i < N_SEARCHES; i++) {
+      naiveDijkstra(g, starts[i], expected[i]);
+   }
+   double t1 = getTime();
+   cout << "Map + Set + PriorityQueue:  " << (t1 - t0) << " sec" << endl;
+   GraphSearch<Node,Arc> search(g, getCost);
+   double t2 = getTime();
+   cout << "GraphSearch snapshot:       " << (t2 - t1) << " sec" << endl;
+   bool ok = true;
+   for (int i = 0; i < N_SEARCHES; i++) {
+      search.dijkstra(starts[i]);
+      for (int j = 0; j < N_NODES; j++) {
+         double d = expected[i].containsKey(nodes[j])
+                  ? expected[i].get(nodes[j]) : -1;
+         if (search.getDistance(nodes[j]) != d) ok = false;
+      }
+   }
+   double t3 = getTime();
+   for (int i = 0; i < N_SEARCHES; i++) {
+      search.dijkstra(starts[i]);
+   }
+   double t4 = getTime();
+   cout << "GraphSearch::dijkstra:      " << (t4 - t3) << " sec" << endl;
+   if (!ok) {
+      cout << "Error: the distances differ" << endl;
+      return 1;
+   }
+   return 0;
+}
+
+/*
+ * Function: buildGraph
+ * Usage: buildGraph(g, nodes);
+ * ----------------------------
+ * Fills g with N_NODES nodes, each with ARCS_PER_NODE arcs to random
+ * nodes, and stores the nodes in the vector in order of creation.
+ */
+
+void buildGraph(Graph<Node,Arc> & g, Vector<Node *> & nodes) {
+   for (int i = 0; i < N_NODES; i++) {
+      nodes.add(g.addNode("n" + integerToString(i)));
+   }
+   for (int i = 0; i < N_NODES; i++) {
+      for (int j = 0; j < ARCS_PER_NODE; j++) {
+         Arc *arc = g.addArc(nodes[i], nodes[randomInteger(0, N_NODES - 1)]);
+         arc->cost = randomInteger(1, MAX_COST);
+      }
+   }
+}
+
+/*
+ * Function: naiveDijkstra
+ * Usage: naiveDijkstra(g, start, dist);
+ * -------------------------------------
+ * Runs Dijkstra's algorithm the way it is usually written with the
+ * collection classes.  A node may be in the queue several times; the
+ * entries after the first one to be dequeued are skipped because the
+ * node is already in the finished set.  On return, dist maps every
+ * reachable node to its distance from start.
+ */
+
+void naiveDijkstra(Graph<Node,Arc> & g, Node *start,
+                   Map<Node *,double> & dist) {
+   Set<Node *> finished;
+   PriorityQueue<Node *> queue;
+   dist.put(start, 0);
+   queue.enqueue(start, 0);
+   while (!queue.isEmpty()) {
+      Node *node = queue.dequeue();
+      if (finished.contains(node)) continue;
+      finished.add(node);
+      double d = dist.get(node);
+      foreach (Arc *arc in g.getArcSet(node)) {
+         double nd = d + arc->cost;
+         if (!dist.containsKey(arc->finish) || nd < dist.get(arc->finish)) {
+            dist.put(arc->finish, nd);
+            queue.enqueue(arc->finish, nd);
+         }
+      }
+   }
+}
+
+/*
+ * Function: getCost
+ * Usage: double cost = getCost(arc);
+ * ----------------------------------
+ * Returns the cost of the arc, for use as the weight function of the
+ * GraphSearch object.
+ */
+
+double getCost(Arc *arc) {
+   return arc->cost;
+}
+
+/*
+ * Function: getTime
+ * Usage: double t = getTime();
+ * ----------------------------
+ * Returns the elapsed wall-clock time in seconds since some fixed
+ * point in the past.
+ */
+
+double getTime() {
+   struct timeval tv;
+   gettimeofday(&tv, NULL);
+   return tv.tv_sec + tv.tv_usec / 1e6;
+}
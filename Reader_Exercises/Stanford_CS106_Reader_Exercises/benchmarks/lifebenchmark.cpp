@@ -0,0 +1,152 @@
+/*
+ * File: lifebenchmark.cpp
+ * -----------------------
+ * This program times the Game of Life on a large toroidal board in
+ * three ways: by copying the Grid each generation and reading the
+ * neighbors through grid[row][col], and by using a GridStencil with
+ * one thread and with several threads.  It checks that all three
+ * produce the same final board.  The board size, number of
+ * generations, and number of threads are set by the constants below.
+ */
+
+#include <iostream>
+#include <sys/time.h>
+#include "grid.h"
+#include "gridstencil.h"
+#include "random.h"
+using namespace std;
+
+/* Constants */
+
+const int BOARD_SIZE = 2048;
+const int GENERATIONS = 50;
+const int N_THREADS = 4;
+
+/*
+ * Class: LifeRule
+ * ---------------
+ * The kernel for the stencil versions.  A cell is alive in the next
+ * generation if it has three live neighbors, or if it is alive and has
+ * two live neighbors.
+ */
+
+struct LifeRule {
+   char operator()(const GridStencil<char>::Neighborhood & nb) const {
+      int n = nb(-1, -1) + nb(-1, 0) + nb(-1, 1) + nb(0, -1)
+            + nb(0, 1) + nb(1, -1) + nb(1, 0) + nb(1, 1);
+      return (n == 3 || (n == 2 && nb.center())) ? 1 : 0;
+   }
+};
+
+/* Function prototypes */
+
+void runCopying(Grid<char> & board, int generations);
+void runStencil(Grid<char> & board, int generations, int nThreads);
+bool sameBoard(Grid<char> & g1, Grid<char> & g2);
+double getTime();
+
+/* Main program */
+
+int main() {
+   int size = BOARD_SIZE;
+   int generations = GENERATIONS;
+   int nThreads = N_THREADS;
+   Grid<char> start(size, size);
+   for (int r = 0; r < size; r++) {
+      for (int c = 0; c < size; c++) {
+         start[r][c] = randomChance(0.25) ? 1 : 0;
+      }
+   }
+   cout << size << "x" << size << " board, " << generations
+        << " generations" << endl;
+   Grid<char> b1 = start;
+   double t0 = getTime();
+   runCopying(b1, generations);
+   double t1 = getTime();
+   cout << "Grid copy + grid[r][c]:  " << (t1 - t0) << " sec" << endl;
+   Grid<char> b2 = start;
+   runStencil(b2, generations, 1);
+   double t2 = getTime();
+   cout << "GridStencil, 1 thread:   " << (t2 - t1) << " sec" << endl;
+   Grid<char> b3 = start;
+   runStencil(b3, generations, nThreads);
+   double t3 = getTime();
+   cout << "GridStencil, " << nThreads << " threads:  " << (t3 - t2)
+        << " sec" << endl;
+   if (!sameBoard(b1, b2) || !sameBoard(b1, b3)) {
+      cout << "Error: the final boards differ" << endl;
+      return 1;
+   }
+   return 0;
+}
+
+/*
+ * Function: runCopying
+ * Usage: runCopying(board, generations);
+ * --------------------------------------
+ * Runs the simulation the straightforward way: each generation is
+ * computed into a fresh copy of the board, and every neighbor is read
+ * through the checked subscript operator with wrapped coordinates.
+ */
+
+void runCopying(Grid<char> & board, int generations) {
+   int nRows = board.numRows();
+   int nCols = board.numCols();
+   for (int g = 0; g < generations; g++) {
+      Grid<char> next = board;
+      for (int r = 0; r < nRows; r++) {
+         for (int c = 0; c < nCols; c++) {
+            int n = 0;
+            for (int dr = -1; dr <= 1; dr++) {
+               for (int dc = -1; dc <= 1; dc++) {
+                  if (dr == 0 && dc == 0) continue;
+                  int nr = (r + dr + nRows) % nRows;
+                  int nc = (c + dc + nCols) % nCols;
+                  n += board[nr][nc];
+               }
+            }
+            next[r][c] = (n == 3 || (n == 2 && board[r][c])) ? 1 : 0;
+         }
+      }
+      board = next;
+   }
+}
+
+/*
+ * Function: runStencil
+ * Usage: runStencil(board, generations, nThreads);
+ * ------------------------------------------------
+ * Runs the simulation with a GridStencil and copies the final
+ * generation back into board.
+ */
+
+void runStencil(Grid<char> & board, int generations, int nThreads) {
+   GridStencil<char> life(board);
+   life.setEdgePolicy(EDGE_WRAP);
+   life.setThreadCount(nThreads);
+   life.step(LifeRule(), generations);
+   board = life.getGrid();
+}
+
+bool sameBoard(Grid<char> & g1, Grid<char> & g2) {
+   for (int r = 0; r < g1.numRows(); r++) {
+      for (int c = 0; c < g1.numCols(); c++) {
+         if (g1[r][c] != g2[r][c]) return false;
+      }
+   }
+   return true;
+}
+
+/*
+ * Function: getTime
+ * Usage: double t = getTime();
+ * ----------------------------
+ * Returns the elapsed wall-clock time in seconds since some fixed
+ * point in the past.
+ */
+
+double getTime() {
+   struct timeval tv;
+   gettimeofday(&tv, NULL);
+   return tv.tv_sec + tv.tv_usec / 1e6;
+}